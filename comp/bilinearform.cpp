@@ -341,12 +341,72 @@ namespace ngcomp
   }
 
 
+  /*
+    Element-dof table, calling getdofs once per element.
+    Dofs are buffered chunk-wise while counting, and copied
+    into the table by the same chunks (first touch).
+   */
+  template <typename TFUNC>
+  static Table<int> ElementDofTable (size_t nel, const TFUNC & getdofs)
+  {
+    size_t nchunks = min (nel, size_t(20*TaskManager::GetNumThreads()));
+    Array<Array<int>> chunkdofs(nchunks);
+    Array<int> cnt(nel);
+
+    ParallelFor (nchunks, [&] (size_t c)
+      {
+        Array<DofId> dnums;
+        auto & buffer = chunkdofs[c];
+        for (auto i : Range(nel).Split(c, nchunks))
+          {
+            getdofs (i, dnums);
+            int n = 0;
+            for (DofId d : dnums)
+              if (IsRegularDof(d))
+                {
+                  buffer.Append (d);
+                  n++;
+                }
+            cnt[i] = n;
+          }
+      });
+
+    Table<int> table(cnt);
+    ParallelFor (nchunks, [&] (size_t c)
+      {
+        size_t pos = 0;
+        for (auto i : Range(nel).Split(c, nchunks))
+          for (auto & d : table[i])
+            d = chunkdofs[c][pos++];
+        chunkdofs[c] = Array<int>();
+      });
+    return table;
+  }
+
+
+  int BilinearForm :: SharedGraphKey (bool symmetric) const
+  {
+    // the graph depends only on the spaces and on condensation
+    if (fespace2 || specialelements.Size()) return -1;
+    return int(symmetric) + 2*int(eliminate_internal) + 4*int(eliminate_hidden);
+  }
+
+  
   MatrixGraph * BilinearForm :: GetGraph (int level, bool symmetric)
   {
     static Timer timer ("BilinearForm::GetGraph");
+    static Timer timer_eldofs ("BilinearForm::GetGraph - element dofs");
     RegionTimer reg (timer);
 
-    size_t ndof = fespace->GetNDof();
+    int graphkey = SharedGraphKey (symmetric);
+    if (graphkey >= 0)
+      if (auto shared = fespace->GetSharedGraph (graphkey))
+        {
+          auto graph = new MatrixGraph (*shared, false);
+          graph -> FindSameNZE();
+          return graph;
+        }
+
     size_t nf = ma->GetNFacets();
     size_t neV = ma->GetNE(VOL);
     size_t neB = ma->GetNE(BND);
@@ -354,208 +414,82 @@ namespace ngcomp
     // const Array<SpecialElement*> & specialelements = fespace->GetSpecialElements();
     size_t nspe = specialelements.Size();
 
-    Array<DofId> dnums;
-    Array<int> fnums; //facets of one element
-    Array<int> elnums; //elements neighbouring one facet
-    Array<int> nbelems; //neighbour elements
-
-
-    int maxind = neV + neB + neBB + specialelements.Size();
+    size_t maxind = neV + neB + neBB + nspe;
     if (fespace->UsesDGCoupling()) maxind += nf;
 
-    TableCreator<int> creator(maxind);
-    for ( ; !creator.Done(); creator++)
+    // rows: elements VOL, BND, BBND, special elements, facet patches (DG)
+    auto ElementDofs = [&] (const FESpace & fes, bool trialspace)
       {
-
-        /*
-        task_manager->CreateJob
-          ([&] (const TaskInfo & ti)
-
+        return ElementDofTable
+          (maxind, [&] (size_t nr, Array<DofId> & dnums)
            {
-             Array<int> dnums;
-
-             auto myr = Range(ne).Split(ti.task_nr, ti.ntasks);
-             for (auto i : myr)
+             dnums.SetSize0();
+             if (nr < neV+neB+neBB)
                {
-                 if (!fespace->DefinedOn (ma->GetElIndex(i))) continue;
+                 VorB vb = (nr < neV) ? VOL : ((nr < neV+neB) ? BND : BBND);
+                 size_t shift = (vb==VOL) ? 0 : ((vb==BND) ? neV : neV+neB);
+                 bool condensation_allowed = (vb == VOL) || (trialspace && (neV==0) && (vb == BND));
+                 auto eid = ElementId(vb, nr-shift);
+                 if (!fes.DefinedOn (vb, ma->GetElIndex(eid))) return;
                  
-                 if (eliminate_internal)
-                   fespace->GetDofNrs (i, dnums, EXTERNAL_DOF);
+                 if (condensation_allowed && eliminate_internal)
+                   fes.GetDofNrs (eid, dnums, EXTERNAL_DOF);
+                 else if (condensation_allowed && eliminate_hidden)
+                   fes.GetDofNrs (eid, dnums, VISIBLE_DOF);
+                 else if (fes.HasElementDofTable(vb))
+                   dnums = fes.GetElementDofs (eid, dnums);
                  else
-                   fespace->GetDofNrs (i, dnums);
-                 
-                 for (int d : dnums)
-                   if (d != -1) creator.Add (i, d);
+                   fes.GetDofNrs (eid, dnums);
                }
-
-             
-             auto mysr = Range(nse).Split(ti.task_nr, ti.ntasks);
-             for (auto i : mysr)
-               {
-                 if (!fespace->DefinedOnBoundary (ma->GetSElIndex(i))) continue;
-                 
-                 fespace->GetSDofNrs (i, dnums);
-                 for (int d : dnums)
-                   if (d != -1) creator.Add (ne+i, d);
-               }
-           });
-        */
-	for(VorB vb : {VOL, BND, BBND})
-	  {
-            size_t shift = (vb==VOL) ? 0 : ((vb==BND) ? neV : neV+neB);
-            bool condensation_allowed = (vb == VOL) || ((neV==0) && (vb == BND));
-	    ParallelForRange
-              (ma->GetNE(vb), [&](IntRange r)
+             else if (nr < neV+neB+neBB+nspe)
+               specialelements[nr-neV-neB-neBB]->GetDofNrs (dnums);
+             else if (fes.UsesDGCoupling())
                {
-                 Array<DofId> dnums;
-                 for (auto i : r)
+                 // add dofs of neighbour elements as well
+                 size_t i = nr-neV-neB-neBB-nspe;
+                 Array<int> elnums, elnums_per;
+                 Array<DofId> eldnums;
+                 ma->GetFacetElements(i,elnums);
+                 if (trialspace && elnums.Size() < 2)
                    {
-                     auto eid = ElementId(vb,i);
-                     if (!fespace->DefinedOn (vb, ma->GetElIndex(eid))) continue;
-                     
-                     if (condensation_allowed && eliminate_internal)
-                       fespace->GetDofNrs (eid, dnums, EXTERNAL_DOF);
-                     else if (condensation_allowed && eliminate_hidden)
-                       fespace->GetDofNrs (eid, dnums, VISIBLE_DOF);
-                     else
-                       fespace->GetDofNrs (eid, dnums);
-                         
-                     
-                     for (DofId d : dnums)
-                       if (IsRegularDof(d)) creator.Add (shift+i, d);
+                     size_t facet2 = ma->GetPeriodicFacet(i);
+                     if (facet2 > i)
+                       {
+                         ma->GetFacetElements (facet2, elnums_per);
+                         // if the facet is identified across subdomain
+                         // boundary, we only have the surface element
+                         // and not the other volume element!
+                         if (elnums_per.Size())
+                           elnums.Append(elnums_per[0]);
+                       }
                    }
-               });
-	  }
-
-        
-        for (int i = 0; i < specialelements.Size(); i++)
-          {
-            specialelements[i]->GetDofNrs (dnums);
-            for (int d : dnums)
-              if (IsRegularDof(d)) creator.Add (neV+neB+neBB+i, d);
-          }
-
-        if (fespace->UsesDGCoupling())
-        {
-          //add dofs of neighbour elements as well
-          Array<DofId> dnums_dg;
-          Array<int> elnums_per;
-
-          for (int i = 0; i < nf; i++)
-            {
-              nbelems.SetSize(0);
-              ma->GetFacetElements(i,elnums);
-
-              // timerDG1.Stop();
-              if(elnums.Size() < 2)
-              {
-                int facet2 = ma->GetPeriodicFacet(i);
-                if(facet2 > i)
-                {
-                  ma->GetFacetElements (facet2, elnums_per);
-		  // if the facet is identified across subdomain
-		  // boundary, we only have the surface element
-		  // and not the other volume element!
-		  if (elnums_per.Size())
-		    elnums.Append(elnums_per[0]);
-                }
-              }
-              
-              for (int k=0; k<elnums.Size(); k++)
-                nbelems.Append(elnums[k]);
-
-              dnums_dg.SetSize(0);
-              for (int k=0;k<nbelems.Size();k++){
-                int elnr=nbelems[k];
-                if (!fespace->DefinedOn (VOL,ma->GetElIndex(ElementId(VOL,elnr)))) continue;
-                fespace->GetDofNrs (ElementId(VOL,elnr), dnums);
-                dnums_dg.Append(dnums);
-              }
-              QuickSort (dnums_dg);
-              for (int j = 0; j < dnums_dg.Size(); j++)
-                if (IsRegularDof(dnums_dg[j]) && (j==0 || (dnums_dg[j] != dnums_dg[j-1]) ))
-                  creator.Add (neV+neB+neBB+nspe+i, dnums_dg[j]);
-            }
-        }
+                 for (int elnr : elnums)
+                   {
+                     if (!fes.DefinedOn (VOL,ma->GetElIndex(ElementId(VOL,elnr)))) continue;
+                     fes.GetDofNrs (ElementId(VOL,elnr), eldnums);
+                     dnums.Append (eldnums);
+                   }
+                 QuickSort (dnums);
+                 size_t k = 0;
+                 for (size_t j = 0; j < dnums.Size(); j++)
+                   if (j == 0 || dnums[j] != dnums[j-1])
+                     dnums[k++] = dnums[j];
+                 dnums.SetSize(k);
+               }
+           });
+      };
 
-      }
+    timer_eldofs.Start();
+    Table<int> table = ElementDofs (*fespace, true);
+    timer_eldofs.Stop();
     
     MatrixGraph * graph;
 
     if (!fespace2)
-      {
-        /*
-        graph = new MatrixGraph (ndof, *creator.GetTable(), *creator.GetTable(), symmetric);
-        delete creator.GetTable();
-        */
-        auto table = creator.MoveTable();
-        graph = new MatrixGraph (ndof, ndof, table, table, symmetric);        
-      }
+      graph = new MatrixGraph (fespace->GetNDof(), fespace->GetNDof(), table, table, symmetric);
     else
       {
-        TableCreator<int> creator2(maxind);
-        for ( ; !creator2.Done(); creator2++)
-          {
-            int offset=0;
-	    for(VorB vb  : {VOL, BND, BBND})
-	      {
-		int nre = ma->GetNE(vb);
-                offset += nre;
-		for (int i = 0; i < nre; i++)
-		  {
-		    auto eid = ElementId(vb,i);
-		    if (!fespace2->DefinedOn (vb,ma->GetElIndex(eid))) continue;
-		    
-		    if (vb == VOL && eliminate_internal)
-		      fespace2->GetDofNrs (eid, dnums, EXTERNAL_DOF);
-		    else if (vb == VOL && eliminate_hidden)
-		      fespace2->GetDofNrs (eid, dnums, VISIBLE_DOF);
-		    else
-		      fespace2->GetDofNrs (eid, dnums);
-		    
-		    int shift = (vb==VOL) ? 0 : ((vb==BND) ? neV : neV + neB);
-		    for (int d : dnums)
-		      if (IsRegularDof(d)) creator2.Add (shift+i, d);
-		  }
-              }
-		
-            // just not tested ...
-            for (int i = 0; i < specialelements.Size(); i++)
-            {
-              specialelements[i]->GetDofNrs (dnums);
-		
-              for (int j = 0; j < dnums.Size(); j++)
-                if (dnums[j] != -1)
-                  creator2.Add (offset+i, dnums[j]);
-            }
-            offset += specialelements.Size();	
-            if (fespace2->UsesDGCoupling())
-              //add dofs of neighbour elements as well
-              for (int i = 0; i < nf; i++)
-              {
-                nbelems.SetSize(0);
-                ma->GetFacetElements(i,elnums);
-                for (int k=0; k<elnums.Size(); k++)
-                  nbelems.Append(elnums[k]);
-		
-                for (int k=0;k<nbelems.Size();k++){
-                  int elnr=nbelems[k];
-                  if (!fespace2->DefinedOn (ElementId(VOL,elnr))) continue;
-                  fespace2->GetDofNrs (ElementId(VOL,elnr), dnums);
-                  for (int j = 0; j < dnums.Size(); j++)
-                    if (dnums[j] != -1)
-                      creator2.Add (offset+i, dnums[j]);
-                }
-              }
-	  }
-
-        /*
-        graph = new MatrixGraph (fespace2->GetNDof(), *creator2.GetTable(), *creator.GetTable(), symmetric);        
-        delete creator.GetTable();
-        delete creator2.GetTable();
-        */
-        auto table = creator.MoveTable();
-        auto table2 = creator2.MoveTable();
+        auto table2 = ElementDofs (*fespace2, false);
         graph = new MatrixGraph (fespace2->GetNDof(), fespace->GetNDof(),
                                  table2, table, symmetric);
       }
@@ -569,6 +503,32 @@ namespace ngcomp
 
 
 
+  std::list<std::tuple<std::string,double>> BilinearForm :: Timing ()
+  {
+    std::list<std::tuple<std::string,double>> results;
+    LocalHeap lh (10000000, "BilinearForm - Timing");
+    Assemble (lh);
+    if (nonassemble) return results;
+
+    // matrix and graph are kept, element matrices are computed and added
+    double time = RunTiming([&]() {
+        DoAssemble (lh);
+        lh.CleanUp();
+      });
+    results.push_back(std::make_tuple<std::string,double>("Assemble", 1e9*time / max2(ma->GetNE(VOL), size_t(1))));
+
+    auto & mat = GetMatrix();
+    auto vecf = mat.CreateColVector();
+    auto vecu = mat.CreateRowVector();
+    vecu = 1;
+    time = RunTiming([&]() {
+        mat.Mult (vecu, vecf);
+      });
+    results.push_back(std::make_tuple<std::string,double>("MultAdd", 1e9*time / max2(mat.NZE(), size_t(1))));
+    return results;
+  }
+
+
   void BilinearForm :: Assemble (LocalHeap & lh)
   {
     if (mats.Size() == ma->GetNLevels())
@@ -916,9 +876,10 @@ namespace ngcomp
         // ndof *= dim;
 
         
-        Array<int> nidofs(ne), nodofs(ne);
+        Array<int> nidofs(ne), nodofs(ne), ncdofs(ne);
         nidofs = 0;
         nodofs = 0;
+        ncdofs = 0;
         
         ParallelForRange
           (ne, [&] (IntRange r)
@@ -926,7 +887,7 @@ namespace ngcomp
              Array<DofId> dnums;
              for (size_t i : r)
                {
-                 int ni = 0, no = 0;
+                 int ni = 0, no = 0, nc = 0;
                  ElementId ei(vb,i);
                  
                  if (fespace->DefinedOn(ei))
@@ -939,29 +900,22 @@ namespace ngcomp
                            no++;
                          if (ct & LOCAL_DOF)
                            ni++;
+                         // the factors include the hidden dofs
+                         if (ct & CONDENSABLE_DOF)
+                           nc++;
                        }
                    }
                  nidofs[i] = dim*ni;
                  nodofs[i] = dim*no;
+                 ncdofs[i] = dim*nc;
                }
            });
 
-        /*
-        harmonicext = make_shared<ElementByElementMatrix<SCAL>>(ndof, ne);
-        if (!symmetric)
-          harmonicexttrans = make_shared<ElementByElementMatrix<SCAL>>(ndof, ne);
-        else
-          harmonicexttrans = make_shared<Transpose>(*harmonicext);
-        innersolve = make_shared<ElementByElementMatrix<SCAL>>(ndof, ne);
-        if (store_inner)
-          innermatrix = make_shared<ElementByElementMatrix<SCAL>>(ndof, ne);
-        */
-        harmonicext = make_shared<ElementByElementMatrix<SCAL>>(ndof, ndof, nidofs, nodofs, false, false, false);
-        if (!symmetric)
-          harmonicexttrans = make_shared<ElementByElementMatrix<SCAL>>(ndof, ndof, nodofs, nidofs, false, false, false);
-        else
-          harmonicexttrans = make_shared<Transpose>(*harmonicext);
-        innersolve = make_shared<ElementByElementMatrix<SCAL>>(ndof, ndof, nidofs, nidofs, false, true, true);
+        typedef StaticCondensation<SCAL> SC;
+        statcond = make_shared<SC> (ndof, ncdofs, nodofs, symmetric);
+        harmonicext = make_shared<StaticCondensationMatrix<SCAL>> (statcond, SC::HARMONIC_EXTENSION);
+        harmonicexttrans = make_shared<StaticCondensationMatrix<SCAL>> (statcond, SC::HARMONIC_EXTENSION_TRANS);
+        innersolve = make_shared<StaticCondensationMatrix<SCAL>> (statcond, SC::INNER_SOLVE);
         if (store_inner)
           innermatrix = make_shared<ElementByElementMatrix<SCAL>>(ndof, ndof, nidofs, nidofs, false, true, true);
       }
@@ -988,7 +942,7 @@ namespace ngcomp
     static mutex printmatspecel_mutex;
     static mutex printmatspecel2_mutex;
 
-    RegionTimer reg (mattimer);
+    TraceRegion reg (mattimer);
 
     timestamp = ++global_timestamp;
     
@@ -1064,7 +1018,7 @@ namespace ngcomp
 	      {
 		if (!VB_parts[vb].Size()) continue;
                 
-                RegionTimer reg(mattimer_VB[vb]);
+                TraceRegion reg(mattimer_VB[vb]);
 		size_t ne = ma->GetNE(vb);
                 
                 if (vb==VOL && diagonal)
@@ -1186,7 +1140,7 @@ namespace ngcomp
 
                          {
                          static Timer elmattimer("calc elmats", 2);
-                         ThreadRegionTimer reg (elmattimer, TaskManager::GetThreadId());
+                         TraceRegion reg (elmattimer, TaskManager::GetThreadId());
                          
                          if (printelmat || elmat_ev)
                            {
@@ -1325,9 +1279,6 @@ namespace ngcomp
                              static Timer statcondtimer("static condensation", 2);
                              ThreadRegionTimer regstat (statcondtimer, TaskManager::GetThreadId());
                              static Timer statcondtimer2("static condensation 2", 2);
-
-                             static Timer statcondtimer_mult("static condensation mult", 2);
-                             static Timer statcondtimer_inv("static condensation inv", 2);
                              
                              // Array<int> idofs1(dnums.Size(), lh);
                              // fespace->GetElementDofsOfType (el, idofs1, elim_only_hidden ? HIDDEN_DOF : CONDENSABLE_DOF);
@@ -1357,6 +1308,12 @@ namespace ngcomp
                              
                              if (idofs1.Size())
                                {
+                                 // dnums may be a row of the cached element-dof table of the space,
+                                 // condensed dofs are masked in a copy
+                                 FlatArray<int> hdnums(dnums.Size(), lh);
+                                 hdnums = dnums;
+                                 dnums.Assign (hdnums);
+
                                  HeapReset hr (lh);
 				 
                                  int size = sum_elmat.Height();
@@ -1513,50 +1470,8 @@ namespace ngcomp
                                        cout << "lam = " << lam << endl;
                                      */
 
-                                     {
-                                       // ThreadRegionTimer reg (statcondtimer_inv, TaskManager::GetThreadId());
-                                       // RegionTracer rtr(TaskManager::GetThreadId(), statcondtimer_inv);    
-                              
-                                       // LapackInverse (d);
-                                       CalcInverse (d);
-                                     }
-                                     FlatMatrix<SCAL> he (sizei, sizeo, lh);
-
-                                     {
-                                       ThreadRegionTimer reg (statcondtimer_mult, TaskManager::GetThreadId());
-                                       NgProfiler::AddThreadFlops (statcondtimer_mult, TaskManager::GetThreadId(),
-                                                                   d.Height()*d.Width()*c.Width());
-                                       
-                                       // V1:
-                                       // he = 0.0;
-                                       // he -= d * Trans(c) | Lapack;
-                                       // V2:
-                                       // he = -d * Trans(c) | Lapack;
-                                       // V3:
-                                       // MinusMultABt (d, c, he);
-                                       he = -d * Trans(c);
-                                     }
-                                     
-                                     harmonicext ->AddElementMatrix(el.Nr(),idnums,ednums,he);
-                                     if (!symmetric)
-                                       {
-                                         FlatMatrix<SCAL> het (sizeo, sizei, lh);
-                                         // het = -b*d | Lapack;
-                                         // MinusMultAB (b, d, het);
-                                         het = -b * d;
-                                         static_cast<ElementByElementMatrix<SCAL>*>(harmonicexttrans.get())
-                                           ->AddElementMatrix(el.Nr(),ednums,idnums,het);
-                                       }
-                                     
-                                     innersolve ->AddElementMatrix(el.Nr(),idnums,idnums,d);
-                                     {
-                                       ThreadRegionTimer reg (statcondtimer_mult, TaskManager::GetThreadId());
-                                       NgProfiler::AddThreadFlops (statcondtimer_mult, TaskManager::GetThreadId(),
-                                                                   b.Height()*b.Width()*he.Width());
-                                       // a += b * he | Lapack;
-                                       // AddAB (b, he, a);
-                                       a += b * he;
-                                     }
+                                     // a -= b d^{-1} c^T, keeps the factors of d
+                                     statcond->Condense (el.Nr(), idnums, ednums, a, b, c, d, lh);
                                      
                                      if (spd)
                                        { // more stable ? 
@@ -2302,7 +2217,7 @@ namespace ngcomp
             
             ma->SetThreadPercentage ( 100.0 );
             
-	    RegionTimer reg(mattimer_finalize);
+	    TraceRegion reg(mattimer_finalize);
             
             /*
               if(NumIndependentIntegrators() > 0)
@@ -3346,30 +3261,7 @@ namespace ngcomp
                                static_cast<ElementByElementMatrix<SCAL>*>(innermatrix.get())
                                       ->AddElementMatrix(i,idnums,idnums,d);
                              
-                             // LapackInverse (d);
-                             CalcInverse (d);
-                             FlatMatrix<SCAL> he (sizei, sizeo, lh);
-                             // he=0.0;
-                             // LapackMultAddABt (d, c, -1, he);
-                             he = -d * Trans(c);
-                             
-                             static_cast<ElementByElementMatrix<SCAL>*>(harmonicext.get())
-                               ->AddElementMatrix(i,idnums,ednums,he);
-                                  
-                             if (!symmetric)
-                               {
-                                 FlatMatrix<SCAL> het (sizeo, sizei, lh);
-                                 // het = 0.0;
-                                 // LapackMultAddAB (b, d, -1, het);
-                                 het = -b * d;
-                                 static_cast<ElementByElementMatrix<SCAL>*>(harmonicexttrans.get())
-                                   ->AddElementMatrix(i,ednums,idnums,het);
-                               }
-                             static_cast<ElementByElementMatrix<SCAL>*>(innersolve.get())
-                               ->AddElementMatrix(i,idnums,idnums,d);
-                             
-                             // LapackMultAddAB (b, he, 1.0, a);
-                             a += b*he;
+                             statcond->Condense (i, idnums, ednums, a, b, c, d, lh);
                            }                                 
                          
                          
@@ -5282,6 +5174,9 @@ namespace ngcomp
 
     auto spmat = make_shared<SparseMatrix<TM,TV,TV>> (*graph, 1);
     mymatrix = spmat.get();
+    int graphkey = this->SharedGraphKey (false);
+    if (graphkey >= 0)
+      this->fespace->SetSharedGraph (graphkey, spmat);
     
     if (this->spd) spmat->SetSPD();
     shared_ptr<BaseMatrix> mat = spmat;
@@ -5431,6 +5326,9 @@ namespace ngcomp
 
     auto spmat = make_shared<SparseMatrixSymmetric<TM,TV>> (*graph, 1);
     mymatrix = spmat.get();
+    int graphkey = this->SharedGraphKey (true);
+    if (graphkey >= 0)
+      this->fespace->SetSharedGraph (graphkey, spmat);
     
     if (this->spd) spmat->SetSPD();
     shared_ptr<BaseMatrix> mat = spmat;
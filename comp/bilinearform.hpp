@@ -198,12 +198,17 @@ namespace ngcomp
     /// unregister preconditioner
     void UnsetPreconditioner(Preconditioner* pre);
 
-    /// generates matrix graph
+    /// generates matrix graph, or copies the graph of a matrix on the same space
     virtual MatrixGraph * GetGraph (int level, bool symmetric);
+    /// key for sharing matrix graphs on the fespace, -1 if not shareable
+    int SharedGraphKey (bool symmetric) const;
 
     /// assembles the matrix
     void Assemble (LocalHeap & lh);
 
+    /// times re-assembling (per element) and matrix-vector product (per non-zero), in ns
+    std::list<std::tuple<std::string,double>> Timing ();
+
     /// re-assembles the matrix.
     /// if reallocate is false, the existing matrix is reused
     void ReAssemble (LocalHeap & lh, bool reallocate = 0);
@@ -437,10 +442,12 @@ namespace ngcomp
   {
   protected:
 
-    shared_ptr<ElementByElementMatrix<SCAL>> harmonicext; //  = NULL;
+    shared_ptr<BaseMatrix> harmonicext; //  = NULL;
     shared_ptr<BaseMatrix> harmonicexttrans; //  = NULL;
-    shared_ptr<ElementByElementMatrix<SCAL>> innersolve; //  = NULL;
+    shared_ptr<BaseMatrix> innersolve; //  = NULL;
     shared_ptr<ElementByElementMatrix<SCAL>> innermatrix; //  = NULL;
+    /// factors of A_ii and coupling blocks, applied by the three matrices above
+    shared_ptr<StaticCondensation<SCAL>> statcond;
 
 #ifdef PARALLEL
     //data for mpi-facets; only has data if there are relevant integrators in the BLF!
@@ -50,6 +50,7 @@ namespace ngcomp
 
 #include "pmltrafo.hpp"
 #include "meshaccess.hpp"
+#include "renumbering.hpp"
 #include "ngsobject.hpp"
 #include "fespace.hpp"
 
@@ -57,6 +58,8 @@ namespace ngcomp
 #include "bilinearform.hpp"
 #include "linearform.hpp"
 #include "preconditioner.hpp"
+#include "newton.hpp"
+#include "solveserver.hpp"
 #include "numproc.hpp"
 #include "pde.hpp"
 
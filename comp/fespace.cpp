@@ -77,6 +77,13 @@ namespace ngcomp
     timing = flags.GetDefineFlag("timing");
     print = flags.GetDefineFlag("print");
     dgjumps = flags.GetDefineFlag("dgjumps");
+    if (flags.StringFlagDefined("element_order"))
+      element_order = flags.GetStringFlag("element_order");
+    cache_element_dofs = flags.GetDefineFlag("cache_element_dofs");
+    if (flags.StringFlagDefined("coloring"))
+      coloring_type = flags.GetStringFlag("coloring");
+    if (coloring_type != "greedy" && coloring_type != "blocks")
+      throw Exception ("unknown coloring '" + coloring_type + "', use 'greedy' or 'blocks'");
     no_low_order_space = flags.GetDefineFlagX("low_order_space").IsFalse() ||
       flags.GetDefineFlag("no_low_order_space");
     if (dgjumps) 
@@ -354,6 +361,18 @@ lot of new non-zero entries in the matrix!\n" << endl;
       "  NODAL ..... use the same order for nodes of same shape,\n"
       "  VARIBLE ... use an individual order for each edge, face and cell,\n"
       "  OLDSTYLE .. as it used to be for the last decade";
+    docu.Arg("element_order") = "string = ''\n"
+      "  Order of the elements within a color, used for assembling and IterateElements.\n"
+      "  'rcm' .. reverse Cuthill-McKee of the element graph,\n"
+      "  'hilbert', 'morton' .. space filling curve through the element centroids.\n"
+      "  By default elements are ordered by number.";
+    docu.Arg("coloring") = "string = 'greedy'\n"
+      "  'greedy' .. greedy coloring of elements by number,\n"
+      "  'blocks' .. spatially compact blocks of elements are colored with\n"
+      "  balanced color sizes, IterateElements processes them block-wise.";
+    docu.Arg("cache_element_dofs") = "bool = False\n"
+      "  Store the dofs of all elements in a table, such that assembling and\n"
+      "  evaluation do not recompute them.";
     return docu;
   }
 
@@ -382,6 +401,9 @@ lot of new non-zero entries in the matrix!\n" << endl;
     
     ma->UpdateBuffers();  // is free if netgen-mesh did not change
     int dim = ma->GetDimension();
+
+    for (auto & table : element_dofs)
+      table = Table<DofId>();
     
     dirichlet_vertex.SetSize (ma->GetNV());
     dirichlet_edge.SetSize (ma->GetNEdges());
@@ -446,6 +468,161 @@ lot of new non-zero entries in the matrix!\n" << endl;
   }
 
 
+  /*
+    Coloring of items (elements or facets) coupling via dofs.
+
+    Items, given in a locality preserving order, are cut into blocks of
+    consecutive items. Blocks are colored greedily, choosing the
+    admissible color with the fewest items, so the colors are balanced.
+    Within a block, items are colored locally in the same way.
+    The item colors are the pairs (block color, local color), so they
+    are conflict-free item by item. In addition, all blocks of one
+    block color can be processed in parallel, block by block.
+    
+    Returns false if more than 64 block colors would be needed.
+   */
+  static bool CalcBlockColoring (FlatArray<int> items, size_t ndof,
+                                 const function<void(int,Array<DofId>&)> & getdofs,
+                                 Table<int> & coloring, Table<int> & blocks,
+                                 Table<int> & block_coloring)
+  {
+    static Timer t("FESpace - block coloring");
+    RegionTimer reg(t);
+    constexpr size_t blocksize = 32;
+    size_t n = items.Size();
+    size_t nblocks = (n+blocksize-1) / blocksize;
+    auto blockrange = [&] (size_t b) { return Range(b*blocksize, min(n, (b+1)*blocksize)); };
+
+    // regular dofs of all items
+    Array<int> cnt(n);
+    ParallelForRange (n, [&] (IntRange r)
+      {
+        Array<DofId> dofs;
+        for (auto k : r)
+          {
+            getdofs (items[k], dofs);
+            cnt[k] = dofs.Size();
+          }
+      });
+    Table<DofId> itemdofs(cnt);
+    ParallelForRange (n, [&] (IntRange r)
+      {
+        Array<DofId> dofs;
+        for (auto k : r)
+          {
+            getdofs (items[k], dofs);
+            itemdofs[k] = dofs;
+          }
+      });
+
+    // balanced greedy coloring of blocks
+    Array<uint64_t> mask(ndof);
+    mask = 0;
+    Array<int> blockcol(nblocks);
+    Array<size_t> colsize;
+    for (size_t b = 0; b < nblocks; b++)
+      {
+        uint64_t used = 0;
+        for (auto k : blockrange(b))
+          for (auto d : itemdofs[k])
+            used |= mask[d];
+        
+        int best = -1;
+        for (int c = 0; c < colsize.Size(); c++)
+          if (!(used & (uint64_t(1) << c)) && (best == -1 || colsize[c] < colsize[best]))
+            best = c;
+        if (best == -1)
+          {
+            if (colsize.Size() == 64) return false;
+            best = colsize.Size();
+            colsize.Append (0);
+          }
+        blockcol[b] = best;
+        colsize[best] += blockrange(b).Size();
+        for (auto k : blockrange(b))
+          for (auto d : itemdofs[k])
+            mask[d] |= uint64_t(1) << best;
+      }
+    size_t nbcol = colsize.Size();
+
+    // local colors within every block, at most blocksize
+    Array<int> localcol(n);
+    ParallelFor (nblocks, [&] (size_t b)
+      {
+        ArrayMem<int,1000> bdofs;
+        for (auto k : blockrange(b))
+          bdofs.Append (itemdofs[k]);
+        QuickSort (bdofs);
+        auto pos = [&bdofs] (DofId d)
+          { return std::lower_bound (bdofs.begin(), bdofs.end(), d) - bdofs.begin(); };
+        ArrayMem<uint64_t,1000> lmask(bdofs.Size());
+        lmask = 0;
+        ArrayMem<int,blocksize> lsize;
+        for (auto k : blockrange(b))
+          {
+            uint64_t used = 0;
+            for (auto d : itemdofs[k])
+              used |= lmask[pos(d)];
+            int best = -1;
+            for (int c = 0; c < lsize.Size(); c++)
+              if (!(used & (uint64_t(1) << c)) && (best == -1 || lsize[c] < lsize[best]))
+                best = c;
+            if (best == -1)
+              {
+                best = lsize.Size();
+                lsize.Append (0);
+              }
+            localcol[k] = best;
+            lsize[best]++;
+            for (auto d : itemdofs[k])
+              lmask[pos(d)] |= uint64_t(1) << best;
+          }
+      });
+
+    int nlcol = 0;
+    for (auto c : localcol)
+      nlcol = max2 (nlcol, c+1);
+
+    // item colors, empty ones removed, items in block order
+    Array<int> cntcol(nbcol*nlcol);
+    cntcol = 0;
+    for (size_t k = 0; k < n; k++)
+      cntcol[blockcol[k/blocksize]*nlcol+localcol[k]]++;
+    Array<int> colnr(cntcol.Size());
+    int ncol = 0;
+    for (size_t c = 0; c < cntcol.Size(); c++)
+      colnr[c] = cntcol[c] ? ncol++ : -1;
+    Array<int> cntcol2(ncol);
+    for (size_t c = 0; c < cntcol.Size(); c++)
+      if (cntcol[c]) cntcol2[colnr[c]] = cntcol[c];
+    
+    coloring = Table<int> (cntcol2);
+    cntcol2 = 0;
+    for (size_t k = 0; k < n; k++)
+      {
+        int c = colnr[blockcol[k/blocksize]*nlcol+localcol[k]];
+        coloring[c][cntcol2[c]++] = items[k];
+      }
+
+    Array<int> bsize(nblocks);
+    for (size_t b = 0; b < nblocks; b++)
+      bsize[b] = blockrange(b).Size();
+    blocks = Table<int> (bsize);
+    for (size_t b = 0; b < nblocks; b++)
+      for (auto k : blockrange(b))
+        blocks[b][k-b*blocksize] = items[k];
+
+    Array<int> cntb(nbcol);
+    cntb = 0;
+    for (auto c : blockcol) cntb[c]++;
+    block_coloring = Table<int> (cntb);
+    cntb = 0;
+    for (size_t b = 0; b < nblocks; b++)
+      block_coloring[blockcol[b]][cntb[blockcol[b]]++] = b;
+    return true;
+  }
+
+  
   void FESpace :: FinalizeUpdate()
   {
     static Timer timer ("FESpace::FinalizeUpdate");
@@ -561,9 +738,18 @@ lot of new non-zero entries in the matrix!\n" << endl;
     
     UpdateParallelDofs();
 
+    if (cache_element_dofs)
+      UpdateElementDofTables();
+
     if (print)
       *testout << "coloring ... " << flush;
 
+    for (auto vb : { VOL, BND, BBND, BBBND })
+      {
+        coloring_blocks[vb] = Table<int>();
+        block_coloring[vb] = Table<int>();
+      }
+    
     if (low_order_space)
       {
 	for(auto vb : {VOL, BND, BBND, BBBND})
@@ -577,6 +763,34 @@ lot of new non-zero entries in the matrix!\n" << endl;
       
       for (auto vb : { VOL, BND, BBND, BBBND })
       {
+        if (coloring_type == "blocks" && vb != BBBND)
+          {
+            Array<int> items;
+            for (int nr : ElementLocalityOrder (*ma, vb, element_order != "" ? element_order : "hilbert"))
+              if (DefinedOn (ElementId(vb, nr)))
+                items.Append (nr);
+            
+            auto getdofs = [&] (int nr, Array<DofId> & dofs)
+              {
+                ElementId ei(vb, nr);
+                if (HasElementDofTable(vb))
+                  dofs = element_dofs[vb][nr];
+                else
+                  GetDofNrs (ei, dofs);
+                for (int i = dofs.Size()-1; i >= 0; i--)
+                  if (!IsRegularDof(dofs[i]) || IsAtomicDof(dofs[i])) dofs.DeleteElement(i);
+              };
+            
+            if (CalcBlockColoring (items, GetNDof(), getdofs, element_coloring[vb],
+                                   coloring_blocks[vb], block_coloring[vb]))
+              {
+                if (print)
+                  *testout << "needed " << element_coloring[vb].Size() << " colors, "
+                           << block_coloring[vb].Size() << " block colors for " << vb << endl;
+                continue;
+              }
+          }
+        
         /*
         tcol.Start();
         Array<int> col(ma->GetNE(vb));
@@ -691,7 +905,10 @@ lot of new non-zero entries in the matrix!\n" << endl;
                      if (col[el.Nr()] >= 0) continue;
                      
                      unsigned check = 0;
-                     GetDofNrs(el, dofs);
+                     if (HasElementDofTable(vb))
+                       dofs = element_dofs[vb][nr];
+                     else
+                       GetDofNrs(el, dofs);
                      
                      if (HasAtomicDofs())
                        {
@@ -748,8 +965,16 @@ lot of new non-zero entries in the matrix!\n" << endl;
         coloring = Table<int> (cntcol);
 
 	cntcol = 0;
-        for (ElementId el : Elements(vb))
-          coloring[col[el.Nr()]][cntcol[col[el.Nr()]]++] = el.Nr();
+        if (element_order != "")
+          {
+            // locality preserving traversal within every color
+            for (int nr : ElementLocalityOrder (*ma, vb, element_order))
+              if (col[nr] >= 0)
+                coloring[col[nr]][cntcol[col[nr]]++] = nr;
+          }
+        else
+          for (ElementId el : Elements(vb))
+            coloring[col[el.Nr()]][cntcol[col[el.Nr()]]++] = el.Nr();
         
         if (print)
           *testout << "needed " << maxcolor+1 << " colors" 
@@ -759,6 +984,8 @@ lot of new non-zero entries in the matrix!\n" << endl;
     
     // invalidate facet_coloring
     facet_coloring = Table<int>();
+    for (auto & graph : shared_graphs)
+      graph.reset();
        
     level_updated = ma->GetNLevels();
     if (timing) Timing();
@@ -771,6 +998,58 @@ lot of new non-zero entries in the matrix!\n" << endl;
     if (facet_coloring.Size()) return facet_coloring;
 
     size_t nf = ma->GetNFacets();
+
+    if (coloring_type == "blocks")
+      {
+        // facets in the order of their first element along the curve
+        Array<int> items;
+        items.SetAllocSize (nf);
+        Array<bool> added(nf);
+        added = false;
+        for (int el : ElementLocalityOrder (*ma, VOL, element_order != "" ? element_order : "hilbert"))
+          for (auto f : ma->GetElFacets (ElementId(VOL, el)))
+            if (!added[f])
+              {
+                added[f] = true;
+                items.Append (f);
+              }
+        for (auto f : Range(nf))
+          if (!added[f]) items.Append (f);
+
+        auto getdofs = [&] (int f, Array<DofId> & dofs)
+          {
+            Array<int> elnums, elnums_per;
+            Array<DofId> dofs1;
+            ma->GetFacetElements(f,elnums);
+            if (elnums.Size() == 1)
+              {
+                size_t f2 = ma->GetPeriodicFacet(f);
+                if (f2 != f)
+                  {
+                    ma->GetFacetElements (f2, elnums_per);
+                    if (elnums_per.Size())
+                      elnums.Append(elnums_per[0]);
+                  }
+              }
+            dofs.SetSize0();
+            for (auto el : elnums)
+              {
+                GetDofNrs(ElementId(VOL, el), dofs1);
+                for (auto d : dofs1)
+                  if (IsRegularDof(d)) dofs.Append (d);
+              }
+          };
+        
+        Table<int> blocks, block_col;
+        if (CalcBlockColoring (items, GetNDof(), getdofs,
+                               const_cast<Table<int>&> (facet_coloring), blocks, block_col))
+          {
+            if (print)
+              *testout << "needed " << facet_coloring.Size() << " colors for facet-coloring" << endl;
+            return facet_coloring;
+          }
+      }
+    
     Array<int> col(nf);
     col = -1;
     
@@ -1277,6 +1556,26 @@ lot of new non-zero entries in the matrix!\n" << endl;
     for (int i = 0; i < free_dofs->Size(); i++)
       if ((*free_dofs)[i])
 	nfree++;
+
+    auto report_coloring = [&ost] (string name, const Table<int> & coloring)
+      {
+        if (!coloring.Size()) return;
+        size_t minsize = coloring[0].Size(), maxsize = 0;
+        for (auto col : coloring)
+          {
+            minsize = min2 (minsize, col.Size());
+            maxsize = max2 (maxsize, col.Size());
+          }
+        ost << name << " = " << coloring.Size() << " colors, sizes "
+            << minsize << " - " << maxsize << endl;
+      };
+    ost << "coloring = " << coloring_type << endl;
+    report_coloring ("element coloring", element_coloring[VOL]);
+    report_coloring ("boundary element coloring", element_coloring[BND]);
+    if (block_coloring[VOL].Size())
+      ost << "block coloring = " << coloring_blocks[VOL].Size() << " blocks in "
+          << block_coloring[VOL].Size() << " colors" << endl;
+    report_coloring ("facet coloring", facet_coloring);
   }
   
   void FESpace :: DoArchive (Archive & archive)
@@ -1287,10 +1586,65 @@ lot of new non-zero entries in the matrix!\n" << endl;
     archive & dirichlet_vertex & dirichlet_edge & dirichlet_face;
   }
 
+  void FESpace :: UpdateElementDofTables ()
+  {
+    static Timer t("FESpace::UpdateElementDofTables");
+    RegionTimer reg(t);
+    
+    for (auto vb : { VOL, BND, BBND, BBBND })
+      {
+        element_dofs[vb] = Table<DofId>();
+        size_t ne = ma->GetNE(vb);
+        
+        Array<int> cnt(ne);
+        ParallelForRange
+          (ne, [&] (IntRange r)
+           {
+             Array<DofId> dnums;
+             for (auto i : r)
+               {
+                 ElementId ei(vb, i);
+                 if (DefinedOn(ei))
+                   GetDofNrs (ei, dnums);
+                 else
+                   dnums.SetSize0();
+                 cnt[i] = dnums.Size();
+               }
+           });
+
+        Table<DofId> table(cnt);
+        ParallelForRange
+          (ne, [&] (IntRange r)
+           {
+             Array<DofId> dnums;
+             for (auto i : r)
+               {
+                 ElementId ei(vb, i);
+                 if (DefinedOn(ei))
+                   {
+                     GetDofNrs (ei, dnums);
+                     table[i] = dnums;
+                   }
+               }
+           });
+        element_dofs[vb] = move(table);
+      }
+  }
+
+  
   Array<MemoryUsage> FESpace :: GetMemoryUsage () const
   {
     Array<MemoryUsage> mu;
     mu += { "coupling types", ctofdof.Size()*sizeof(COUPLING_TYPE), 1 };
+    size_t nbytes = 0, nblocks = 0;
+    for (auto & table : element_dofs)
+      if (table.Size())
+        {
+          nbytes += table.AsArray().Size()*sizeof(DofId) + (table.Size()+1)*sizeof(size_t);
+          nblocks += 2;
+        }
+    if (nblocks)
+      mu += { "element-dof tables", nbytes, nblocks };
     return mu;
   }
 
@@ -1312,6 +1666,21 @@ lot of new non-zero entries in the matrix!\n" << endl;
     });
     results.push_back(std::make_tuple<std::string,double>("GetDofNrs",1e9*time / (ma->GetNE())));
 
+    if (HasElementDofTable(VOL))
+      {
+        time = RunTiming([&]() {
+            ParallelForRange( IntRange(ma->GetNE()), [&] ( IntRange r )
+            {
+              Array<int> dnums;
+              size_t sum = 0;
+              for (int i : r)
+                sum += GetElementDofs (ElementId(VOL,i), dnums).Size();
+              (void)sum;
+            });
+        });
+        results.push_back(std::make_tuple<std::string,double>("GetElementDofs",1e9*time / (ma->GetNE())));
+      }
+
     time = RunTiming([&]() {
         ParallelForRange( IntRange(ma->GetNE()), [&] ( IntRange r )
         {
@@ -1597,6 +1966,34 @@ lot of new non-zero entries in the matrix!\n" << endl;
     static mutex copyex_mutex;
     const Table<int> & element_coloring = fes.ElementColoring(vb);
     
+    if (task_manager && fes.BlockColoring(vb).Size())
+      {
+        // whole blocks of neighbouring elements per task
+        const Table<int> & blocks = fes.ColoringBlocks(vb);
+        for (FlatArray<int> blocks_of_col : fes.BlockColoring(vb))
+          {
+            SharedLoop2 sl(blocks_of_col.Range());
+
+            task_manager -> CreateJob
+              ( [&] (const TaskInfo & ti) 
+                {
+                  LocalHeap lh = clh.Split(ti.thread_nr, ti.nthreads);
+                  ArrayMem<int,100> temp_dnums;
+
+                  for (int mynr : sl)
+                    for (int elnr : blocks[blocks_of_col[mynr]])
+                      {
+                        HeapReset hr(lh);
+                        FESpace::Element el(fes, ElementId (vb, elnr), temp_dnums, lh);
+                        func (move(el), lh);
+                      }
+
+                  ProgressOutput::SumUpLocal();
+                } );
+          }
+        return;
+      }
+    
     if (task_manager)
       {
         for (FlatArray<int> els_of_col : element_coloring)
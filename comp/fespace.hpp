@@ -185,7 +185,19 @@ ANY                  1 1 1 1 | 15
 
     
     Table<int> element_coloring[4]; 
+    /// elements of every color are stored in this order ("rcm", "hilbert", "morton"), default by number
+    string element_order;
+    /// "greedy" or "blocks"
+    string coloring_type = "greedy";
+    /// for block coloring: elements of every block, and blocks of every color
+    Table<int> coloring_blocks[4];
+    Table<int> block_coloring[4];
     Table<int> facet_coloring;  // elements on facet in own colors (DG)
+    /// dofs of all elements, built in FinalizeUpdate if cache_element_dofs is set
+    Table<DofId> element_dofs[4];
+    bool cache_element_dofs = false;
+    /// graphs of sparse matrices on this space, reused by other bilinear-forms
+    mutable weak_ptr<MatrixGraph> shared_graphs[8];
     Array<COUPLING_TYPE> ctofdof;
 
     shared_ptr<ParallelDofs> paralleldofs;
@@ -245,7 +257,33 @@ ANY                  1 1 1 1 | 15
     const Table<int> & ElementColoring(VorB vb = VOL) const 
     { return element_coloring[vb]; }
 
+    /// spatially compact blocks of elements, empty if not colored block-wise
+    const Table<int> & ColoringBlocks(VorB vb = VOL) const 
+    { return coloring_blocks[vb]; }
+    /// blocks of every color, they do not share dofs
+    const Table<int> & BlockColoring(VorB vb = VOL) const 
+    { return block_coloring[vb]; }
+
     const Table<int> & FacetColoring() const;
+
+    /// build element-dof tables for all VorB
+    void UpdateElementDofTables ();
+    bool HasElementDofTable (VorB vb) const { return element_dofs[vb].Size() > 0; }
+    
+    /// dofs of the element from the element-dof table, or computed into temp
+    INLINE FlatArray<DofId> GetElementDofs (ElementId ei, Array<DofId> & temp) const
+    {
+      if (element_dofs[ei.VB()].Size())
+        return element_dofs[ei.VB()][ei.Nr()];
+      GetDofNrs (ei, temp);
+      return temp;
+    }
+
+    /// graph of a living sparse matrix allocated with the given coupling key
+    shared_ptr<MatrixGraph> GetSharedGraph (int key) const
+    { return shared_graphs[key].lock(); }
+    void SetSharedGraph (int key, shared_ptr<MatrixGraph> graph) const
+    { shared_graphs[key] = graph; }
     
     /// print report to stream
     virtual void PrintReport (ostream & ost) const override;
@@ -300,6 +338,7 @@ ANY                  1 1 1 1 | 15
       Array<DofId> & temp_dnums;
       LocalHeap & lh;
       mutable bool dofs_set = false;
+      mutable FlatArray<DofId> dofs;
     public:     
       INLINE Element (const FESpace & afes, ElementId id, Array<DofId> & atemp_dnums,
                       LocalHeap & alh)
@@ -313,9 +352,9 @@ ANY                  1 1 1 1 | 15
       INLINE FlatArray<DofId> GetDofs() const
       {
         if (!dofs_set)
-          fes.GetDofNrs (*this, temp_dnums);
+          dofs.Assign (fes.GetElementDofs (*this, temp_dnums));
         dofs_set = true;
-        return temp_dnums;
+        return dofs;
       }
 
       INLINE const ElementTransformation & GetTrafo() const
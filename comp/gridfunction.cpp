@@ -1236,8 +1236,8 @@ namespace ngcomp
     const FiniteElement & fel = fes->GetFE (ei, lh2);
     int dim = fes->GetDimension();
     
-    ArrayMem<int, 50> dnums;
-    fes->GetDofNrs (ei, dnums);
+    ArrayMem<int, 50> hdnums;
+    auto dnums = fes->GetElementDofs (ei, hdnums);
     
     VectorMem<50> elu(dnums.Size()*dim);
 
@@ -1301,8 +1301,8 @@ namespace ngcomp
     const FiniteElement & fel = fes->GetFE (ei, lh2);
     int dim = fes->GetDimension();
     
-    ArrayMem<int, 50> dnums;
-    fes->GetDofNrs (ei, dnums);
+    ArrayMem<int, 50> hdnums;
+    auto dnums = fes->GetElementDofs (ei, hdnums);
     
     VectorMem<50, Complex> elu(dnums.Size()*dim);
 
@@ -1358,16 +1358,19 @@ namespace ngcomp
         return;
       }
 
-    const FiniteElement & fel = fes->GetFE (ei, lh2);
-    int dim = fes->GetDimension();
-
-    ArrayMem<int, 50> dnums;
-    fes->GetDofNrs (ei, dnums);
-    
-    VectorMem<50> elu(dnums.Size()*dim);
-
-    gf->GetElementVector (comp, dnums, elu);
-    fes->TransformVec (ElementId(vb, elnr), elu, TRANSFORM_SOL);
+    ProxyUserData * ud = (ProxyUserData*)trafo.userdata;
+    FlatVector<> elu;
+    const FiniteElement * pfel = ud ? ud->GetElementVector (gf, comp, ei, elu) : nullptr;
+    if (!pfel)
+      {
+        pfel = &fes->GetFE (ei, lh2);
+        ArrayMem<int, 50> hdnums;
+        auto dnums = fes->GetElementDofs (ei, hdnums);
+        elu.AssignMemory (dnums.Size()*fes->GetDimension(), lh2);
+        gf->GetElementVector (comp, dnums, elu);
+        fes->TransformVec (ei, elu, TRANSFORM_SOL);
+      }
+    const FiniteElement & fel = *pfel;
 
     if (diffop[vb])
       diffop[vb]->Apply (fel, ir, elu, values, lh2);
@@ -1424,8 +1427,8 @@ namespace ngcomp
     const FiniteElement & fel = fes->GetFE (ei, lh2);
     int dim = fes->GetDimension();
 
-    ArrayMem<int, 50> dnums;
-    fes->GetDofNrs (ei, dnums);
+    ArrayMem<int, 50> hdnums;
+    auto dnums = fes->GetElementDofs (ei, hdnums);
     
     VectorMem<50,Complex> elu(dnums.Size()*dim);
 
@@ -1463,7 +1466,8 @@ namespace ngcomp
     ProxyUserData * ud = (ProxyUserData*)ir.GetTransformation().userdata;
     if (ud)
       {
-        if (ud->HasMemory(this) && ud->Computed(this))
+        if (ud->HasMemory(this) && ud->Computed(this) &&
+            ud->GetAMemory(this).Width() == ir.Size())
           {
             bvalues.AddSize(Dimension(), ir.Size()) = ud->GetAMemory(this);
             return;
@@ -1496,16 +1500,18 @@ namespace ngcomp
         return;
       }
     
-    const FiniteElement & fel = fes->GetFE (ei, lh2);
-    int dim = fes->GetDimension();
-
-    ArrayMem<int, 50> dnums;
-    fes->GetDofNrs (ei, dnums);
-    
-    VectorMem<50> elu(dnums.Size()*dim);
-
-    gf->GetElementVector (comp, dnums, elu);
-    fes->TransformVec (ei, elu, TRANSFORM_SOL);
+    // element vector is gathered once per element in PrepareUserData
+    FlatVector<> elu;
+    const FiniteElement * pfel = ud ? ud->GetElementVector (gf, comp, ei, elu) : nullptr;
+    if (!pfel)
+      {
+        pfel = &fes->GetFE (ei, lh2);
+        ArrayMem<int, 50> hdnums;
+        auto dnums = fes->GetElementDofs (ei, hdnums);
+        elu.AssignMemory (dnums.Size()*fes->GetDimension(), lh2);
+        gf->GetElementVector (comp, dnums, elu);
+        fes->TransformVec (ei, elu, TRANSFORM_SOL);
+      }
     /*
     if (diffop && vb==VOL)
       diffop->Apply (fel, ir, elu, values); // , lh2);
@@ -1521,14 +1527,13 @@ namespace ngcomp
       // fes.GetIntegrator(boundary) ->CalcFlux (fel, ir, elu, values, false, lh2);
     */
     if (diffop[vb])
-      diffop[vb]->Apply (fel, ir, elu, values);
+      diffop[vb]->Apply (*pfel, ir, elu, values);
     else
       throw Exception ("GridFunctionCoefficientFunction: SIMD: don't know how I shall evaluate");
 
-
     if (ud)
       {
-        if (ud->HasMemory(this))
+        if (ud->HasMemory(this) && ud->GetAMemory(this).Width() == ir.Size())
           {
             ud->GetAMemory(this) = bvalues;
             ud->SetComputed(this);
@@ -1536,6 +1541,29 @@ namespace ngcomp
       }    
   }
 
+  void GridFunctionCoefficientFunction ::
+  PrepareUserData (ProxyUserData & ud, const ElementTransformation & trafo,
+                   LocalHeap & lh) const
+  {
+    // gather the element vector once, it is shared by all
+    // coefficient functions (value, grad, hesse ...) of the same gridfunction
+    if (!gf || fes->IsComplex()) return;
+    if (gf -> GetLevelUpdated() < gf->GetMeshAccess()->GetNLevels()) return;
+    if (!trafo.BelongsToMesh ((void*)(fes->GetMeshAccess().get()))) return;
+
+    ElementId ei = trafo.GetElementId();
+    if (!fes->DefinedOn(ei.VB(), trafo.GetElementIndex())) return;
+    if (ud.HasElementVector (gf, comp, ei)) return;
+
+    const FiniteElement & fel = fes->GetFE (ei, lh);
+    ArrayMem<int, 50> hdnums;
+    auto dnums = fes->GetElementDofs (ei, hdnums);
+    FlatVector<> elu(dnums.Size()*fes->GetDimension(), lh);
+    gf->GetElementVector (comp, dnums, elu);
+    fes->TransformVec (ei, elu, TRANSFORM_SOL);
+    ud.AssignElementVector (gf, comp, ei, &fel, elu);
+  }
+
   void GridFunctionCoefficientFunction ::   
   Evaluate (const SIMD_BaseMappedIntegrationRule & ir,
             BareSliceMatrix<SIMD<Complex>> bvalues) const
@@ -1576,8 +1604,8 @@ namespace ngcomp
     const FiniteElement & fel = fes.GetFE (ei, lh2);
     int dim = fes.GetDimension();
 
-    ArrayMem<int, 50> dnums;
-    fes.GetDofNrs (ei, dnums);
+    ArrayMem<int, 50> hdnums;
+    auto dnums = fes.GetElementDofs (ei, hdnums);
     
     VectorMem<50, Complex> elu(dnums.Size()*dim);
 
@@ -81,6 +81,8 @@ namespace ngcomp
     { Evaluate (ir, result); deriv = 0.0; }
     */
     virtual bool StoreUserData() const override { return true; }
+    virtual void PrepareUserData (ProxyUserData & ud, const ElementTransformation & trafo,
+                                  LocalHeap & lh) const override;
 
     virtual void NonZeroPattern (const class ProxyUserData & ud, FlatVector<AutoDiffDiff<1,bool>> nonzero) const override
     {
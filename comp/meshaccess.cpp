@@ -512,9 +512,19 @@ namespace ngcomp
   template <int DIMS, int DIMR>
   class Ng_ConstElementTransformation : public ElementTransformation
   {
+  protected:
     const MeshAccess * mesh;
     Vec<DIMR> p0;
     Mat<DIMR,DIMS> mat;
+
+    /// p0 and mat are set by the derived class
+    INLINE Ng_ConstElementTransformation (const MeshAccess * amesh,
+                                          ELEMENT_TYPE aet, ElementId ei, int elindex,
+                                          bool /* uninitialized */)
+      : ElementTransformation(aet, ei, elindex), mesh(amesh)
+    {
+      iscurved = false;
+    }
   public:
     INLINE Ng_ConstElementTransformation (const MeshAccess * amesh,
                                           ELEMENT_TYPE aet, ElementId ei, int elindex) 
@@ -784,15 +794,125 @@ namespace ngcomp
     }
 
   };
-  
 
 
+  /*
+    Affine element transformation reading from the precomputed
+    AffineGeometryTable of the mesh. No netgen calls involved.
+   */
+  template <int DIMS, int DIMR>
+  class Table_ElementTransformation : public Ng_ConstElementTransformation<DIMS,DIMR>
+  {
+    typedef Ng_ConstElementTransformation<DIMS,DIMR> BASE;
+    using BASE::p0;
+    using BASE::mat;
+  public:
+    INLINE Table_ElementTransformation (const MeshAccess * amesh,
+                                        const AffineGeometryTable & table,
+                                        ElementId ei)
+      : BASE(amesh, table.eltype[ei.Nr()], ei, table.index[ei.Nr()], true)
+    {
+      size_t nr = ei.Nr();
+      for (int k = 0; k < DIMR; k++)
+        p0(k) = table.p0[k][nr];
+      for (int k = 0; k < DIMR; k++)
+        for (int j = 0; j < DIMS; j++)
+          mat(k,j) = table.jac[k*DIMS+j][nr];
+    }
+  };
+
 
+  template <int DIMS, int DIMR>
+  static void FillAffineGeometryTable (const MeshAccess * ma, VorB vb,
+                                       AffineGeometryTable & table)
+  {
+    ParallelFor (table.Size(), [&] (size_t i)
+      {
+        ElementId ei(vb, i);
+        Ngs_Element el = ma->GetElement(ei);
+        table.index[i] = el.GetIndex();
+        table.eltype[i] = el.GetType();
+
+        Vec<DIMR> p0 = 0.0;
+        Mat<DIMR,DIMS> mat = 0.0;
+        double det = 0;
+        if (!el.is_curved)
+          {
+            table.affine.SetBitAtomic(i);
+            Ng_ConstElementTransformation<DIMS,DIMR> trafo(ma, el.GetType(), ei, el.GetIndex());
+            IntegrationPoint ip(0.0, 0.0, 0.0);
+            trafo.CalcPointJacobian (ip, p0, mat);
+            if constexpr (DIMS == DIMR)
+              det = Det (mat);
+            else
+              {
+                Mat<DIMS,DIMS> gram = Trans(mat)*mat;
+                det = sqrt (Det (gram));
+              }
+          }
+        for (int k = 0; k < DIMR; k++)
+          table.p0[k][i] = p0(k);
+        for (int k = 0; k < DIMR; k++)
+          for (int j = 0; j < DIMS; j++)
+            table.jac[k*DIMS+j][i] = mat(k,j);
+        table.det[i] = det;
+      });
+  }
 
+  
+  size_t AffineGeometryTable :: GetMemoryUsage () const
+  {
+    size_t ncomp = dimr + dimr*dims + 1;
+    return Size() * (ncomp*sizeof(double) + sizeof(int) + sizeof(ELEMENT_TYPE))
+      + affine.Size()/8;
+  }
 
+  
+  void MeshAccess :: EnableGeometryTable (bool enable)
+  {
+    use_geometry_table = enable;
+    UpdateGeometryTable();
+  }
 
+  void MeshAccess :: UpdateGeometryTable ()
+  {
+    for (auto & table : geometry_table)
+      table = nullptr;
+    if (!use_geometry_table || dim < 1) return;
 
+    static Timer t("MeshAccess::UpdateGeometryTable"); RegionTimer reg(t);
 
+    for (VorB vb : { VOL, BND })
+      {
+        int dims = dim - int(vb);
+        if (dims < 1) continue;
+
+        size_t ne = GetNE(vb);
+        auto table = make_shared<AffineGeometryTable>();
+        table->dims = dims;
+        table->dimr = dim;
+        table->affine.SetSize(ne);
+        table->affine.Clear();
+        table->index = NumaDistributedArray<int> (ne);
+        table->eltype.SetSize(ne);
+        for (int k = 0; k < dim; k++)
+          table->p0[k] = NumaDistributedArray<double> (ne);
+        for (int k = 0; k < dim*dims; k++)
+          table->jac[k] = NumaDistributedArray<double> (ne);
+        table->det = NumaDistributedArray<double> (ne);
+
+        switch (10*dims+dim)
+          {
+          case 11: FillAffineGeometryTable<1,1> (this, vb, *table); break;
+          case 12: FillAffineGeometryTable<1,2> (this, vb, *table); break;
+          case 22: FillAffineGeometryTable<2,2> (this, vb, *table); break;
+          case 23: FillAffineGeometryTable<2,3> (this, vb, *table); break;
+          case 33: FillAffineGeometryTable<3,3> (this, vb, *table); break;
+          default: ;
+          }
+        geometry_table[vb] = table;
+      }
+  }
 
 
 
@@ -1139,6 +1259,7 @@ namespace ngcomp
       }
     
     CalcIdentifiedFacets();
+    UpdateGeometryTable();
   }
 
   void MeshAccess :: 
@@ -1453,6 +1574,7 @@ namespace ngcomp
             throw Exception ("Mesh::SetDeformation needs a GridFunction with dim="+ToString(dim));
         }
       deformation = def;
+      UpdateGeometryTable();
     }
   
     void MeshAccess :: SetPML (const shared_ptr<PML_Transformation> & pml_trafo, int _domnr)
@@ -1493,6 +1615,16 @@ namespace ngcomp
     
     ElementTransformation * eltrans;
     GridFunction * loc_deformation = deformation.get();
+
+    // fast path: straight element from precomputed table, no netgen access
+    if (auto table = geometry_table[VOL].get())
+      if (!loc_deformation && table->IsAffine(elnr) && !pml_trafos[table->index[elnr]])
+        {
+          eltrans = new (lh) Table_ElementTransformation<DIM,DIM> (this, *table, ElementId(VOL,elnr));
+          if(higher_integration_order.Size() == GetNE() && higher_integration_order[elnr])
+            eltrans->SetHigherIntegrationOrder();
+          return *eltrans;
+        }
     
     Ngs_Element el (mesh.GetElement<DIM> (elnr), ElementId(VOL, elnr));
     
@@ -1555,9 +1687,18 @@ namespace ngcomp
     // static Timer t("MeshAccess::GetTrafoDim");
 
     ElementTransformation * eltrans;
+    GridFunction * loc_deformation = deformation.get();
+
+    if (auto table = geometry_table[BND].get())
+      if (!loc_deformation && table->IsAffine(elnr))
+        {
+          eltrans = new (lh) Table_ElementTransformation<DIM-1,DIM> (this, *table, ElementId(BND,elnr));
+          if(higher_integration_order.Size() == GetNSE() && higher_integration_order[elnr])
+            eltrans->SetHigherIntegrationOrder();
+          return *eltrans;
+        }
     
     Ngs_Element el(mesh.GetElement<DIM-1> (elnr), ElementId(BND, elnr));
-    GridFunction * loc_deformation = deformation.get();
     
     if (loc_deformation)
 
@@ -1956,6 +2097,7 @@ namespace ngcomp
   void MeshAccess :: Curve (int order)
   {
     mesh.Curve(order);
+    UpdateGeometryTable();
   } 
   
   int MeshAccess :: GetCurveOrder ()
@@ -191,6 +191,32 @@ namespace ngcomp
 
   class GridFunction;
 
+
+  /**
+     Precomputed affine geometry (x = p0 + jac * xi) of straight-sided elements.
+     Stored as structure of arrays, every component is a NUMA-distributed
+     array over the elements. Curved elements are marked as not affine.
+   */
+  class NGS_DLL_HEADER AffineGeometryTable
+  {
+  public:
+    int dims, dimr;
+    BitArray affine;
+    NumaDistributedArray<int> index;
+    Array<ELEMENT_TYPE> eltype;
+    /// p0[k][elnr]
+    NumaDistributedArray<double> p0[3];
+    /// jac[k*dims+j][elnr] = dx_k / dxi_j
+    NumaDistributedArray<double> jac[9];
+    /// determinant, or surface measure for dims < dimr
+    NumaDistributedArray<double> det;
+
+    size_t Size() const { return index.Size(); }
+    bool IsAffine (size_t elnr) const { return affine.Test(elnr); }
+    size_t GetMemoryUsage () const;
+  };
+
+  
   class NGS_DLL_HEADER MeshAccess : public BaseStatusHandler
   {
     netgen::Ngx_Mesh mesh;
@@ -234,6 +260,10 @@ namespace ngcomp
 
     /// pml trafos per sub-domain
     Array<shared_ptr <PML_Transformation>> pml_trafos;
+
+    /// precomputed geometry of straight elements (VOL and BND), optional
+    bool use_geometry_table = false;
+    shared_ptr<AffineGeometryTable> geometry_table[2];
     
     Array<std::tuple<int,int>> identified_facets;
 
@@ -665,6 +695,14 @@ namespace ngcomp
       UpdateBuffers();
     }
     
+    /// store affine maps of straight elements, GetTrafo reads from the table
+    void EnableGeometryTable (bool enable = true);
+    bool UsesGeometryTable () const { return use_geometry_table; }
+    /// rebuild the table, called after refinement, curving and deformation
+    void UpdateGeometryTable ();
+    shared_ptr<AffineGeometryTable> GetGeometryTable (VorB vb) const
+    { return vb <= BND ? geometry_table[vb] : nullptr; }
+    
     void SetDeformation (shared_ptr<GridFunction> def = nullptr);
     /*
     {
@@ -0,0 +1,207 @@
+/*********************************************************************/
+/* File:   newton.cpp                                                */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+#include <comp.hpp>
+
+namespace ngcomp
+{
+
+  NewtonSolver :: NewtonSolver (shared_ptr<BilinearForm> abfa,
+                                shared_ptr<BitArray> afreedofs,
+                                string ainversetype,
+                                size_t heapsize)
+    : bfa(abfa), freedofs(afreedofs), inversetype(ainversetype),
+      lh(heapsize, "NewtonSolver")
+  {
+    auto fes = bfa->GetFESpace();
+    if (!freedofs)
+      freedofs = fes->GetFreeDofs (bfa->UsesEliminateInternal());
+    resdofs = bfa->UsesEliminateInternal() ? fes->GetFreeDofs(false) : freedofs;
+
+    has_energy = bfa->NumIntegrators() > 0;
+    for (auto & bfi : bfa->Integrators())
+      if (!dynamic_pointer_cast<SymbolicEnergy> (bfi))
+        has_energy = false;
+  }
+
+
+  double NewtonSolver :: Energy (const BaseVector & u)
+  {
+    double energy = bfa->Energy (u, lh);
+    lh.CleanUp();
+    if (rhs)
+      energy -= InnerProduct (*rhs, u);
+    return energy;
+  }
+
+
+  void NewtonSolver :: Linearize (const BaseVector & u)
+  {
+    static Timer t("NewtonSolver::Linearize");
+    static Timer tfact("NewtonSolver::Factor");
+
+    double starttime = WallTime();
+    {
+      RegionTimer reg(t);
+      // keeps matrix graph and sparse matrix of the previous step
+      bfa->AssembleLinearization (u, lh, false);
+      lh.CleanUp();
+    }
+    stats.linearizations++;
+    stats.time_linearization += WallTime()-starttime;
+
+    starttime = WallTime();
+    {
+      RegionTimer reg(tfact);
+      // numerical refactorization with the same symbolic factorization
+      auto have_sparse_fact = dynamic_pointer_cast<SparseFactorization> (inverse);
+      if (have_sparse_fact && have_sparse_fact->SupportsUpdate() &&
+          have_sparse_fact->GetAMatrix() == bfa->GetMatrixPtr())
+        have_sparse_fact->Update();
+      else
+        {
+          if (inversetype != "")
+            bfa->GetMatrix().SetInverseType (inversetype);
+          inverse = bfa->GetMatrix().InverseMatrix (freedofs);
+        }
+    }
+    stats.factorizations++;
+    stats.time_factorization += WallTime()-starttime;
+  }
+
+
+  double NewtonSolver :: CalcResidual (const BaseVector & u, BaseVector & res)
+  {
+    static Timer t("NewtonSolver::Residual");
+    RegionTimer reg(t);
+    double starttime = WallTime();
+
+    bfa->ApplyMatrix (u, res, lh);
+    lh.CleanUp();
+    if (rhs)
+      res -= *rhs;
+
+    hv = res;
+    Projector (resdofs, true).Project (hv);
+    double norm = hv.L2Norm();
+
+    stats.residuals++;
+    stats.time_residual += WallTime()-starttime;
+    return norm;
+  }
+
+
+  void NewtonSolver :: SolveCorrection (BaseVector & res, BaseVector & corr)
+  {
+    static Timer t("NewtonSolver::Solve");
+    RegionTimer reg(t);
+    double starttime = WallTime();
+
+    if (bfa->UsesEliminateInternal())
+      {
+        res += *bfa->GetHarmonicExtensionTrans() * res;
+        corr = *inverse * res;
+        corr += *bfa->GetHarmonicExtension() * corr;
+        corr += *bfa->GetInnerSolve() * res;
+      }
+    else
+      corr = *inverse * res;
+
+    stats.time_solve += WallTime()-starttime;
+  }
+
+
+  int NewtonSolver :: Solve (BaseVector & u)
+  {
+    static Timer t("NewtonSolver::Solve - total");
+    RegionTimer reg(t);
+
+    // work vectors are kept between calls
+    if (w.Size() != u.Size())
+      {
+        w.AssignPointer (u.CreateVector());
+        r.AssignPointer (u.CreateVector());
+        uh.AssignPointer (u.CreateVector());
+        hv.AssignPointer (u.CreateVector());
+      }
+
+    stats = Statistics();
+    // a linearization from a previous call is not reused
+    int reused = max_jacobian_reuse;
+    double lastres = 0;
+    double err = 1;
+
+    for (int it = 0; it < maxit; it++)
+      {
+        stats.iterations++;
+        if (printing)
+          cout << "Newton iteration " << it << endl;
+
+        double resnorm = CalcResidual (u, r);
+
+        // inexact Newton: keep the Jacobian while the residual drops fast enough
+        if (!inverse || reused >= max_jacobian_reuse ||
+            resnorm > jacobian_reuse_ratio * lastres)
+          {
+            Linearize (u);
+            reused = 0;
+          }
+        else
+          reused++;
+        lastres = resnorm;
+
+        SolveCorrection (r, w);
+
+        double err2 = InnerProduct (w, r);
+        err = sqrt (fabs (err2));
+        if (printing)
+          cout << "err = " << err << endl;
+
+        double tau = min (1.0, (it+1)*dampfactor);
+
+        if (linesearch)
+          {
+            static Timer tls("NewtonSolver::LineSearch");
+            RegionTimer reg(tls);
+
+            uh = u - tau * w;
+            if (has_energy)
+              {
+                double energy = Energy (u);
+                while (Energy (uh) > energy + max (1e-14*fabs(energy), maxerr) && tau > 1e-10)
+                  {
+                    tau *= 0.5;
+                    uh = u - tau * w;
+                    stats.linesearch_steps++;
+                    if (printing)
+                      cout << "tau = " << tau << endl;
+                  }
+              }
+            else
+              {
+                // no energy functional, the residual norm has to decrease
+                while (CalcResidual (uh, r) > (1-1e-4*tau) * resnorm && tau > 1e-10)
+                  {
+                    tau *= 0.5;
+                    uh = u - tau * w;
+                    stats.linesearch_steps++;
+                    if (printing)
+                      cout << "tau = " << tau << endl;
+                  }
+              }
+            u = uh;
+          }
+        else
+          u -= tau * w;
+
+        if (err < maxerr)
+          return it+1;
+      }
+
+    cout << IM(1) << "Warning: Newton might not converge! Error = " << err << endl;
+    return -1;
+  }
+
+}
@@ -0,0 +1,105 @@
+#ifndef FILE_NEWTON
+#define FILE_NEWTON
+
+/*********************************************************************/
+/* File:   newton.hpp                                                */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+namespace ngcomp
+{
+
+  /**
+     Newton's method for A(u) = f, where A is a BilinearForm with
+     nonlinear integrators.
+
+     The linearized matrix (and with it the matrix graph) is assembled
+     into the same sparse matrix in every step. Factorizations which
+     support it (sparsecholesky, umfpack) are updated numerically,
+     keeping their symbolic factorization.
+
+     Inexact Newton: the linearization may be kept for up to
+     max_jacobian_reuse steps, as long as the residual decreases by
+     at least jacobian_reuse_ratio per step.
+
+     Line search halves the step as long as the energy increases,
+     as the Python NewtonSolver does. If the form is not given by
+     energy integrators (Variation), the step is halved as long as the
+     residual norm does not decrease.
+  */
+  class NGS_DLL_HEADER NewtonSolver
+  {
+  public:
+    struct Statistics
+    {
+      int iterations = 0;
+      int linearizations = 0;
+      int factorizations = 0;
+      int residuals = 0;
+      int linesearch_steps = 0;
+      double time_linearization = 0;
+      double time_factorization = 0;
+      double time_solve = 0;
+      double time_residual = 0;
+    };
+
+  protected:
+    shared_ptr<BilinearForm> bfa;
+    shared_ptr<BitArray> freedofs;
+    /// dofs of the residual norm, including condensed ones
+    shared_ptr<BitArray> resdofs;
+    string inversetype;
+    shared_ptr<BaseMatrix> inverse;
+    shared_ptr<BaseVector> rhs;
+
+    /// correction, residual, trial vector and scratch
+    AutoVector w, r, uh, hv;
+    LocalHeap lh;
+
+    int maxit = 100;
+    double maxerr = 1e-11;
+    double dampfactor = 1;
+    bool linesearch = false;
+    int max_jacobian_reuse = 0;
+    double jacobian_reuse_ratio = 0.5;
+    bool printing = false;
+    /// all integrators are SymbolicEnergy, line search on the energy
+    bool has_energy = false;
+
+    Statistics stats;
+
+  public:
+    NewtonSolver (shared_ptr<BilinearForm> abfa,
+                  shared_ptr<BitArray> afreedofs = nullptr,
+                  string ainversetype = "",
+                  size_t heapsize = 10000000);
+
+    void SetRHS (shared_ptr<BaseVector> arhs) { rhs = arhs; }
+    void SetMaxIterations (int amaxit) { maxit = amaxit; }
+    void SetMaxError (double amaxerr) { maxerr = amaxerr; }
+    void SetDampFactor (double adampfactor) { dampfactor = adampfactor; }
+    void SetLineSearch (bool alinesearch) { linesearch = alinesearch; }
+    void SetJacobianReuse (int amax, double aratio)
+    { max_jacobian_reuse = amax; jacobian_reuse_ratio = aratio; }
+    void SetPrinting (bool aprinting) { printing = aprinting; }
+
+    /// solves starting from u, returns number of iterations, or -1 if not converged
+    int Solve (BaseVector & u);
+
+    const Statistics & GetStatistics () const { return stats; }
+    shared_ptr<BaseMatrix> GetInverse () const { return inverse; }
+
+  protected:
+    /// assemble linearization at u, and update the inverse
+    void Linearize (const BaseVector & u);
+    /// res = A(u) - f, returns its norm on resdofs
+    double CalcResidual (const BaseVector & u, BaseVector & res);
+    /// energy minus rhs * u
+    double Energy (const BaseVector & u);
+    /// corr = A'(u)^{-1} res, including static condensation (modifies res)
+    void SolveCorrection (BaseVector & res, BaseVector & corr);
+  };
+
+}
+
+#endif
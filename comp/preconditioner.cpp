@@ -165,44 +165,30 @@ namespace ngcomp
 
 
 
-  void Preconditioner :: Timing () const
+  std::list<std::tuple<std::string,double>> Preconditioner :: Timing () const
   {
     cout << IM(1) << "Timing Preconditioner ... " << flush;
+    std::list<std::tuple<std::string,double>> results;
     const BaseMatrix & amat = GetAMatrix();
     const BaseMatrix & pre = GetMatrix();
 
-    clock_t starttime;
-    double time;
-    starttime = clock();
-
-    BaseVector & vecf = *pre.CreateColVector();
-    BaseVector & vecu = *pre.CreateColVector();
-
+    auto vecf = pre.CreateColVector();
+    auto vecu = pre.CreateColVector();
     vecf = 1;
-    int steps = 0;
-    do
-      {
-	vecu = pre * vecf;
-	steps++;
-	time = double(clock() - starttime) / CLOCKS_PER_SEC;
-      }
-    while (time < 2.0);
-
-    cout << IM(1) << " 1 step takes " << time / steps << " seconds" << endl;
-
-
-    starttime = clock();
-    steps = 0;
-    do
-      {
-	vecu = amat * vecf;
-	steps++;
-	time = double(clock() - starttime) / CLOCKS_PER_SEC;
-      }
-    while (time < 2.0);
-
-    cout << IM(1) << ", 1 matrix takes "
-	 << time / steps << " seconds" << endl;
+    double ndof = max2 (vecf.Size(), size_t(1));
+
+    double time = RunTiming([&]() {
+        pre.Mult (vecf, vecu);
+      });
+    cout << IM(1) << " 1 step takes " << time << " seconds" << endl;
+    results.push_back(std::make_tuple<std::string,double>("Mult", 1e9*time / ndof));
+
+    time = RunTiming([&]() {
+        amat.Mult (vecf, vecu);
+      });
+    cout << IM(1) << ", 1 matrix takes " << time << " seconds" << endl;
+    results.push_back(std::make_tuple<std::string,double>("matrix Mult", 1e9*time / ndof));
+    return results;
   }
 
 
@@ -118,7 +118,8 @@ namespace ngcomp
     virtual int VWidth() const override { return GetMatrix().VWidth();}
 
     void Test () const;
-    void Timing () const;
+    /// times application of preconditioner and matrix, in ns per dof
+    std::list<std::tuple<std::string,double>> Timing () const;
     void ThrowPreconditionerNotReady() const;
     const Flags & GetFlags() const { return flags; }
 
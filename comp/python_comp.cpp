@@ -1361,14 +1361,32 @@ BND : boolean or None
 	docu_string(R"delimiter(Reordered Finite Element Spaces.
 ...
 )delimiter"))
-    .def(py::init([] (shared_ptr<FESpace> & fes)
+    .def(py::init([] (shared_ptr<FESpace> & fes, const string & method)
                   {
                     Flags flags = fes->GetFlags();
+                    flags.SetFlag ("reorder", method);
                     auto refes = make_shared<ReorderedFESpace>(fes, flags);
                     refes->Update();
                     refes->FinalizeUpdate();
                     return refes;
-                  }), py::arg("fespace"))
+                  }), py::arg("fespace"), py::arg("method")="nodes",
+         docu_string(R"delimiter(
+method : string
+  'nodes' .. dofs node type by node type (default),
+  'rcm' .. reverse Cuthill-McKee of the dof graph,
+  'hilbert', 'morton' .. dofs in the order of elements along a space
+  filling curve through the element centroids.
+)delimiter"))
+    .def_property_readonly("bandwidth", [](ReorderedFESpace & self)
+                           {
+                             return py::make_tuple (self.GetBandwidthProfile(false)[0],
+                                                    self.GetBandwidthProfile(true)[0]);
+                           }, "bandwidth of the element matrix graph (before, after) reordering")
+    .def_property_readonly("profile", [](ReorderedFESpace & self)
+                           {
+                             return py::make_tuple (self.GetBandwidthProfile(false)[1],
+                                                    self.GetBandwidthProfile(true)[1]);
+                           }, "profile of the element matrix graph (before, after) reordering")
     /*
     .def(py::pickle([](const PeriodicFESpace* per_fes)
                     {
@@ -2149,6 +2167,8 @@ reallocate : bool
 
 )raw_string"))
 
+    .def("__timing__", [] (BF & self) { return py::cast(self.Timing()); })
+
     .def_property_readonly("mat", [](shared_ptr<BF> self) -> shared_ptr<BaseMatrix>
                                          {
                                            if (self->NonAssemble())
@@ -2408,6 +2428,151 @@ integrator : ngsolve.fem.LFI
 
     ;
 
+  ////////////////////////////// NewtonSolver ///////////////////////////////
+
+  py::class_<NewtonSolver, shared_ptr<NewtonSolver>> (m, "NewtonSolver",
+                                                      docu_string(R"raw_string(
+Newton's method for A(u) = f, implemented in C++.
+
+The sparse matrix of the linearization, its matrix graph, the
+factorization (numerically updated for sparsecholesky and umfpack)
+and all work vectors are kept between Newton steps and between calls
+of Solve.
+
+Parameters:
+
+a : ngsolve.comp.BilinearForm
+  nonlinear form, does not have to be assembled
+
+freedofs : ngsolve.ngstd.BitArray
+  dofs to invert, default are the FreeDofs of the space (w.r.t. condense)
+
+inverse : str
+  sparse direct solver for the linearized problems
+
+rhs : ngsolve.la.BaseVector
+  right hand side f, default is 0
+
+)raw_string"))
+    .def(py::init([](shared_ptr<BilinearForm> bfa, shared_ptr<BitArray> freedofs,
+                     string inverse, shared_ptr<BaseVector> rhs)
+                  {
+                    auto solver = make_shared<NewtonSolver> (bfa, freedofs, inverse);
+                    solver->SetRHS (rhs);
+                    return solver;
+                  }),
+         py::arg("a"), py::arg("freedofs")=nullptr,
+         py::arg("inverse")="", py::arg("rhs")=nullptr)
+    .def("Solve", [](NewtonSolver & self, BaseVector & u, int maxit, double maxerr,
+                     double dampfactor, bool linesearch,
+                     int max_jacobian_reuse, double jacobian_reuse_ratio, bool printing)
+         {
+           self.SetMaxIterations (maxit);
+           self.SetMaxError (maxerr);
+           self.SetDampFactor (dampfactor);
+           self.SetLineSearch (linesearch);
+           self.SetJacobianReuse (max_jacobian_reuse, jacobian_reuse_ratio);
+           self.SetPrinting (printing);
+           return self.Solve (u);
+         },
+         py::arg("u"), py::arg("maxit")=100, py::arg("maxerr")=1e-11,
+         py::arg("dampfactor")=1, py::arg("linesearch")=false,
+         py::arg("max_jacobian_reuse")=0, py::arg("jacobian_reuse_ratio")=0.5,
+         py::arg("printing")=false,
+         py::call_guard<py::gil_scoped_release>(),
+         docu_string(R"raw_string(
+Solves A(u) = f starting from u. Returns the number of iterations,
+or -1 if not converged.
+
+max_jacobian_reuse : int
+  the linearization is kept for up to so many steps, as long as the
+  residual is reduced by at least jacobian_reuse_ratio per step
+)raw_string"))
+    .def_property_readonly("inverse", &NewtonSolver::GetInverse)
+    .def_property_readonly("statistics", [](NewtonSolver & self)
+                           {
+                             auto & st = self.GetStatistics();
+                             py::dict res;
+                             res["iterations"] = st.iterations;
+                             res["linearizations"] = st.linearizations;
+                             res["factorizations"] = st.factorizations;
+                             res["residuals"] = st.residuals;
+                             res["linesearch_steps"] = st.linesearch_steps;
+                             res["time_linearization"] = st.time_linearization;
+                             res["time_factorization"] = st.time_factorization;
+                             res["time_solve"] = st.time_solve;
+                             res["time_residual"] = st.time_residual;
+                             return res;
+                           }, "counters and wall-times of the last Solve")
+    ;
+
+#ifndef WIN32
+  py::class_<SolveServer, shared_ptr<SolveServer>> (m, "SolveServer",
+                                                    docu_string(R"raw_string(
+Keeps assembled systems and their inverses resident, and solves for
+right hand sides sent by clients (see ngsolve.solveserver.SolveClient)
+over a unix domain socket or a local TCP port.
+
+Requests of all clients are queued, right hand sides for the same
+system are solved together. Setting a Parameter re-assembles and
+re-factors the systems at their next solve.
+)raw_string"))
+    .def(py::init<>())
+    .def("AddSystem", &SolveServer::AddSystem,
+         py::arg("name"), py::arg("bf"), py::arg("freedofs")=nullptr, py::arg("inverse")="",
+         docu_string(R"raw_string(
+Adds system A u = f, with A given by the bilinear form bf. It is
+assembled and factored at the first solve, if not assembled yet.
+
+freedofs : ngsolve.ngstd.BitArray
+  dofs to invert, default are the FreeDofs of the space (w.r.t. condense)
+)raw_string"))
+    .def("AddParameter", [](SolveServer & self, string name, shared_ptr<CoefficientFunction> par)
+         {
+           auto p = dynamic_pointer_cast<ParameterCoefficientFunction> (par);
+           if (!p)
+             throw Exception ("SolveServer.AddParameter: '" + name + "' is not a Parameter");
+           self.AddParameter (name, p);
+         }, py::arg("name"), py::arg("parameter"))
+    .def("Serve", [](SolveServer & self, py::object address)
+         {
+           if (py::isinstance<py::int_> (address))
+             {
+               int port = address.cast<int>();
+               py::gil_scoped_release release;
+               self.Serve (port);
+             }
+           else
+             {
+               string path = address.cast<string>();
+               py::gil_scoped_release release;
+               self.Serve (path);
+             }
+         }, py::arg("address"),
+         docu_string(R"raw_string(
+Serves until a client sends 'shutdown', or Stop is called. Run it
+inside a TaskManager for parallel assembling and solving.
+
+address : str or int
+  path of a unix domain socket, or a TCP port on localhost
+)raw_string"))
+    .def("Stop", &SolveServer::Stop)
+    .def_property("batch_wait", &SolveServer::GetBatchWait, &SolveServer::SetBatchWait,
+                  "seconds to wait for further requests to solve them together")
+    .def_property("max_rhs", &SolveServer::GetMaxRHS, &SolveServer::SetMaxRHS,
+                  "maximal number of right hand sides of one solve request")
+    .def_property_readonly("batches", &SolveServer::GetNumBatches)
+    .def("Statistics", [](SolveServer & self, string name)
+         {
+           auto & sys = self.GetSystem (name);
+           py::dict res;
+           res["solves"] = sys.solves;
+           res["factorizations"] = sys.factorizations;
+           return res;
+         }, py::arg("name"))
+    ;
+#endif
+
   ////////////////////////////// Prolongation ///////////////////////////////
 
   py::class_<Prolongation, shared_ptr<Prolongation>> (m, "Prolongation")
@@ -2441,6 +2606,7 @@ integrator : ngsolve.fem.LFI
                      );
                 })
     .def ("Test", [](Preconditioner &pre) { pre.Test();}, py::call_guard<py::gil_scoped_release>())
+    .def("__timing__", [] (Preconditioner & self) { return py::cast(self.Timing()); })
     .def ("Update", [](Preconditioner &pre) { pre.Update();}, py::call_guard<py::gil_scoped_release>(), "Update preconditioner")
     .def_property_readonly("mat", [](Preconditioner &self)
                    {
@@ -2966,6 +3132,219 @@ element_wise: bool = False
     ;
 
 
+  m.def("IntegrateMany",
+        [](py::list pycfs, shared_ptr<MeshAccess> ma, VorB vb, int order,
+           Region * definedon, bool compile) -> py::list
+        {
+          static Timer t("Integrate many CFs"); RegionTimer reg(t);
+          BitArray mask;
+          if (definedon)
+            {
+              vb = VorB(*definedon);
+              mask = BitArray((*definedon).Mask());
+            }
+          if(!mask.Size()){
+            mask = BitArray(ma->GetNRegions(vb));
+            mask.Set();
+          }
+
+          Array<shared_ptr<CoefficientFunction>> cfs;
+          for (auto pycf : pycfs)
+            cfs.Append (py::cast<spCF> (pycf));
+          if (!cfs.Size())
+            return py::list();
+
+          bool iscomplex = false;
+          for (auto cf : cfs)
+            {
+              iscomplex |= cf->IsComplex();
+              cf -> TraverseTree
+                ([&] (CoefficientFunction & stepcf)
+                 {
+                   if (dynamic_cast<ProxyFunction*>(&stepcf))
+                     throw Exception("Cannot integrate ProxFunction!");
+                 });
+            }
+
+          // one function, compiled once such that common subexpressions are evaluated once
+          auto cf = MakeVectorialCoefficientFunction (Array<shared_ptr<CoefficientFunction>> (cfs));
+          if (compile)
+            cf = Compile (cf);
+
+          auto integrate = [&] (auto tscal)
+          {
+            typedef decltype(tscal) TSCAL;
+            size_t dim = cf->Dimension();
+            size_t ne = ma->GetNE(vb);
+
+            // integration rules per element type
+            Array<shared_ptr<IntegrationRule>> rules(ET_HEX+1);
+            Array<shared_ptr<SIMD_IntegrationRule>> simd_rules(ET_HEX+1);
+            for (auto et : { ET_POINT, ET_SEGM, ET_TRIG, ET_QUAD, ET_TET, ET_PYRAMID, ET_PRISM, ET_HEX })
+              if (ElementTopology::GetSpaceDim(et) == ma->GetDimension()-int(vb))
+                {
+                  rules[et] = make_shared<IntegrationRule> (et, order);
+                  simd_rules[et] = make_shared<SIMD_IntegrationRule> (et, order);
+                }
+
+            auto element_integral = [&] (ElementId ei, bool simd, FlatVector<TSCAL> hsum, LocalHeap & lh)
+            {
+              auto & trafo = ma->GetTrafo (ei, lh);
+              ELEMENT_TYPE et = trafo.GetElementType();
+              if (simd)
+                {
+                  auto & mir = trafo(*simd_rules[et], lh);
+                  FlatMatrix<SIMD<TSCAL>> values(dim, mir.Size(), lh);
+                  cf -> Evaluate (mir, values);
+                  for (size_t j = 0; j < dim; j++)
+                    {
+                      SIMD<TSCAL> vsum(TSCAL(0.0));
+                      for (size_t i = 0; i < values.Width(); i++)
+                        vsum += mir[i].GetWeight() * values(j,i);
+                      hsum(j) += HSum(vsum);
+                    }
+                }
+              else
+                {
+                  BaseMappedIntegrationRule & mir = trafo(*rules[et], lh);
+                  FlatMatrix<TSCAL> values(mir.Size(), dim, lh);
+                  cf -> Evaluate (mir, values);
+                  for (size_t i = 0; i < values.Height(); i++)
+                    hsum += mir[i].GetWeight() * values.Row(i);
+                }
+            };
+
+            // SIMD support is decided once on the first element, all elements are
+            // integrated the same way
+            bool use_simd = true;
+            for (size_t nr : Range(ne))
+              {
+                ElementId ei(vb, nr);
+                if (!mask.Test(ma->GetElIndex(ei))) continue;
+                HeapReset hr(glh);
+                FlatVector<TSCAL> hsum(dim, glh);
+                hsum = TSCAL(0.0);
+                try
+                  {
+                    element_integral (ei, true, hsum, glh);
+                  }
+                catch (ExceptionNOSIMD & e)
+                  {
+                    use_simd = false;
+                  }
+                break;
+              }
+
+            // sums over blocks of consecutive elements, independent of the number of threads
+            constexpr size_t blocksize = 128;
+            size_t nblocks = (ne+blocksize-1) / blocksize;
+            Matrix<TSCAL> blocksums(nblocks, dim);
+            auto sweep = [&] ()
+            {
+              atomic<bool> simd_failed(false);
+              ParallelFor (nblocks, [&] (size_t b)
+                {
+                  LocalHeap lh = glh.Split();
+                  auto bsum = blocksums.Row(b);
+                  bsum = TSCAL(0.0);
+                  for (size_t nr : IntRange(b*blocksize, min2(ne, (b+1)*blocksize)))
+                    {
+                      ElementId ei(vb, nr);
+                      if (!mask.Test(ma->GetElIndex(ei))) continue;
+                      HeapReset hr(lh);
+                      FlatVector<TSCAL> hsum(dim, lh);
+                      hsum = TSCAL(0.0);
+                      try
+                        {
+                          element_integral (ei, use_simd, hsum, lh);
+                        }
+                      catch (ExceptionNOSIMD & e)
+                        {
+                          simd_failed = true;
+                          return;
+                        }
+                      bsum += hsum;
+                    }
+                });
+              return !simd_failed;
+            };
+            // an element without SIMD support later on restarts the sweep without SIMD
+            if (!sweep())
+              {
+                use_simd = false;
+                sweep();
+              }
+
+            // pairwise summation of the block sums in a fixed order
+            for (size_t step = 1; step < nblocks; step *= 2)
+              for (size_t b = 0; b+step < nblocks; b += 2*step)
+                blocksums.Row(b) += blocksums.Row(b+step);
+
+            Vector<TSCAL> sum(dim);
+            sum = TSCAL(0.0);
+            if (nblocks)
+              sum = blocksums.Row(0);
+#ifdef PARALLEL
+            if (ma->GetCommunicator().Size() > 1)
+              MPI_Allreduce(MPI_IN_PLACE, &sum(0), dim, MPI_typetrait<TSCAL>::MPIType(), MPI_SUM, ma->GetCommunicator());
+#endif
+            return sum;
+          };
+
+          auto results = [&] (auto & sum)
+          {
+            typedef std::decay_t<decltype(sum(0))> TSCAL;
+            py::list result;
+            size_t offset = 0;
+            for (auto cf : cfs)
+              {
+                size_t d = cf->Dimension();
+                if (d == 1)
+                  result.append (py::cast (sum(offset)));
+                else
+                  result.append (py::cast (Vector<TSCAL> (sum.Range(offset, offset+d))));
+                offset += d;
+              }
+            return result;
+          };
+
+          if (iscomplex)
+            {
+              Vector<Complex> sum(cf->Dimension());
+              {
+                py::gil_scoped_release release;
+                sum = integrate (Complex(0.0));
+              }
+              return results (sum);
+            }
+          Vector<double> sum(cf->Dimension());
+          {
+            py::gil_scoped_release release;
+            sum = integrate (double(0.0));
+          }
+          return results (sum);
+        },
+        py::arg("cfs"), py::arg("mesh"), py::arg("VOL_or_BND")=VOL,
+        py::arg("order")=5,
+        py::arg("definedon") = nullptr,
+        py::arg("compile")=true,
+        R"raw(
+Integrates a list of CoefficientFunctions in one sweep over the mesh, and
+returns the list of integrals (numbers, or arrays for vector valued functions).
+
+The functions are evaluated together on the same mapped integration rules,
+as one compiled function such that common subexpressions are computed once
+(compile=False evaluates the functions uncompiled).
+
+Elements are summed in blocks of consecutive elements, and the block sums
+are added pairwise in a fixed order. The results are bitwise identical for
+any number of threads.
+
+See Integrate for the other arguments.
+)raw")
+    ;
+
+
   m.def ("Integrate",
          [] (const SumOfIntegrals & igls, const MeshAccess & ma, bool element_wise) -> py::object
          {
@@ -459,6 +459,13 @@ mesh (netgen.Mesh): a mesh generated from Netgen
 
     .def("UnsetDeformation", [](MeshAccess & ma){ ma.SetDeformation(nullptr);}, "Unset the deformation")
 
+    .def("EnableGeometryTable", &MeshAccess::EnableGeometryTable,
+         py::arg("enable")=true,
+         docu_string(R"raw_string(
+Precompute and store the affine maps of all straight-sided elements.
+Element transformations are then read from the table without netgen calls.
+The table is rebuilt after refinement, curving and deformation.)raw_string"))
+
     .def("SetPML", 
 	 [](MeshAccess & ma,  shared_ptr<PML> apml, py::object definedon)
           {
@@ -0,0 +1,334 @@
+/*********************************************************************/
+/* File:   renumbering.cpp                                           */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+#include <comp.hpp>
+
+namespace ngcomp
+{
+
+  Array<int> ReverseCuthillMcKee (const Table<int> & graph)
+  {
+    static Timer t("ReverseCuthillMcKee");
+    RegionTimer reg(t);
+
+    size_t n = graph.Size();
+    auto degree = [&graph] (int i) { return graph[i].Size(); };
+
+    Array<int> order;
+    order.SetAllocSize (n);
+    Array<bool> visited(n);
+    visited = false;
+
+    Array<int> mark(n);
+    mark = -1;
+    int stamp = 0;
+    Array<int> queue;
+
+    // breadth first search from root, returns the depth and the last level
+    auto bfs = [&] (int root, Array<int> & lastlevel)
+      {
+        stamp++;
+        queue.SetSize0();
+        queue.Append (root);
+        mark[root] = stamp;
+        size_t first = 0;
+        int depth = 0;
+        while (true)
+          {
+            size_t last = queue.Size();
+            for (size_t k = first; k < last; k++)
+              for (int j : graph[queue[k]])
+                if (mark[j] != stamp)
+                  {
+                    mark[j] = stamp;
+                    queue.Append (j);
+                  }
+            if (queue.Size() == last)
+              {
+                lastlevel.SetSize (last-first);
+                for (size_t k = first; k < last; k++)
+                  lastlevel[k-first] = queue[k];
+                return depth;
+              }
+            first = last;
+            depth++;
+          }
+      };
+
+    Array<int> lastlevel, lastlevel2, nbs;
+    for (size_t start = 0; start < n; start++)
+      {
+        if (visited[start]) continue;
+
+        // pseudo-peripheral root (George-Liu)
+        int root = start;
+        int depth = bfs (root, lastlevel);
+        for (int iter = 0; iter < 5; iter++)
+          {
+            int cand = lastlevel[0];
+            for (int c : lastlevel)
+              if (degree(c) < degree(cand)) cand = c;
+            int depth2 = bfs (cand, lastlevel2);
+            if (depth2 <= depth) break;
+            root = cand;
+            depth = depth2;
+            Swap (lastlevel, lastlevel2);
+          }
+
+        // Cuthill-McKee numbering of the component
+        size_t first = order.Size();
+        order.Append (root);
+        visited[root] = true;
+        for (size_t k = first; k < order.Size(); k++)
+          {
+            nbs.SetSize0();
+            for (int j : graph[order[k]])
+              if (!visited[j])
+                {
+                  visited[j] = true;
+                  nbs.Append (j);
+                }
+            QuickSort (nbs, [&degree] (int a, int b) { return degree(a) < degree(b); });
+            order.Append (nbs);
+          }
+      }
+
+    for (size_t i = 0; i < n/2; i++)
+      Swap (order[i], order[n-1-i]);
+    return order;
+  }
+
+
+  // Skilling's transform to the transposed Hilbert index
+  template <int D>
+  static uint64_t HilbertKey (Vec<D,uint32_t> x, int bits)
+  {
+    uint32_t M = uint32_t(1) << (bits-1);
+    for (uint32_t Q = M; Q > 1; Q >>= 1)
+      {
+        uint32_t P = Q-1;
+        for (int i = 0; i < D; i++)
+          if (x[i] & Q)
+            x[0] ^= P;
+          else
+            {
+              uint32_t t = (x[0]^x[i]) & P;
+              x[0] ^= t;
+              x[i] ^= t;
+            }
+      }
+    for (int i = 1; i < D; i++)
+      x[i] ^= x[i-1];
+    uint32_t t = 0;
+    for (uint32_t Q = M; Q > 1; Q >>= 1)
+      if (x[D-1] & Q) t ^= Q-1;
+    for (int i = 0; i < D; i++)
+      x[i] ^= t;
+
+    uint64_t key = 0;
+    for (int b = bits-1; b >= 0; b--)
+      for (int i = 0; i < D; i++)
+        key = (key << 1) | ((x[i] >> b) & 1);
+    return key;
+  }
+
+  template <int D>
+  static uint64_t MortonKey (Vec<D,uint32_t> x, int bits)
+  {
+    uint64_t key = 0;
+    for (int b = bits-1; b >= 0; b--)
+      for (int i = 0; i < D; i++)
+        key = (key << 1) | ((x[i] >> b) & 1);
+    return key;
+  }
+
+  Array<int> SpaceFillingCurveOrder (FlatArray<Vec<3>> points, bool hilbert)
+  {
+    static Timer t("SpaceFillingCurveOrder");
+    RegionTimer reg(t);
+
+    size_t n = points.Size();
+    Array<int> order(n);
+    for (size_t i = 0; i < n; i++)
+      order[i] = i;
+    if (n == 0) return order;
+
+    Vec<3> pmin = points[0], pmax = points[0];
+    for (auto & p : points)
+      for (int k = 0; k < 3; k++)
+        {
+          pmin(k) = min2 (pmin(k), p(k));
+          pmax(k) = max2 (pmax(k), p(k));
+        }
+
+    // flat directions are dropped, 2D meshes use a 2D curve
+    int dims[3];
+    int D = 0;
+    double h = 0;
+    for (int k = 0; k < 3; k++)
+      h = max2 (h, pmax(k)-pmin(k));
+    for (int k = 0; k < 3; k++)
+      if (pmax(k)-pmin(k) > 1e-12 * h)
+        dims[D++] = k;
+    if (D == 0) return order;
+
+    // same scaling in all directions keeps the curve isotropic
+    int bits = 63 / max(D,2);
+    double scale = ((uint64_t(1) << bits) - 1) / h;
+
+    Array<uint64_t> keys(n);
+    ParallelForRange (n, [&] (IntRange r)
+      {
+        for (auto i : r)
+          {
+            Vec<3,uint32_t> x = 0;
+            for (int k = 0; k < D; k++)
+              x[k] = uint32_t ((points[i](dims[k]) - pmin(dims[k])) * scale);
+            switch (D)
+              {
+              case 1: keys[i] = x[0]; break;
+              case 2: keys[i] = hilbert ? HilbertKey<2> (Vec<2,uint32_t>(x[0],x[1]), bits)
+                                        : MortonKey<2> (Vec<2,uint32_t>(x[0],x[1]), bits); break;
+              default: keys[i] = hilbert ? HilbertKey<3> (x, bits) : MortonKey<3> (x, bits);
+              }
+          }
+      });
+
+    QuickSortI (keys, order);
+    return order;
+  }
+
+
+  Table<int> NodeGraph (const Table<int> & el2node, size_t nnodes)
+  {
+    static Timer t("NodeGraph");
+    RegionTimer reg(t);
+
+    TableCreator<int> creator(nnodes);
+    for ( ; !creator.Done(); creator++)
+      ParallelForRange (el2node.Size(), [&] (IntRange r)
+        {
+          for (auto i : r)
+            for (int n : el2node[i])
+              creator.Add (n, i);
+        });
+    Table<int> node2el = creator.MoveTable();
+
+    Array<int> cnt(nnodes);
+    auto neighbours = [&] (size_t i, Array<int> & nbs)
+      {
+        nbs.SetSize0();
+        for (int el : node2el[i])
+          for (int n : el2node[el])
+            if (n != int(i)) nbs.Append (n);
+        QuickSort (nbs);
+        size_t k = 0;
+        for (size_t j = 0; j < nbs.Size(); j++)
+          if (j == 0 || nbs[j] != nbs[j-1])
+            nbs[k++] = nbs[j];
+        nbs.SetSize (k);
+      };
+
+    ParallelForRange (nnodes, [&] (IntRange r)
+      {
+        Array<int> nbs;
+        for (auto i : r)
+          {
+            neighbours (i, nbs);
+            cnt[i] = nbs.Size();
+          }
+      });
+
+    Table<int> graph(cnt);
+    ParallelForRange (nnodes, [&] (IntRange r)
+      {
+        Array<int> nbs;
+        for (auto i : r)
+          {
+            neighbours (i, nbs);
+            graph[i] = nbs;
+          }
+      });
+    return graph;
+  }
+
+
+  Array<int> ElementLocalityOrder (const MeshAccess & ma, VorB vb, const string & method)
+  {
+    size_t ne = ma.GetNE(vb);
+
+    if (method == "rcm")
+      {
+        TableCreator<int> creator(ne);
+        for ( ; !creator.Done(); creator++)
+          for (size_t i = 0; i < ne; i++)
+            for (auto v : ma.GetElVertices (ElementId(vb, i)))
+              creator.Add (i, v);
+        Table<int> el2vert = creator.MoveTable();
+
+        // elements are nodes of the element graph, vertices are its 'elements'
+        TableCreator<int> creator2(ma.GetNV());
+        for ( ; !creator2.Done(); creator2++)
+          for (size_t i = 0; i < ne; i++)
+            for (auto v : el2vert[i])
+              creator2.Add (v, i);
+        return ReverseCuthillMcKee (NodeGraph (creator2.MoveTable(), ne));
+      }
+
+    if (method == "hilbert" || method == "morton")
+      {
+        Array<Vec<3>> centroids(ne);
+        ParallelForRange (ne, [&] (IntRange r)
+          {
+            for (auto i : r)
+              {
+                auto vnums = ma.GetElVertices (ElementId(vb, i));
+                Vec<3> c = 0;
+                for (auto v : vnums)
+                  c += ma.GetPoint<3> (v);
+                centroids[i] = 1.0/vnums.Size() * c;
+              }
+          });
+        return SpaceFillingCurveOrder (centroids, method == "hilbert");
+      }
+
+    throw Exception ("ElementLocalityOrder: unknown method '" + method +
+                     "', use 'rcm', 'hilbert' or 'morton'");
+  }
+
+
+  INT<2,size_t> BandwidthProfile (const Table<int> & el2dof, FlatArray<int> dofmap)
+  {
+    auto map = [&] (int d) { return dofmap.Size() ? dofmap[d] : d; };
+
+    // smallest dof coupling with every dof
+    size_t ndof = 0;
+    for (auto dofs : el2dof)
+      for (int d : dofs)
+        ndof = max2 (ndof, size_t(map(d)+1));
+    Array<int> minnb(ndof);
+    for (size_t i = 0; i < ndof; i++)
+      minnb[i] = i;
+
+    for (auto dofs : el2dof)
+      {
+        if (!dofs.Size()) continue;
+        int m = map(dofs[0]);
+        for (int d : dofs)
+          m = min2 (m, map(d));
+        for (int d : dofs)
+          minnb[map(d)] = min2 (minnb[map(d)], m);
+      }
+
+    size_t bandwidth = 0, profile = 0;
+    for (size_t i = 0; i < ndof; i++)
+      {
+        bandwidth = max2 (bandwidth, i-minnb[i]);
+        profile += i-minnb[i];
+      }
+    return INT<2,size_t> (bandwidth, profile);
+  }
+
+}
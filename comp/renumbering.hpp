@@ -0,0 +1,41 @@
+#ifndef FILE_RENUMBERING
+#define FILE_RENUMBERING
+
+/*********************************************************************/
+/* File:   renumbering.hpp                                           */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+namespace ngcomp
+{
+
+  /*
+    Locality optimizing orderings of elements and dofs.
+    All orderings are returned as new-to-old maps, i.e. order[i] is
+    the old number of the i-th item.
+   */
+
+  /// reverse Cuthill-McKee ordering of a symmetric graph, one component after the other
+  NGS_DLL_HEADER Array<int> ReverseCuthillMcKee (const Table<int> & graph);
+
+  /// order of points along a Hilbert curve, or a Morton (z-order) curve
+  NGS_DLL_HEADER Array<int> SpaceFillingCurveOrder (FlatArray<Vec<3>> points,
+                                                    bool hilbert = true);
+
+  /// nodes coupled by a common element, for the element-node table el2node
+  NGS_DLL_HEADER Table<int> NodeGraph (const Table<int> & el2node, size_t nnodes);
+
+  /// element order by method "rcm" (via common vertices), "hilbert" or "morton" (centroids)
+  NGS_DLL_HEADER Array<int> ElementLocalityOrder (const MeshAccess & ma, VorB vb,
+                                                  const string & method);
+
+  /**
+     Bandwidth and profile (envelope) of the matrix coupling the dofs of
+     every element. dofmap maps old to new numbers, an empty map is the
+     identity.
+   */
+  NGS_DLL_HEADER INT<2,size_t> BandwidthProfile (const Table<int> & el2dof,
+                                                 FlatArray<int> dofmap);
+}
+
+#endif
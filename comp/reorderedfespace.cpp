@@ -18,6 +18,12 @@ namespace ngcomp {
     integrator[VOL] = space->GetIntegrator(VOL);
     
     iscomplex = space->IsComplex();
+
+    if (flags.StringFlagDefined("reorder"))
+      method = flags.GetStringFlag("reorder");
+    if (method != "nodes" && method != "rcm" && method != "hilbert" && method != "morton")
+      throw Exception ("ReorderedFESpace: unknown reorder method '" + method +
+                       "', use 'nodes', 'rcm', 'hilbert' or 'morton'");
     /*
       // not yet implemented ...
       if (space->LowOrderFESpacePtr() && false)
@@ -37,17 +43,63 @@ namespace ngcomp {
     SetNDof(space->GetNDof());
     size_t ndof = space->GetNDof();
     dofmap.SetSize(ndof);
-    dofmap = UNUSED_DOF;
+    dofmap = -1;
+
+    // dofs of volume and boundary elements of the base space
+    size_t neV = ma->GetNE(VOL);
+    TableCreator<int> creator(neV + ma->GetNE(BND));
+    for ( ; !creator.Done(); creator++)
+      for (VorB vb : { VOL, BND })
+        ParallelForRange
+          (ma->GetNE(vb), [&] (IntRange r)
+           {
+             Array<DofId> dofs;
+             for (auto i : r)
+               {
+                 ElementId ei(vb, i);
+                 if (!space->DefinedOn(ei)) continue;
+                 space->GetDofNrs (ei, dofs);
+                 for (auto d : dofs)
+                   if (IsRegularDof(d)) creator.Add ((vb == VOL ? 0 : neV) + i, d);
+               }
+           });
+    Table<int> el2dof = creator.MoveTable();
 
-    Array<DofId> dofs;
     size_t cnt = 0;
-    for (auto nt : { NT_VERTEX, NT_EDGE, NT_FACE, NT_CELL })
-      for (auto nr : Range(ma->GetNNodes(nt)))
-        {
-          space->GetDofNrs (NodeId(nt, nr), dofs);
-          for (auto d : dofs)
-            dofmap[d] = cnt++;
-        }
+    if (method == "rcm")
+      {
+        for (auto d : ReverseCuthillMcKee (NodeGraph (el2dof, ndof)))
+          dofmap[d] = cnt++;
+      }
+    else if (method == "hilbert" || method == "morton")
+      {
+        // dofs in order of first appearance along the curve
+        for (VorB vb : { VOL, BND })
+          for (auto el : ElementLocalityOrder (*ma, vb, method))
+            for (auto d : el2dof[(vb == VOL ? 0 : neV) + el])
+              if (dofmap[d] == -1)
+                dofmap[d] = cnt++;
+      }
+    else
+      {
+        Array<DofId> dofs;
+        for (auto nt : { NT_VERTEX, NT_EDGE, NT_FACE, NT_CELL })
+          for (auto nr : Range(ma->GetNNodes(nt)))
+            {
+              space->GetDofNrs (NodeId(nt, nr), dofs);
+              for (auto d : dofs)
+                dofmap[d] = cnt++;
+            }
+      }
+    // dofs not reached keep their relative order at the end
+    for (auto & d : dofmap)
+      if (d == -1) d = cnt++;
+
+    bwprofile_before = BandwidthProfile (el2dof, FlatArray<int>());
+    bwprofile_after = BandwidthProfile (el2dof, dofmap);
+    cout << IM(3) << "Reordered (" << method << "): bandwidth "
+         << bwprofile_before[0] << " -> " << bwprofile_after[0]
+         << ", profile " << bwprofile_before[1] << " -> " << bwprofile_after[1] << endl;
     
     ctofdof.SetSize(ndof);
     for (auto i : Range(ndof))
@@ -17,6 +17,10 @@ namespace ngcomp
   protected:
     Array<DofId> dofmap;
     shared_ptr<FESpace> space;
+    /// "nodes" (node type by node type), "rcm", "hilbert" or "morton"
+    string method = "nodes";
+    /// bandwidth and profile before and after reordering
+    INT<2,size_t> bwprofile_before = { 0, 0 }, bwprofile_after = { 0, 0 };
     
   public:
     ReorderedFESpace (shared_ptr<FESpace> space, const Flags & flags);
@@ -29,6 +33,9 @@ namespace ngcomp
 
     virtual string GetClassName() const override { return "Reordered" + space->GetClassName(); }
     shared_ptr<FESpace> GetBaseSpace() const { return space; }
+    const string & GetMethod() const { return method; }
+    INT<2,size_t> GetBandwidthProfile (bool reordered = true) const
+    { return reordered ? bwprofile_after : bwprofile_before; }
     
     virtual FiniteElement & GetFE (ElementId ei, Allocator & alloc) const override;
 
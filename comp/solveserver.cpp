@@ -0,0 +1,417 @@
+/*********************************************************************/
+/* File:   solveserver.cpp                                           */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+#include <comp.hpp>
+
+#ifndef WIN32
+
+namespace ngcomp
+{
+
+  SolveServer :: SolveServer (size_t heapsize)
+    : lh(heapsize, "SolveServer")
+  { ; }
+
+  SolveServer :: ~SolveServer ()
+  {
+    Stop();
+  }
+
+
+  void SolveServer :: AddSystem (string name, shared_ptr<BilinearForm> bfa,
+                                 shared_ptr<BitArray> freedofs,
+                                 string inversetype)
+  {
+    if (bfa->GetFESpace()->IsComplex())
+      throw Exception ("SolveServer: complex system '" + name + "' not supported");
+
+    auto sys = make_shared<System>();
+    sys->bfa = bfa;
+    sys->freedofs = freedofs ? freedofs
+      : bfa->GetFESpace()->GetFreeDofs (bfa->UsesEliminateInternal());
+    sys->inversetype = inversetype;
+    // an already assembled matrix is used as it is
+    sys->assembled = bfa->GetMatrixPtr() != nullptr;
+    lock_guard<mutex> guard(systems_mutex);
+    systems.Set (name, sys);
+  }
+
+  void SolveServer :: AddParameter (string name, shared_ptr<ParameterCoefficientFunction> par)
+  {
+    lock_guard<mutex> guard(systems_mutex);
+    parameters.Set (name, par);
+  }
+
+  const SolveServer::System & SolveServer :: GetSystem (const string & name) const
+  {
+    auto sys = FindSystem (name);
+    if (!sys)
+      throw Exception ("SolveServer: no system '" + name + "'");
+    return *sys;
+  }
+
+  shared_ptr<SolveServer::System> SolveServer :: FindSystem (const string & name) const
+  {
+    lock_guard<mutex> guard(systems_mutex);
+    return systems.Used (name) ? systems[name] : nullptr;
+  }
+
+
+  void SolveServer :: Serve (const string & path)
+  {
+    Run (make_shared<ServerSocket> (path));
+    ::unlink (path.c_str());
+  }
+
+  void SolveServer :: Serve (int port)
+  {
+    Run (make_shared<ServerSocket> (port, true));
+  }
+
+  void SolveServer :: Stop ()
+  {
+    {
+      lock_guard<mutex> guard(queue_mutex);
+      running = false;
+    }
+    queue_cv.notify_all();
+  }
+
+
+  void SolveServer :: Run (shared_ptr<ServerSocket> asocket)
+  {
+    server = asocket;
+    running = true;
+    listener = std::thread ([this] () { Listen(); });
+
+    while (true)
+      {
+        Array<shared_ptr<Request>> requests;
+        {
+          unique_lock<mutex> lock(queue_mutex);
+          queue_cv.wait (lock, [this] () { return queue.Size() || !running; });
+          if (!queue.Size()) break;
+          if (batch_wait > 0)
+            queue_cv.wait_for (lock, std::chrono::duration<double> (batch_wait),
+                               [this] () { return !running; });
+          Swap (requests, queue);
+        }
+        batches++;
+        Process (requests);
+      }
+
+    server->shutdown();
+    listener.join();
+    {
+      lock_guard<mutex> guard(connections_mutex);
+      for (auto & sock : connections)
+        sock->shutdown();
+    }
+    for (auto & t : connection_threads)
+      t.join();
+    connection_threads.clear();
+    connections.SetSize0();
+    server = nullptr;
+  }
+
+
+  void SolveServer :: Listen ()
+  {
+    while (running)
+      {
+        auto sock = make_shared<ServerSocket>();
+        try
+          {
+            server->accept (*sock);
+          }
+        catch (SocketException &)
+          {
+            break;
+          }
+        if (!running || !sock->is_valid()) break;
+
+        lock_guard<mutex> guard(connections_mutex);
+        connections.Append (sock);
+        connection_threads.emplace_back ([this, sock] () { HandleConnection (sock); });
+      }
+  }
+
+
+  void SolveServer :: Enqueue (shared_ptr<Request> req)
+  {
+    {
+      lock_guard<mutex> guard(queue_mutex);
+      if (!running)
+        {
+          req->result.set_value ("SolveServer: server stopped");
+          return;
+        }
+      queue.Append (req);
+    }
+    queue_cv.notify_one();
+  }
+
+
+  void SolveServer :: HandleConnection (shared_ptr<ServerSocket> sock)
+  {
+    try
+      {
+        while (running)
+          {
+            string command;
+            sock->recv (command);
+            if (command == "") break;
+
+            try
+              {
+                if (!HandleRequest (*sock, command))
+                  break;
+              }
+            catch (SocketException &) { throw; }
+            catch (std::exception & e)
+              {
+                sock->send (string("SolveServer: ") + e.what());
+              }
+          }
+      }
+    catch (SocketException &) { ; }
+  }
+
+
+  bool SolveServer :: HandleRequest (ServerSocket & sock, const string & command)
+  {
+    auto req = make_shared<Request>();
+    req->command = command;
+
+    if (command == "list")
+      {
+        stringstream str;
+        {
+          lock_guard<mutex> guard(systems_mutex);
+          for (size_t i = 0; i < systems.Size(); i++)
+            str << systems.GetName(i) << " " << systems[i]->bfa->GetFESpace()->GetNDof() << "\n";
+        }
+        sock.send ("ok");
+        sock.send (str.str());
+        return true;
+      }
+    else if (command == "solve")
+      {
+        int64_t nrhs, ndof;
+        sock.recv (req->name);
+        sock.Trecv (nrhs);
+        sock.Trecv (ndof);
+
+        // the vectors are not read on errors, the connection can't be continued
+        auto sys = FindSystem (req->name);
+        if (!sys)
+          {
+            sock.send ("SolveServer: no system '" + req->name + "'");
+            return false;
+          }
+        int64_t sysndof = sys->bfa->GetFESpace()->GetNDof();
+        if (ndof != sysndof)
+          {
+            sock.send ("SolveServer: expected vectors of size " + ToString(sysndof)
+                       + ", got " + ToString(ndof));
+            return false;
+          }
+        if (nrhs < 0 || size_t(nrhs) > max_rhs)
+          {
+            sock.send ("SolveServer: number of right hand sides " + ToString(nrhs)
+                       + " not in [0, " + ToString(max_rhs) + "]");
+            return false;
+          }
+        req->nrhs = nrhs;
+        req->ndof = ndof;
+        req->data.SetSize (nrhs*ndof);
+        sock.recv_bytes (req->data.Data(), req->data.Size()*sizeof(double));
+      }
+    else if (command == "set")
+      {
+        sock.recv (req->name);
+        sock.Trecv (req->value);
+      }
+    else if (command != "shutdown")
+      {
+        sock.send ("SolveServer: unknown command '" + command + "'");
+        return true;
+      }
+
+    auto result = req->result.get_future();
+    Enqueue (req);
+    string msg = result.get();
+    sock.send (msg == "" ? string("ok") : msg);
+    if (msg == "" && command == "solve")
+      sock.send_bytes (req->data.Data(), req->data.Size()*sizeof(double));
+    return true;
+  }
+
+
+  void SolveServer :: Process (FlatArray<shared_ptr<Request>> requests)
+  {
+    static Timer t("SolveServer::Process");
+    RegionTimer reg(t);
+
+    size_t i = 0;
+    while (i < requests.Size())
+      {
+        auto & req = requests[i];
+        if (req->command == "solve")
+          {
+            // solves up to the next parameter update, grouped by system
+            size_t j = i;
+            while (j < requests.Size() && requests[j]->command == "solve")
+              j++;
+
+            Array<bool> done(j-i);
+            done = false;
+            for (size_t k = i; k < j; k++)
+              {
+                if (done[k-i]) continue;
+                string name = requests[k]->name;
+                Array<shared_ptr<Request>> group;
+                for (size_t l = k; l < j; l++)
+                  if (!done[l-i] && requests[l]->name == name)
+                    {
+                      group.Append (requests[l]);
+                      done[l-i] = true;
+                    }
+
+                try
+                  {
+                    auto sys = FindSystem (name);
+                    if (!sys)
+                      throw Exception ("SolveServer: no system '" + name + "'");
+                    Solve (*sys, group);
+                  }
+                catch (std::exception & e)
+                  {
+                    for (auto & r : group)
+                      r->result.set_value (e.what());
+                  }
+              }
+            i = j;
+            continue;
+          }
+
+        if (req->command == "set")
+          {
+            lock_guard<mutex> guard(systems_mutex);
+            if (parameters.Used (req->name))
+              {
+                parameters[req->name]->SetValue (req->value);
+                for (size_t k = 0; k < systems.Size(); k++)
+                  systems[k]->assembled = systems[k]->uptodate = false;
+                req->result.set_value ("");
+              }
+            else
+              req->result.set_value ("SolveServer: no parameter '" + req->name + "'");
+          }
+        else if (req->command == "shutdown")
+          {
+            running = false;
+            req->result.set_value ("");
+          }
+        i++;
+      }
+  }
+
+
+  void SolveServer :: Prepare (System & sys)
+  {
+    if (sys.uptodate) return;
+    static Timer t("SolveServer::Prepare");
+    RegionTimer reg(t);
+
+    auto & bfa = *sys.bfa;
+    if (!sys.assembled)
+      {
+        // keeps matrix graph and sparse matrix
+        bfa.ReAssemble (lh, false);
+        lh.CleanUp();
+        sys.assembled = true;
+      }
+
+    auto fact = dynamic_pointer_cast<SparseFactorization> (sys.inverse);
+    if (fact && fact->SupportsUpdate() && fact->GetAMatrix() == bfa.GetMatrixPtr())
+      fact->Update();
+    else
+      {
+        if (sys.inversetype != "")
+          bfa.GetMatrix().SetInverseType (sys.inversetype);
+        sys.inverse = bfa.GetMatrix().InverseMatrix (sys.freedofs);
+      }
+    sys.factorizations++;
+    sys.uptodate = true;
+  }
+
+
+  void SolveServer :: Solve (System & sys, FlatArray<shared_ptr<Request>> requests)
+  {
+    static Timer t("SolveServer::Solve");
+    RegionTimer reg(t);
+
+    Prepare (sys);
+    auto & bfa = *sys.bfa;
+    size_t ndof = bfa.GetFESpace()->GetNDof();
+
+    // all right hand sides, solutions replace them
+    Array<FlatVector<double>> rhs;
+    Array<shared_ptr<Request>> valid;
+    for (auto & req : requests)
+      if (req->ndof != ndof)
+        req->result.set_value ("SolveServer: expected vectors of size " + ToString(ndof)
+                               + ", got " + ToString(req->ndof));
+      else
+        {
+          valid.Append (req);
+          for (size_t i = 0; i < req->nrhs; i++)
+            rhs.Append (FlatVector<double> (ndof, &req->data[i*ndof]));
+        }
+
+    bool condense = bfa.UsesEliminateInternal();
+    auto solve = [&] (FlatVector<double> fu, BaseVector & f, BaseVector & u)
+      {
+        f.FVDouble() = fu;
+        if (condense)
+          {
+            f += *bfa.GetHarmonicExtensionTrans() * f;
+            u = *sys.inverse * f;
+            u += *bfa.GetHarmonicExtension() * u;
+            u += *bfa.GetInnerSolve() * f;
+          }
+        else
+          u = *sys.inverse * f;
+        fu = u.FVDouble();
+      };
+
+    // concurrent solves with one factorization, each solve runs sequentially
+    bool parallel = !condense && rhs.Size() > 1 &&
+      dynamic_pointer_cast<SparseCholeskyTM<double>> (sys.inverse);
+    if (parallel)
+      ParallelForRange (rhs.Size(), [&] (IntRange r)
+        {
+          auto f = bfa.GetMatrix().CreateColVector();
+          auto u = bfa.GetMatrix().CreateColVector();
+          for (auto i : r)
+            solve (rhs[i], f, u);
+        });
+    else
+      {
+        auto f = bfa.GetMatrix().CreateColVector();
+        auto u = bfa.GetMatrix().CreateColVector();
+        for (auto fu : rhs)
+          solve (fu, f, u);
+      }
+
+    sys.solves += rhs.Size();
+    for (auto & req : valid)
+      req->result.set_value ("");
+  }
+
+}
+
+#endif // WIN32
@@ -0,0 +1,131 @@
+#ifndef FILE_SOLVESERVER
+#define FILE_SOLVESERVER
+
+/*********************************************************************/
+/* File:   solveserver.hpp                                           */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+#ifndef WIN32
+
+#include <future>
+
+namespace ngcomp
+{
+
+  /**
+     Keeps assembled systems and their inverses resident, and solves for
+     right hand sides sent by clients over a unix domain socket or a
+     local TCP port.
+
+     Protocol: strings are sent by Socket::send, sizes as int64 and
+     vectors as doubles, the reply starts with "ok" or an error message:
+
+       "list"                               ->  "ok", one line "name ndof" per system
+       "solve", name, nrhs, ndof, f         ->  "ok", u   (nrhs x ndof values)
+                                                the connection is closed if name,
+                                                ndof or nrhs are not valid
+       "set", parameter name, value         ->  "ok"
+       "shutdown"                           ->  "ok", Serve returns
+
+     The solution is u = A^{-1} f on the free dofs, with static
+     condensation if the bilinear form eliminates internal dofs.
+
+     Requests of all connections are queued. Serve processes all pending
+     requests at once, and solves the right hand sides for the same
+     system together, in parallel for the sparse Cholesky factorization.
+     Parameter updates mark all systems for re-assembling, which happens
+     at the next solve, refactoring numerically where possible.
+  */
+  class NGS_DLL_HEADER SolveServer
+  {
+  public:
+    struct System
+    {
+      shared_ptr<BilinearForm> bfa;
+      shared_ptr<BitArray> freedofs;
+      string inversetype;
+      shared_ptr<BaseMatrix> inverse;
+      /// matrix assembled with the current parameters
+      bool assembled = false;
+      /// inverse of the current matrix
+      bool uptodate = false;
+      size_t solves = 0;
+      size_t factorizations = 0;
+    };
+
+  protected:
+    struct Request
+    {
+      string command, name;
+      size_t nrhs = 0, ndof = 0;
+      Array<double> data;
+      double value = 0;
+      /// error message, empty on success
+      std::promise<string> result;
+    };
+
+    /// systems and parameters are read by the connection threads
+    mutable mutex systems_mutex;
+    SymbolTable<shared_ptr<System>> systems;
+    SymbolTable<shared_ptr<ParameterCoefficientFunction>> parameters;
+    LocalHeap lh;
+
+    mutex queue_mutex;
+    condition_variable queue_cv;
+    Array<shared_ptr<Request>> queue;
+    /// after the first request, wait for more requests to batch them
+    double batch_wait = 0;
+    atomic<size_t> batches{0};
+    /// maximal number of right hand sides of one request
+    size_t max_rhs = 1024;
+
+    atomic<bool> running{false};
+    shared_ptr<ServerSocket> server;
+    std::thread listener;
+    mutex connections_mutex;
+    Array<shared_ptr<ServerSocket>> connections;
+    std::vector<std::thread> connection_threads;
+
+  public:
+    SolveServer (size_t heapsize = 10000000);
+    ~SolveServer ();
+
+    void AddSystem (string name, shared_ptr<BilinearForm> bfa,
+                    shared_ptr<BitArray> freedofs = nullptr,
+                    string inversetype = "");
+    void AddParameter (string name, shared_ptr<ParameterCoefficientFunction> par);
+    void SetBatchWait (double seconds) { batch_wait = seconds; }
+    double GetBatchWait () const { return batch_wait; }
+    void SetMaxRHS (size_t n) { max_rhs = n; }
+    size_t GetMaxRHS () const { return max_rhs; }
+
+    const System & GetSystem (const string & name) const;
+    size_t GetNumBatches () const { return batches; }
+
+    /// serves on a unix domain socket until shutdown
+    void Serve (const string & path);
+    /// serves on a TCP port, accepting local connections only
+    void Serve (int port);
+    /// Serve returns after all queued requests are processed
+    void Stop ();
+
+  protected:
+    void Run (shared_ptr<ServerSocket> asocket);
+    void Listen ();
+    void HandleConnection (shared_ptr<ServerSocket> sock);
+    /// returns false if the connection has to be closed
+    bool HandleRequest (ServerSocket & sock, const string & command);
+    shared_ptr<System> FindSystem (const string & name) const;
+    void Enqueue (shared_ptr<Request> req);
+
+    void Process (FlatArray<shared_ptr<Request>> requests);
+    void Prepare (System & sys);
+    void Solve (System & sys, FlatArray<shared_ptr<Request>> requests);
+  };
+
+}
+
+#endif // WIN32
+
+#endif
@@ -3,6 +3,11 @@
 #include<l2hofe_impl.hpp>
 #include<l2hofefo.hpp>
 #include<regex>
+#ifdef WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
 
 namespace ngfem
 {
@@ -24,6 +29,8 @@ namespace ngfem
 #endif
         s_ptr << std::hex << p;
         pointer += "void *" + name + " = reinterpret_cast<void*>(" + s_ptr.str() + ");\n";
+        pointer_values.push_back(p);
+        pointer_names.push_back(name);
         return name;
     }
 
@@ -79,6 +86,98 @@ namespace ngfem
       return library;
     }
 
+    string CompiledCodeABI()
+    {
+      stringstream s;
+      s << "ngsolve " << ngsolve_version;
+#if defined(__VERSION__)
+      s << ", compiler " << __VERSION__;
+#elif defined(_MSC_VER)
+      s << ", msvc " << _MSC_VER;
+#endif
+      s << ", simd " << SIMD<double>::Size()
+        << ", pointer " << sizeof(void*);
+      return s.str();
+    }
+
+    string CodeHash(const std::vector<string> &codes)
+    {
+      // FNV-1a, pointer names are replaced by their order of appearance
+      uint64_t hash = 14695981039346656037ull;
+      auto add = [&hash] (const string & str)
+        {
+          for (unsigned char c : str)
+            {
+              hash ^= c;
+              hash *= 1099511628211ull;
+            }
+        };
+      
+      const string prefix = "compiled_code_pointer";
+      std::map<string,int> numbers;
+      for (const string & code : codes)
+        {
+          size_t pos = 0;
+          while (true)
+            {
+              size_t next = code.find(prefix, pos);
+              add (code.substr(pos, next-pos));
+              if (next == string::npos) break;
+              size_t end = next + prefix.size();
+              while (end < code.size() && isdigit(code[end])) end++;
+              string name = code.substr(next, end-next);
+              if (numbers.count(name) == 0)
+                {
+                  int nr = numbers.size();
+                  numbers[name] = nr;
+                }
+              add (prefix + "#" + ToString(numbers[name]));
+              pos = end;
+            }
+          add ("\n// next code\n");
+        }
+      stringstream s;
+      s << std::hex << setw(16) << setfill('0') << hash;
+      return s.str();
+    }
+
+    string ReadLibraryBinary(const SharedLibrary & library)
+    {
+      ifstream file(library.GetLibraryName(), ios::binary);
+      if (!file)
+        throw Exception ("cannot read library " + library.GetLibraryName());
+      stringstream s;
+      s << file.rdbuf();
+      return s.str();
+    }
+
+    unique_ptr<SharedLibrary> LoadLibraryBinary(const string & binary, const string & hash)
+    {
+      static atomic<int> counter{0};
+      // the process id keeps workers sharing a directory apart
+#ifdef WIN32
+      string name = "precompiled_" + hash + "_" + ToString(_getpid()) + "_" + ToString(counter++) + ".dll";
+#else
+      string name = "precompiled_" + hash + "_" + ToString(getpid()) + "_" + ToString(counter++) + ".so";
+#endif
+      {
+        ofstream file(name, ios::binary);
+        file.write(binary.data(), binary.size());
+        if (!file)
+          throw Exception ("cannot write library " + name);
+      }
+      auto library = make_unique<SharedLibrary>();
+#ifdef WIN32
+      library->Load(name);
+#else
+      char *temp = getcwd(nullptr, 0);
+      string cwd(temp);
+      free(temp);
+      library->Load(cwd+"/"+name);
+#endif
+      return library;
+    }
+
     namespace detail {
         // T_CalcShape is protected, thus we have to derive
         template <ELEMENT_TYPE ET, typename BASE>
@@ -48,6 +48,9 @@ namespace ngfem
     std::vector<string> link_flags;
 
     string pointer;
+    // pointers in the order of AddPointer calls
+    std::vector<const void*> pointer_values;
+    std::vector<string> pointer_names;
 
     string AddPointer(const void *p );
 
@@ -178,6 +181,15 @@ namespace ngfem
   }
 
   unique_ptr<SharedLibrary> CompileCode(const std::vector<string> &codes, const std::vector<string> &libraries );
+
+  // compiler, version and simd-width the library was built with
+  string CompiledCodeABI();
+  // hash of generated code, independent of the numbering of pointer names
+  string CodeHash(const std::vector<string> &codes);
+  // the compiled library as a byte string, to be stored in archives
+  string ReadLibraryBinary(const SharedLibrary & library);
+  // writes a library stored by ReadLibraryBinary to a file and loads it
+  unique_ptr<SharedLibrary> LoadLibraryBinary(const string & binary, const string & hash);
   namespace detail {
       string GenerateL2ElementCode(int order);
   }
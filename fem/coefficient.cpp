@@ -11,6 +11,9 @@
 #include <fem.hpp>
 #include <../ngstd/evalfunc.hpp>
 #include <algorithm>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
 #ifdef NGS_PYTHON
 #include <core/python_ngcore.hpp> // for shallow archive
 #endif // NGS_PYTHON
@@ -295,7 +298,9 @@ namespace ngfem
   ConstantCoefficientFunctionC ::   
   ConstantCoefficientFunctionC (Complex aval) 
     : CoefficientFunction(1, true), val(aval) 
-  { ; }
+  {
+    elementwise_constant = true;
+  }
 
   ConstantCoefficientFunctionC ::
   ~ConstantCoefficientFunctionC ()
@@ -373,7 +378,10 @@ namespace ngfem
   
   DomainConstantCoefficientFunction :: 
   DomainConstantCoefficientFunction (const Array<double> & aval)
-    : BASE(1, false), val(aval) { ; }
+    : BASE(1, false), val(aval)
+  {
+    elementwise_constant = true;
+  }
   
   double DomainConstantCoefficientFunction :: Evaluate (const BaseMappedIntegrationPoint & ip) const
   {
@@ -685,6 +693,32 @@ Evaluate (const BaseMappedIntegrationRule & ir,
     }
 }
 
+
+void DomainVariableCoefficientFunction ::
+Evaluate (const SIMD_BaseMappedIntegrationRule & ir, 
+          BareSliceMatrix<SIMD<double>> values) const
+{
+  if (ir.Size() == 0) return;
+  int elind = ir.GetTransformation().GetElementIndex();
+  if (fun.Size() == 1) elind = 0;
+  if (fun[elind]->IsComplex() || !fun[elind]->IsVectorizable())
+    throw ExceptionNOSIMD ("DomainVariableCoefficientFunction: EvalFunction not vectorizable");
+
+  STACK_ARRAY(SIMD<double>, hmem, numarg*ir.Size());
+  FlatMatrix<SIMD<double>> args(numarg, ir.Size(), &hmem[0]);
+  args = SIMD<double>(0.0);
+  auto points = ir.GetPoints();
+  for (size_t i = 0; i < ir.Size(); i++)
+    for (int j = 0; j < ir.DimSpace(); j++)
+      args(j, i) = points(i, j);
+  for (int i = 0, an = 3; i < depends_on.Size(); i++)
+    {
+      int dim = depends_on[i]->Dimension();
+      depends_on[i] -> Evaluate (ir, args.Rows(an, an+dim));
+      an += dim;
+    }
+  fun[elind]->Eval (args.Data(), ir.Size(), values.Data(), values.Dist(), ir.Size());
+}
   
 void DomainVariableCoefficientFunction :: PrintReport (ostream & ost) const
 {
@@ -1027,10 +1061,9 @@ public:
 
   virtual void GenerateCode(Code &code, FlatArray<int> inputs, int index) const override
   {
-    FlatArray<int> hdims = Dimensions();        
-    for (int i : Range(hdims[0]))
-      for (int j : Range(hdims[1]))
-        code.body += Var(index,i,j).Assign(string("0.0"));
+    TraverseDimensions( Dimensions(), [&](int ind, int i, int j) {
+        code.body += Var(index,i,j).Declare(code.res_type, 0.0);
+      });
   }
 
   using T_CoefficientFunction<ZeroCoefficientFunction>::Evaluate;
@@ -4299,6 +4332,7 @@ public:
   virtual Array<shared_ptr<CoefficientFunction>> InputCoefficientFunctions() const override
   { return Array<shared_ptr<CoefficientFunction>>({ c1 }); }
 
+  int GetComponent () const { return comp; }
   
   using BASE::Evaluate;
   /*
@@ -5638,6 +5672,13 @@ class CompiledCoefficientFunction : public CoefficientFunction //, public std::e
     Array<int> dim;
     int totdim;
     Array<bool> is_complex;
+    // nodes created by the optimization
+    Array<shared_ptr<CoefficientFunction>> folded;
+    // number of nodes in the tree, before optimization
+    size_t num_nodes = 0;
+    // temporaries of the steps, at offset[i]*npoints in memory of tempdim*npoints
+    Array<size_t> offset;
+    size_t tempdim = 0;
     // Array<Timer*> timers;
     unique_ptr<SharedLibrary> library;
     lib_function compiled_function = nullptr;
@@ -5650,54 +5691,333 @@ class CompiledCoefficientFunction : public CoefficientFunction //, public std::e
     lib_function_complex compiled_function_complex = nullptr;
     lib_function_simd_complex compiled_function_simd_complex = nullptr;
 
+    // real compilation, stored in archives: -1 .. not compiled
+    int compiled_maxderiv = -1;
+    // hash of the generated code, identifies the compiled library
+    string code_hash;
+    // the compiled library, shipped with archives if requested
+    bool keep_library = false;
+    string library_binary;
+    // a compilation in the background writes the library, DoArchive waits for it
+    std::mutex compile_mutex;
+    std::condition_variable compile_done;
+    bool compiling = false;
+
   public:
     CompiledCoefficientFunction() = default;
     CompiledCoefficientFunction (shared_ptr<CoefficientFunction> acf)
       : CoefficientFunction(acf->Dimension(), acf->IsComplex()), cf(acf) // , compiled_function(nullptr), compiled_function_simd(nullptr)
     {
       SetDimensions (cf->Dimensions());
+      Init();
+    }
+
+  protected:
+    // structural key of a step: its generated code for the given inputs,
+    // with the generated pointer names replaced by the addresses
+    static string StepKey (const CoefficientFunction & step, FlatArray<int> inputs, int index)
+    {
+      Code code;
+      code.res_type = "double";
+      code.is_simd = false;
+      code.deriv = 0;
+      try
+        {
+          step.GenerateCode (code, inputs, index);
+        }
+      catch (Exception &)
+        {
+          return "";
+        }
+
+      std::map<string,string> addresses;
+      stringstream pointers(code.pointer);
+      string line;
+      while (getline (pointers, line))
+        {
+          // void *name = reinterpret_cast<void*>(address);
+          auto n0 = line.find('*')+1, n1 = line.find(" =");
+          auto a0 = line.rfind('(')+1, a1 = line.rfind(')');
+          if (n1 == string::npos || a1 == string::npos) return "";
+          addresses[line.substr(n0, n1-n0)] = line.substr(a0, a1-a0);
+        }
+
+      string text = code.header + code.body;
+      string key = string(typeid(step).name()) + " " + step.GetDescription()
+        + (step.IsComplex() ? " complex" : " real");
+      for (int d : step.Dimensions())
+        key += " " + ToString(d);
+      key += "\n";
+      string prefix = "compiled_code_pointer";
+      size_t pos = 0;
+      while (true)
+        {
+          size_t found = text.find (prefix, pos);
+          key += text.substr (pos, found-pos);
+          if (found == string::npos) break;
+          size_t end = found + prefix.size();
+          while (end < text.size() && isdigit(text[end])) end++;
+          string name = text.substr (found, end-found);
+          key += addresses.count(name) ? "pointer(" + addresses[name] + ")" : name;
+          pos = end;
+        }
+      return key;
+    }
+
+    // the nonzero-pattern describes the dependency on proxies, it bounds
+    // the values only for operations mapping zero inputs to zero
+    static bool PreservesZero (const CoefficientFunction & step)
+    {
+      if (dynamic_cast<const ComponentCoefficientFunction*> (&step) ||
+          dynamic_cast<const VectorialCoefficientFunction*> (&step))
+        return true;
+      string descr = step.GetDescription();
+      for (string op : { "binary operation '+'", "binary operation '-'", "binary operation '*'",
+            "matrix-matrix multiply", "matrix-vector multiply", "cross-product",
+            "Matrix transpose", "trace" })
+        if (descr == op) return true;
+      return descr.rfind ("scale ", 0) == 0 || descr.rfind ("innerproduct", 0) == 0;
+    }
+
+    /*
+      Places the temporaries of the steps in a pool of buffers: a buffer
+      is released after the last step using it, and taken by the next
+      step fitting into it (the smallest such buffer). The last step
+      writes into the result.
+     */
+    void AllocateTemporaries ()
+    {
+      Array<int> last_use(steps.Size());
+      for (size_t i = 0; i < steps.Size(); i++)
+        {
+          last_use[i] = i;
+          for (int j : inputs[i])
+            last_use[j] = i;
+        }
+
+      Array<size_t> buf_size;
+      Array<size_t> buf_offset;
+      Array<int> free_bufs;
+      Array<int> buf(steps.Size());
+      offset.SetSize (steps.Size());
+      tempdim = 0;
+      for (size_t i = 0; i+1 < steps.Size(); i++)
+        {
+          int best = -1;
+          for (int k : Range(free_bufs))
+            if (buf_size[free_bufs[k]] >= size_t(dim[i]) &&
+                (best == -1 || buf_size[free_bufs[k]] < buf_size[free_bufs[best]]))
+              best = k;
+          if (best != -1)
+            {
+              buf[i] = free_bufs[best];
+              free_bufs.DeleteElement (best);
+            }
+          else
+            {
+              buf[i] = buf_size.Size();
+              buf_size.Append (dim[i]);
+              buf_offset.Append (tempdim);
+              tempdim += dim[i];
+            }
+          offset[i] = buf_offset[buf[i]];
+
+          for (int j : inputs[i])
+            if (last_use[j] == int(i) && !free_bufs.Contains (buf[j]))
+              free_bufs.Append (buf[j]);
+        }
+      offset.Last() = 0;
+    }
+
+    /*
+      Flattens the tree into steps, and optimizes the step graph:
+      structurally equal nodes are evaluated once, scalar constant
+      expressions are folded, steps which are zero independent of trial-
+      and test-functions become ZeroCFs, components of vectorial CFs are
+      taken from their inputs, and steps not needed for the result are
+      dropped.
+     */
+    void Init ()
+    {
+      Array<CoefficientFunction*> nodes;
+      std::unordered_map<const CoefficientFunction*, int> node_nr;
       cf -> TraverseTree
         ([&] (CoefficientFunction & stepcf)
          {
-           if (!steps.Contains(&stepcf))
-             {
-               steps.Append (&stepcf);
-               // timers.Append (new Timer(string("CompiledCF")+typeid(stepcf).name()));
-               dim.Append (stepcf.Dimension());
-               is_complex.Append (stepcf.IsComplex());
-             }
+           if (node_nr.emplace (&stepcf, nodes.Size()).second)
+             nodes.Append (&stepcf);
          });
-      
+      num_nodes = nodes.Size();
+      size_t n = nodes.Size();
+
+      typedef AutoDiffDiff<1,bool> T;
+      Array<int> rep(n);                 // representative node
+      Array<Array<int>> node_inputs(n);  // inputs given by representatives
+      Array<bool> uses_proxy(n);         // nonzero-pattern depends on the integrator
+      Array<Array<T>> pattern(n);
+      std::unordered_map<string,int> keys;
+      ProxyUserData ud;
+      ArrayMem<FlatVector<T>,100> in;
+
+      auto is_const = [&] (int j)
+        { return dynamic_cast<ConstantCoefficientFunction*> (nodes[j]) != nullptr; };
+      auto replace = [&] (int i, shared_ptr<CoefficientFunction> newcf)
+        {
+          folded.Append (newcf);
+          nodes[i] = newcf.get();
+          node_inputs[i].SetSize0();
+          newcf -> NonZeroPattern (ud, FlatVector<T> (pattern[i].Size(), pattern[i].Data()));
+        };
+
+      for (size_t i = 0; i < n; i++)
+        {
+          rep[i] = i;
+          auto & node = *nodes[i];
+          for (auto incf : node.InputCoefficientFunctions())
+            node_inputs[i].Append (rep[node_nr[incf.get()]]);
+          auto & nin = node_inputs[i];
+
+          uses_proxy[i] = dynamic_cast<ProxyFunction*> (&node) || node.StoreUserData();
+          for (int j : nin)
+            uses_proxy[i] = uses_proxy[i] || uses_proxy[j];
+
+          // component of a vectorial CF
+          auto comp = dynamic_cast<ComponentCoefficientFunction*> (&node);
+          if (comp && i+1 < n && dynamic_cast<VectorialCoefficientFunction*> (nodes[nin[0]]))
+            {
+              int offset = 0;
+              for (int j : node_inputs[nin[0]])
+                {
+                  if (offset == comp->GetComponent() && nodes[j]->Dimension() == 1)
+                    rep[i] = j;
+                  offset += nodes[j]->Dimension();
+                }
+              if (rep[i] != int(i)) continue;
+            }
+
+          pattern[i].SetSize (node.Dimension());
+          FlatVector<T> pat (pattern[i].Size(), pattern[i].Data());
+          pat = T(true);
+          if (!uses_proxy[i] && nin.Size() == 0)
+            {
+              if (is_const(i) || node.GetDescription() == "ZeroCF")
+                node.NonZeroPattern (ud, pat);
+            }
+          else if (!uses_proxy[i] && PreservesZero (node))
+            {
+              bool sparse_input = false;
+              for (int j : nin)
+                for (auto pj : pattern[j])
+                  if (!pj.Value()) sparse_input = true;
+              if (sparse_input)
+                {
+                  in.SetSize (nin.Size());
+                  for (int k : Range(nin))
+                    new (&in[k]) FlatVector<T> (pattern[nin[k]].Size(), pattern[nin[k]].Data());
+                  node.NonZeroPattern (ud, in, pat);
+                }
+            }
+
+          if (!uses_proxy[i] && nin.Size() && !node.IsComplex())
+            {
+              bool const_input = true;
+              for (int j : nin)
+                if (!is_const(j)) const_input = false;
+
+              bool zero = PreservesZero (node);
+              for (auto p : pat)
+                if (p.Value()) zero = false;
+
+              if (const_input && node.Dimension() == 1)
+                {
+                  try
+                    {
+                      replace (i, make_shared<ConstantCoefficientFunction> (node.EvaluateConst()));
+                      zero = false;
+                    }
+                  catch (Exception &) { ; }
+                }
+              if (zero)
+                replace (i, ZeroCF (node.Dimensions()));
+            }
+
+          if (i+1 < n)
+            {
+              string key = StepKey (*nodes[i], node_inputs[i], n);
+              if (key != "")
+                {
+                  auto [pos, inserted] = keys.emplace (key, i);
+                  rep[i] = pos->second;
+                }
+            }
+        }
+
+      // steps needed for the result, inputs with larger memory need first
+      Array<size_t> need(n);
+      for (size_t i = 0; i < n; i++)
+        {
+          Array<int> sorted = node_inputs[i];
+          std::stable_sort (sorted.begin(), sorted.end(),
+                            [&] (int a, int b) { return need[a] > need[b]; });
+          size_t acc = 0, mem = nodes[i]->Dimension();
+          for (int j : sorted)
+            {
+              mem = max2(mem, acc + need[j]);
+              acc += nodes[j]->Dimension();
+            }
+          need[i] = max2(mem, acc + nodes[i]->Dimension());
+        }
+
+      Array<int> stepnr(n);
+      stepnr = -1;
+      steps.SetSize0();
+      Array<int> order;
+      std::function<void(int)> visit = [&] (int i)
+        {
+          Array<int> sorted = node_inputs[i];
+          std::stable_sort (sorted.begin(), sorted.end(),
+                            [&] (int a, int b) { return need[a] > need[b]; });
+          for (int j : sorted)
+            if (stepnr[j] == -1)
+              visit (j);
+          stepnr[i] = steps.Size();
+          steps.Append (nodes[i]);
+          order.Append (i);
+        };
+      visit (n-1);
+
+      dim.SetSize0();
+      is_complex.SetSize0();
+      for (auto step : steps)
+        {
+          dim.Append (step->Dimension());
+          is_complex.Append (step->IsComplex());
+        }
       totdim = 0;
       for (int d : dim) totdim += d;
-      
-      cout << IM(3) << "Compiled CF:" << endl;
-      for (auto cf : steps)
-        cout << IM(3) << typeid(*cf).name() << endl;
-      
+
       inputs = DynamicTable<int> (steps.Size());
       max_inputsize = 0;
-      
-      cf -> TraverseTree
-        ([&] (CoefficientFunction & stepcf)
-         {
-           int mypos = steps.Pos (&stepcf);
-           if (!inputs[mypos].Size())
-             {
-               Array<shared_ptr<CoefficientFunction>> in = stepcf.InputCoefficientFunctions();
-               max_inputsize = max2(in.Size(), max_inputsize);
-               for (auto incf : in)
-                 inputs.Add (mypos, steps.Pos(incf.get()));
-             }
-         });
-      cout << IM(3) << "inputs = " << endl << inputs << endl;
+      for (int i : order)
+        {
+          max_inputsize = max2(node_inputs[i].Size(), max_inputsize);
+          for (int j : node_inputs[i])
+            inputs.Add (stepnr[i], stepnr[j]);
+        }
+      AllocateTemporaries();
 
+      cout << IM(3) << "Compiled CF: " << num_nodes << " nodes, "
+           << steps.Size() << " steps after optimization" << endl;
+      for (auto cf : steps)
+        cout << IM(3) << typeid(*cf).name() << endl;
+      cout << IM(3) << "inputs = " << endl << inputs << endl;
     }
 
+  public:
 
   void PrintReport (ostream & ost) const override
   {
-    ost << "Compiled CF:" << endl;
+    ost << "Compiled CF, " << num_nodes << " nodes in " << steps.Size() << " steps:" << endl;
     for (int i : Range(steps))
       {
         auto & cf = steps[i];
@@ -5715,6 +6035,7 @@ class CompiledCoefficientFunction : public CoefficientFunction //, public std::e
             ost << endl;
           }
       }
+    ost << "temporaries: " << tempdim << " values per point, " << totdim << " without reuse" << endl;
     /*
     for (auto cf : steps)
       ost << cf -> GetDescription() << endl;
@@ -5743,36 +6064,17 @@ class CompiledCoefficientFunction : public CoefficientFunction //, public std::e
     {
       CoefficientFunction::DoArchive(ar);
       ar.Shallow(cf);
+      string abi = CompiledCodeABI();
+      {
+        std::unique_lock<std::mutex> lock(compile_mutex);
+        compile_done.wait (lock, [this] { return !compiling; });
+        ar & compiled_maxderiv & code_hash & abi & library_binary;
+      }
       if(ar.Input())
         {
-          cf -> TraverseTree
-            ([&] (CoefficientFunction & stepcf)
-             {
-               if (!steps.Contains(&stepcf))
-                 {
-                   steps.Append (&stepcf);
-                   // timers.Append (new Timer(string("CompiledCF")+typeid(stepcf).name()));
-                   dim.Append (stepcf.Dimension());
-                   is_complex.Append (stepcf.IsComplex());
-                 }
-             });
-          totdim = 0;
-          for (int d : dim) totdim += d;
-          inputs = DynamicTable<int> (steps.Size());
-          max_inputsize = 0;
-
-          cf -> TraverseTree
-            ([&] (CoefficientFunction & stepcf)
-             {
-               int mypos = steps.Pos (&stepcf);
-               if (!inputs[mypos].Size())
-                 {
-                   Array<shared_ptr<CoefficientFunction>> in = stepcf.InputCoefficientFunctions();
-                   max_inputsize = max2(in.Size(), max_inputsize);
-                   for (auto incf : in)
-                     inputs.Add (mypos, steps.Pos(incf.get()));
-                 }
-             });
+          Init();
+          if (compiled_maxderiv >= 0)
+            LoadOrCompile (abi);
         }
     }
 
@@ -5786,13 +6088,13 @@ class CompiledCoefficientFunction : public CoefficientFunction //, public std::e
 
     
     
-    void RealCompile(int maxderiv, bool wait)
+    // generates the code for all evaluation functions, the pointers used in the code
+    // are set by CompiledSetPointers after loading
+    void GenerateLibraryCode(int maxderiv, std::vector<string> & codes, std::vector<string> & link_flags,
+                             std::vector<const void*> & pointers) const
     {
-        std::vector<string> link_flags;
-        if(cf->IsComplex())
-            maxderiv = 0;
         stringstream s;
-        string pointer_code;
+        std::vector<string> pointer_names;
         string top_code = ""
              "#include<fem.hpp>\n"
              "using namespace ngfem;\n"
@@ -5822,7 +6124,8 @@ class CompiledCoefficientFunction : public CoefficientFunction //, public std::e
               step.GenerateCode(code, inputs[i],i);
             }
 
-            pointer_code += code.pointer;
+            pointer_names.insert(pointer_names.end(), code.pointer_names.begin(), code.pointer_names.end());
+            pointers.insert(pointers.end(), code.pointer_values.begin(), code.pointer_values.end());
             top_code += code.top;
 
             // set results
@@ -5901,47 +6204,150 @@ class CompiledCoefficientFunction : public CoefficientFunction //, public std::e
         }
         s << "}" << endl;
         string file_code = top_code + s.str();
-        std::vector<string> codes;
         codes.push_back(file_code);
-        if(pointer_code.size()) {
-          pointer_code = "extern \"C\" {\n" + pointer_code;
-          pointer_code += "}\n";
-          codes.push_back(pointer_code);
+
+        // no absolute addresses in the library, such that it can be loaded by other processes
+        stringstream pointer_code;
+        pointer_code << "extern \"C\" {\n";
+        for (auto & name : pointer_names)
+          pointer_code << "void *" << name << " = nullptr;\n";
+#ifdef WIN32
+        pointer_code << "__declspec(dllexport) ";
+#endif
+        pointer_code << "void CompiledSetPointers (void ** pointers) {\n";
+        for (auto i : Range(pointer_names.size()))
+          pointer_code << pointer_names[i] << " = pointers[" << i << "];\n";
+        pointer_code << "}\n}\n";
+        codes.push_back(pointer_code.str());
+    }
+
+    void LoadFunctions(int maxderiv, FlatArray<const void*> pointers)
+    {
+        auto set_pointers = library->GetFunction<void(*)(void**)>("CompiledSetPointers");
+        set_pointers (const_cast<void**>(pointers.Data()));
+        if(cf->IsComplex())
+        {
+            compiled_function_simd_complex = library->GetFunction<lib_function_simd_complex>("CompiledEvaluateSIMD");
+            compiled_function_complex = library->GetFunction<lib_function_complex>("CompiledEvaluate");
         }
+        else
+        {
+            compiled_function_simd = library->GetFunction<lib_function_simd>("CompiledEvaluateSIMD");
+            compiled_function = library->GetFunction<lib_function>("CompiledEvaluate");
+            if(maxderiv>0)
+            {
+                compiled_function_simd_deriv = library->GetFunction<lib_function_simd_deriv>("CompiledEvaluateDerivSIMD");
+                compiled_function_deriv = library->GetFunction<lib_function_deriv>("CompiledEvaluateDeriv");
+            }
+            if(maxderiv>1)
+            {
+                compiled_function_simd_dderiv = library->GetFunction<lib_function_simd_dderiv>("CompiledEvaluateDDerivSIMD");
+                compiled_function_dderiv = library->GetFunction<lib_function_dderiv>("CompiledEvaluateDDeriv");
+            }
+        }
+    }
+
+    void UnloadLibrary()
+    {
+        compiled_function = nullptr;
+        compiled_function_simd = nullptr;
+        compiled_function_deriv = nullptr;
+        compiled_function_simd_deriv = nullptr;
+        compiled_function_dderiv = nullptr;
+        compiled_function_simd_dderiv = nullptr;
+        compiled_function_complex = nullptr;
+        compiled_function_simd_complex = nullptr;
+        library = nullptr;
+    }
 
-        auto self = dynamic_pointer_cast<CompiledCoefficientFunction>(shared_from_this());
-        auto compile_func = [self, codes, link_flags, maxderiv] () {
-              self->library = CompileCode( codes, link_flags );
-              if(self->cf->IsComplex())
+    // after unarchiving: load the shipped library if it was compiled with the
+    // same abi from the same code, otherwise call the compiler
+    void LoadOrCompile(const string & stored_abi)
+    {
+        std::vector<string> codes, link_flags;
+        std::vector<const void*> pointers;
+        GenerateLibraryCode (compiled_maxderiv, codes, link_flags, pointers);
+        
+        if (library_binary.size() && stored_abi == CompiledCodeABI() &&
+            CodeHash(codes) == code_hash)
+          {
+            try
               {
-                  self->compiled_function_simd_complex = self->library->GetFunction<lib_function_simd_complex>("CompiledEvaluateSIMD");
-                  self->compiled_function_complex = self->library->GetFunction<lib_function_complex>("CompiledEvaluate");
+                library = LoadLibraryBinary (library_binary, code_hash);
+                LoadFunctions (compiled_maxderiv, FlatArray<const void*>(pointers.size(), pointers.data()));
+                keep_library = true;
+                cout << IM(5) << "loaded precompiled CoefficientFunction " << code_hash << endl;
+                return;
               }
-              else
+            catch (const std::exception & e)
               {
-                  self->compiled_function_simd = self->library->GetFunction<lib_function_simd>("CompiledEvaluateSIMD");
-                  self->compiled_function = self->library->GetFunction<lib_function>("CompiledEvaluate");
-                  if(maxderiv>0)
-                  {
-                      self->compiled_function_simd_deriv = self->library->GetFunction<lib_function_simd_deriv>("CompiledEvaluateDerivSIMD");
-                      self->compiled_function_deriv = self->library->GetFunction<lib_function_deriv>("CompiledEvaluateDeriv");
-                  }
-                  if(maxderiv>1)
-                  {
-                      self->compiled_function_simd_dderiv = self->library->GetFunction<lib_function_simd_dderiv>("CompiledEvaluateDDerivSIMD");
-                      self->compiled_function_dderiv = self->library->GetFunction<lib_function_dderiv>("CompiledEvaluateDDeriv");
-                  }
+                cout << IM(3) << "loading precompiled CoefficientFunction failed: " << e.what() << endl;
+                UnloadLibrary();
               }
+          }
+
+        cout << IM(3) << "precompiled CoefficientFunction not usable, compiling" << endl;
+        bool keep = library_binary.size() > 0;
+        library_binary.clear();
+        try
+          {
+            RealCompile (compiled_maxderiv, true, keep);
+          }
+        catch (const std::exception & e)
+          {
+            // still usable, with the interpreted steps
+            cerr << IM(3) << "Compilation of CoefficientFunction failed: " << e.what() << endl;
+            UnloadLibrary();
+          }
+    }
+
+    void RealCompile(int maxderiv, bool wait, bool akeep_library = false)
+    {
+        if(cf->IsComplex())
+            maxderiv = 0;
+        std::vector<string> codes, link_flags;
+        std::vector<const void*> pointers;
+        GenerateLibraryCode (maxderiv, codes, link_flags, pointers);
+        compiled_maxderiv = maxderiv;
+        code_hash = CodeHash(codes);
+        keep_library = akeep_library;
+
+        auto compile_func = [codes, link_flags, maxderiv, pointers] (CompiledCoefficientFunction * self) {
+              auto library = CompileCode( codes, link_flags );
+              string binary = self->keep_library ? ReadLibraryBinary (*library) : string();
+              std::lock_guard<std::mutex> guard(self->compile_mutex);
+              self->library = std::move(library);
+              self->library_binary = std::move(binary);
+              self->LoadFunctions (maxderiv, FlatArray<const void*>(pointers.size(), const_cast<const void**>(pointers.data())));
               cout << IM(7) << "Compilation done" << endl;
         };
         if(wait)
-            compile_func();
+            compile_func(this);
         else
         {
+          auto self = dynamic_pointer_cast<CompiledCoefficientFunction>(shared_from_this());
+          auto finished = [self] ()
+            {
+              std::lock_guard<std::mutex> guard(self->compile_mutex);
+              self->compiling = false;
+              self->compile_done.notify_all();
+            };
+          {
+            std::lock_guard<std::mutex> guard(compile_mutex);
+            compiling = true;
+          }
           try {
-            std::thread( compile_func ).detach();
+            std::thread( [self, compile_func, finished] ()
+                         {
+                           try { compile_func(self.get()); }
+                           catch (const std::exception &e) {
+                             cerr << IM(3) << "Compilation of CoefficientFunction failed: " << e.what() << endl;
+                           }
+                           finished();
+                         } ).detach();
           } catch (const std::exception &e) {
               cerr << IM(3) << "Compilation of CoefficientFunction failed: " << e.what() << endl;
+              finished();
           }
         }
     }
@@ -5985,15 +6391,11 @@ class CompiledCoefficientFunction : public CoefficientFunction //, public std::e
     void T_Evaluate (const MIR & ir,
                      BareSliceMatrix<T,ORD> values) const
     {
-      ArrayMem<T, 1000> hmem(ir.Size()*totdim);
-      size_t mem_ptr = 0;
+      ArrayMem<T, 1000> hmem(ir.Size()*tempdim);
       ArrayMem<BareSliceMatrix<T,ORD>,100> temp(steps.Size());
       ArrayMem<BareSliceMatrix<T,ORD>, 100> in(max_inputsize);
       for (size_t i = 0; i < steps.Size()-1; i++)
-        {
-          new (&temp[i]) BareSliceMatrix<T,ORD> (FlatMatrix<T,ORD> (dim[i], ir.Size(), &hmem[mem_ptr]));
-          mem_ptr += ir.Size()*dim[i];
-        }
+        new (&temp[i]) BareSliceMatrix<T,ORD> (FlatMatrix<T,ORD> (dim[i], ir.Size(), &hmem[ir.Size()*offset[i]]));
       
       new (&temp.Last()) BareSliceMatrix<T,ORD>(values);
 
@@ -6040,15 +6442,13 @@ class CompiledCoefficientFunction : public CoefficientFunction //, public std::e
     void NonZeroPattern (const class ProxyUserData & ud, FlatVector<AutoDiffDiff<1,bool>> nonzero) const override
     {
       typedef AutoDiffDiff<1,bool> T;
-      ArrayMem<T, 1000> hmem(totdim);
-      size_t mem_ptr = 0;
+      // the temporaries of T_Evaluate, the last step writes into nonzero
+      ArrayMem<T, 1000> hmem(tempdim);
       ArrayMem<FlatVector<T>,100> temp(steps.Size());
       ArrayMem<FlatVector<T>,100> in(max_inputsize);
-      for (size_t i = 0; i < steps.Size(); i++)
-        {
-          new (&temp[i]) FlatVector<T> (dim[i], &hmem[mem_ptr]);
-          mem_ptr += dim[i];
-        }
+      for (size_t i = 0; i < steps.Size()-1; i++)
+        new (&temp[i]) FlatVector<T> (dim[i], &hmem[offset[i]]);
+      new (&temp.Last()) FlatVector<T> (nonzero);
       
       for (size_t i = 0; i < steps.Size(); i++)
         {
@@ -6057,9 +6457,6 @@ class CompiledCoefficientFunction : public CoefficientFunction //, public std::e
             new (&in[nr]) FlatVector<T> (temp[inputi[nr]]);
           steps[i] -> NonZeroPattern (ud, in.Range(0, inputi.Size()), temp[i]);
         }
-      auto & last = temp.Last();
-      for (size_t i = 0; i < nonzero.Size(); i++)
-        nonzero(i) = last(i);
     }
     
     void Evaluate (const BaseMappedIntegrationRule & ir, BareSliceMatrix<double> values) const override
@@ -6124,30 +6521,6 @@ class CompiledCoefficientFunction : public CoefficientFunction //, public std::e
 
       T_Evaluate (ir, Trans(values));
       return;
-      
-      /*
-      typedef AutoDiff<1,double> T;
-      ArrayMem<T,500> hmem(ir.Size()*totdim);      
-      int mem_ptr = 0;
-      ArrayMem<BareSliceMatrix<T,ColMajor>,100> temp(steps.Size());
-      ArrayMem<BareSliceMatrix<T,ColMajor>,100> in(max_inputsize);
-
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          new (&temp[i]) BareSliceMatrix<T,ColMajor> (dim[i], &hmem[mem_ptr], DummySize(dim[i], ir.Size()));
-          mem_ptr += ir.Size()*dim[i];
-        }
-
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          auto inputi = inputs[i];
-          for (int nr : Range(inputi))
-            new (&in[nr]) BareSliceMatrix<T,ColMajor> (temp[inputi[nr]]);
-          steps[i] -> Evaluate (ir, in.Range(0, inputi.Size()), temp[i]);
-        }
-      
-      values.AddSize(ir.Size(), Dimension()) = Trans(temp.Last());
-      */
     }
 
 
@@ -6163,30 +6536,6 @@ class CompiledCoefficientFunction : public CoefficientFunction //, public std::e
 
       T_Evaluate (ir, Trans(values));
       return;
-
-      /*
-      typedef AutoDiffDiff<1,double> T;
-      ArrayMem<T,500> hmem(ir.Size()*totdim);      
-      int mem_ptr = 0;
-      ArrayMem<BareSliceMatrix<T,ColMajor>,100> temp(steps.Size());
-      ArrayMem<BareSliceMatrix<T,ColMajor>,100> in(max_inputsize);
-
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          new (&temp[i]) BareSliceMatrix<T,ColMajor> (dim[i], &hmem[mem_ptr], DummySize(dim[i], ir.Size()));
-          mem_ptr += ir.Size()*dim[i];
-        }
-
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          auto inputi = inputs[i];
-          for (int nr : Range(inputi))
-            new (&in[nr]) BareSliceMatrix<T,ColMajor> (temp[inputi[nr]]);
-          steps[i] -> Evaluate (ir, in.Range(0, inputi.Size()), temp[i]);
-        }
-      
-      values.AddSize(ir.Size(), Dimension()) = Trans(temp.Last());
-      */
     }
 
 
@@ -6202,32 +6551,6 @@ class CompiledCoefficientFunction : public CoefficientFunction //, public std::e
 
       T_Evaluate (ir, values);
       return;
-
-      /*
-      typedef AutoDiff<1,SIMD<double>> T;
-      // STACK_ARRAY(T, hmem, ir.Size()*totdim);
-      ArrayMem<T,500> hmem(ir.Size()*totdim);
-      size_t mem_ptr = 0;
-
-      ArrayMem<BareSliceMatrix<T>,100> temp(steps.Size());
-      ArrayMem<BareSliceMatrix<T>,100> in(max_inputsize);
-
-      for (size_t i = 0; i < steps.Size()-1; i++)
-        {
-          new (&temp[i]) BareSliceMatrix<T> (ir.Size(), &hmem[mem_ptr], DummySize(dim[i], ir.Size()));
-          mem_ptr += ir.Size()*dim[i];
-        }
-      // the final step goes to result matrix
-      new (&temp.Last()) BareSliceMatrix<T>(values);
-      
-      for (size_t i = 0; i < steps.Size(); i++)
-        {
-          auto inputi = inputs[i];
-          for (size_t nr : Range(inputi))
-            new (&in[nr]) BareSliceMatrix<T> (temp[inputi[nr]]);
-          steps[i] -> Evaluate (ir, in.Range(0, inputi.Size()), temp[i]);
-        }
-      */
     }
 
 
@@ -6243,33 +6566,6 @@ class CompiledCoefficientFunction : public CoefficientFunction //, public std::e
       
       T_Evaluate (ir, values);
       return;
-
-      /*
-      typedef AutoDiffDiff<1,SIMD<double>> T;
-      // STACK_ARRAY(T, hmem, ir.Size()*totdim);
-      ArrayMem<T,500> hmem(ir.Size()*totdim);      
-      int mem_ptr = 0;
-      ArrayMem<BareSliceMatrix<T>,100> temp(steps.Size());
-      ArrayMem<BareSliceMatrix<T>,100> in(max_inputsize);
-
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          new (&temp[i]) BareSliceMatrix<T> (ir.Size(), &hmem[mem_ptr], DummySize(dim[i], ir.Size()));
-          mem_ptr += ir.Size()*dim[i];
-        }
-
-      for (int i = 0; i < steps.Size(); i++)
-        {
-          auto inputi = inputs[i];
-          for (int nr : Range(inputi))
-            new (&in[nr]) BareSliceMatrix<T> (temp[inputi[nr]]);
-          // in[nr] = &temp[inputi[nr]];
-
-          steps[i] -> Evaluate (ir, in.Range(0, inputi.Size()), temp[i]);
-        }
-
-      values.AddSize(Dimension(), ir.Size()) = temp.Last();
-      */
     }
 
     
@@ -6745,11 +7041,12 @@ class RealCF : public CoefficientFunctionNoDerivative
     return make_shared<ImagCF>(cf);
   }
 
-  shared_ptr<CoefficientFunction> Compile (shared_ptr<CoefficientFunction> c, bool realcompile, int maxderiv, bool wait)
+  shared_ptr<CoefficientFunction> Compile (shared_ptr<CoefficientFunction> c, bool realcompile, int maxderiv, bool wait,
+                                           bool keep_library)
   {
     auto cf = make_shared<CompiledCoefficientFunction> (c);
     if(realcompile)
-      cf->RealCompile(maxderiv, wait);
+      cf->RealCompile(maxderiv, wait, keep_library);
     return cf;
   }
 
@@ -6886,3 +7183,4 @@ static RegisterClassForArchive<CompiledCoefficientFunction, CoefficientFunction>
 static RegisterClassForArchive<OtherCoefficientFunction, CoefficientFunction> regothercf;
 }
 
+
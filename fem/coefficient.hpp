@@ -238,6 +238,9 @@ namespace ngfem
     virtual Array<shared_ptr<CoefficientFunction>> InputCoefficientFunctions() const
     { return Array<shared_ptr<CoefficientFunction>>(); }
     virtual bool StoreUserData() const { return false; }
+    /// called by integrators once per element, to precompute data shared by several evaluations
+    virtual void PrepareUserData (class ProxyUserData & ud, const ElementTransformation & trafo,
+                                  LocalHeap & lh) const { ; }
 
   };
 
@@ -820,6 +823,10 @@ namespace ngfem
     virtual void Evaluate (const BaseMappedIntegrationRule & ir, 
 			   BareSliceMatrix<double> values) const;
 
+    /// uses the register program of the EvalFunction, if available
+    virtual void Evaluate (const SIMD_BaseMappedIntegrationRule & ir,
+                           BareSliceMatrix<SIMD<double>> values) const;
+
     virtual void PrintReport (ostream & ost) const;
 
     virtual void GenerateCode(Code &code, FlatArray<int> inputs, int index) const;
@@ -1694,7 +1701,8 @@ INLINE shared_ptr<CoefficientFunction> BinaryOpCF(shared_ptr<CoefficientFunction
   shared_ptr<CoefficientFunction> Freeze (shared_ptr<CoefficientFunction> cf);
   
   NGS_DLL_HEADER
-  shared_ptr<CoefficientFunction> Compile (shared_ptr<CoefficientFunction> c, bool realcompile=false, int maxderiv=2, bool wait=false);
+  shared_ptr<CoefficientFunction> Compile (shared_ptr<CoefficientFunction> c, bool realcompile=false, int maxderiv=2, bool wait=false,
+                                           bool keep_library=false);
 
   NGS_DLL_HEADER
   shared_ptr<CoefficientFunction> LoggingCF (shared_ptr<CoefficientFunction> func, string logfile="stdout");
@@ -131,6 +131,14 @@ namespace ngfem
       order = ho;
     }
 
+    /// uniform order elements of the same vertex orientation share shapes
+    INLINE bool GetShapeCacheClass (size_t & classnr) const
+    {
+      if (nodalp2 || ndof != PolDimension (order)) return false;
+      classnr = VertexPermutationClass<N_VERTEX> (this->vnums);
+      return true;
+    }
+
 
   };
 
@@ -3254,6 +3254,7 @@ namespace ngfem
               default:
                 ;
               }
+            tmp->SetGlobal();
             (*ira)[order] = tmp;
           }
       }
@@ -2273,6 +2273,7 @@ namespace ngfem
     int dimension = -1;
     size_t nip = -47;
     const SIMD_IntegrationRule *irx = nullptr, *iry = nullptr, *irz = nullptr; // for tensor product IR
+    bool global = false; // points to a rule of SIMD_SelectIntegrationRule, valid forever
   public:
     SIMD_IntegrationRule () = default;
     inline SIMD_IntegrationRule (ELEMENT_TYPE eltype, int order);
@@ -2304,6 +2305,7 @@ namespace ngfem
       ir2.irx = irx;
       ir2.iry = iry;
       ir2.irz = irz;
+      ir2.global = global;
       return ir2;
     }
 
@@ -2316,6 +2318,10 @@ namespace ngfem
     void SetIRX(const SIMD_IntegrationRule * ir) { irx = ir; }
     void SetIRY(const SIMD_IntegrationRule * ir) { iry = ir; }
     void SetIRZ(const SIMD_IntegrationRule * ir) { irz = ir; }
+
+    /// points of global rules can be used as keys for precomputed data
+    bool IsGlobal() const { return global; }
+    void SetGlobal(bool aglobal = true) { global = aglobal; }
   };
 
   extern NGS_DLL_HEADER const SIMD_IntegrationRule & SIMD_SelectIntegrationRule (ELEMENT_TYPE eltype, int order);
@@ -2331,6 +2337,7 @@ namespace ngfem
     irx = ir.irx;
     iry = ir.iry;
     irz = ir.irz;
+    global = ir.global;
   }
 
 
@@ -105,6 +105,14 @@ namespace ngfem
         order = max2(order, order_inner[i]);
     }
 
+    /// uniform order elements of the same vertex orientation share shapes
+    INLINE bool GetShapeCacheClass (size_t & classnr) const
+    {
+      if (ndof != PolDimension (order)) return false;
+      classnr = VertexPermutationClass<N_VERTEX> (vnums);
+      return true;
+    }
+
     NGS_DLL_HEADER virtual void PrecomputeTrace ();
     NGS_DLL_HEADER virtual void PrecomputeGrad ();
     NGS_DLL_HEADER virtual void PrecomputeShapes (const IntegrationRule & ir);
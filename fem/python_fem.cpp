@@ -132,12 +132,7 @@ struct GenericBSpline {
   GenericBSpline( shared_ptr<BSpline> asp ) : sp(asp) {;}
   template <typename T> T operator() (T x) const { return (*sp)(x); }
   Complex operator() (Complex x) const { return (*sp)(x.real()); }
-  SIMD<double> operator() (SIMD<double> x) const
-  { return SIMD<double>([&](int i)->double { return (*sp)(x[i]); } );}
-  SIMD<Complex> operator() (SIMD<Complex> x) const
-  { return SIMD<double>([&](int i)->double { return (*sp)(x.real()[i]); } );}
-  AutoDiff<1,SIMD<double>> operator() (AutoDiff<1,SIMD<double>> x) const { throw ExceptionNOSIMD ("AutoDiff for bspline not supported"); }
-  AutoDiffDiff<1,SIMD<double>> operator() (AutoDiffDiff<1,SIMD<double>> x) const { throw ExceptionNOSIMD ("AutoDiffDiff for bspline not supported"); }
+  SIMD<Complex> operator() (SIMD<Complex> x) const { return (*sp)(x.real()); }
   void DoArchive(Archive& ar) { ar & sp; }
 };
 
@@ -954,11 +949,12 @@ cf : ngsolve.CoefficientFunction
           { return Freeze(coef); },
           "don't differentiate this expression")
 
-    .def ("Compile", [] (shared_ptr<CF> coef, bool realcompile, int maxderiv, bool wait)
-           { return Compile (coef, realcompile, maxderiv, wait); },
+    .def ("Compile", [] (shared_ptr<CF> coef, bool realcompile, int maxderiv, bool wait, bool keep_library)
+           { return Compile (coef, realcompile, maxderiv, wait, keep_library); },
            py::arg("realcompile")=false,
            py::arg("maxderiv")=2,
-          py::arg("wait")=false, py::call_guard<py::gil_scoped_release>(), docu_string(R"raw_string(
+          py::arg("wait")=false, py::arg("keep_library")=false,
+          py::call_guard<py::gil_scoped_release>(), docu_string(R"raw_string(
 Compile list of individual steps, experimental improvement for deep trees
 
 Parameters:
@@ -972,6 +968,11 @@ maxderiv : int
 wait : bool
   True -> Waits until the previous Compile call is finished before start compiling
 
+keep_library : bool
+  True -> The compiled library is stored in pickles and archives. It is
+  loaded without calling the compiler when unpickled by a process with the
+  same NGSolve version, compiler and SIMD width, otherwise the code is compiled again.
+
 )raw_string"))
 
 
@@ -1884,6 +1885,31 @@ intrule : ngsolve.fem.Integrationrule
   input integration rule
 
 )raw_string"))
+    .def("Compile", [] (shared_ptr<BFI> self, bool wait)
+         {
+           auto sbfi = dynamic_pointer_cast<SymbolicBilinearFormIntegrator> (self);
+           if (!sbfi)
+             throw Exception ("Compile needs a symbolic bilinear form integrator");
+           sbfi -> CompileElementMatrix (wait);
+           return self;
+         }, py::arg("wait")=false, py::call_guard<py::gil_scoped_release>(),
+         docu_string(R"raw_string(
+Generates and compiles a C++ kernel for the element matrices, with the
+proxy dimensions and the nonzero pattern of the integrand fixed at compile
+time. Used for real valued volume integrators with SIMD evaluation, the
+generic version is used until the compiled kernel is loaded.
+
+Parameters:
+
+wait : bool
+  wait until the compilation is finished
+
+)raw_string"))
+    .def_property_readonly("compiled", [] (shared_ptr<BFI> self)
+         {
+           auto sbfi = dynamic_pointer_cast<SymbolicBilinearFormIntegrator> (self);
+           return sbfi && sbfi->HasCompiledElementMatrix();
+         }, "is the compiled element matrix kernel loaded ?")
     .def("CalcElementMatrix",
          [] (shared_ptr<BFI> self,
              const FiniteElement & fe, const ElementTransformation &trafo,
@@ -2180,17 +2206,64 @@ alpha : double
                            
   m.def("GenerateL2ElementCode", &GenerateL2ElementCode);
 
+  m.def("SetShapeCache", [] (bool enable, py::object maxmemory)
+        {
+          auto & cache = SIMD_ShapeCache::Instance();
+          cache.SetEnabled (enable);
+          if (!maxmemory.is_none())
+            cache.SetMaxMemory (maxmemory.cast<size_t>());
+          if (!enable)
+            cache.Clear();
+        },
+        py::arg("enable")=true, py::arg("maxmemory")=py::none(),
+        docu_string(R"raw_string(
+Shape functions of uniform order H1 and L2 elements are tabulated on
+the integration rules, and evaluated by matrix-vector products.
+
+Parameters:
+
+enable : bool
+  use tabulated shape functions
+
+maxmemory : int
+  limit for the memory of all tables in bytes, default 256 MB
+
+)raw_string"));
+
+  m.def("ClearShapeCache", [] () { SIMD_ShapeCache::Instance().Clear(); },
+        "Remove all tabulated shape functions");
+
+  m.def("ShapeCacheInfo", [] ()
+        {
+          auto & cache = SIMD_ShapeCache::Instance();
+          py::dict info;
+          info["enabled"] = cache.IsEnabled();
+          info["tables"] = cache.GetNumTables();
+          info["memory"] = cache.GetMemory();
+          info["maxmemory"] = cache.GetMaxMemory();
+          return info;
+        }, "Number of tables and memory of the shape cache");
+
+  auto voxel_storage = [] (string dtype, bool & complex)
+    {
+      complex = dtype == "complex128";
+      if (dtype == "float64" || dtype == "complex128") return VoxelStorage::NATIVE;
+      if (dtype == "float32") return VoxelStorage::FLOAT32;
+      if (dtype == "uint8") return VoxelStorage::UINT8;
+      if (dtype == "uint16") return VoxelStorage::UINT16;
+      throw Exception("Only float64, complex128, float32, uint8 and uint16 voxel values allowed!");
+    };
+
   m.def("VoxelCoefficient",
-        [](py::tuple pystart, py::tuple pyend, py::array values,
-           bool linear, py::object trafocf)
+        [voxel_storage](py::tuple pystart, py::tuple pyend, py::array values,
+           bool linear, py::object trafocf, double scale, double shift)
         -> shared_ptr<CoefficientFunction>
         {
           shared_ptr<CoefficientFunction> trafo;
           try { trafo = MakeCoefficient(trafocf); }
           catch(...) { trafo=nullptr; }
-          Array<string> allowed_types = { "float64", "complex128" };
-          if(!allowed_types.Contains(py::cast<string>(values.dtype().attr("name"))))
-            throw Exception("Only float64 and complex128 dtype arrays allowed!");
+          bool complex;
+          auto storage = voxel_storage(py::cast<string>(values.dtype().attr("name")), complex);
           Array<double> start, end;
           Array<size_t> dim_vals;
           for(auto val : pystart)
@@ -2200,29 +2273,71 @@ alpha : double
           for(auto dim : Range(values.ndim()))
             dim_vals.Insert(0,values.shape(dim));
 
-          if(values.dtype().kind() == 'c')
+          if(complex)
             {
               auto c_array = py::cast<py::array_t<Complex>>(values.attr("ravel")());
               Array<Complex> vals(c_array.size());
               for(auto i : Range(vals))
-                vals[i] = c_array.at(i);
+                vals[i] = shift + scale * c_array.at(i);
               return make_shared<VoxelCoefficientFunction<Complex>>
                 (start, end, dim_vals, move(vals), linear, trafo);
             }
-          auto d_array = py::cast<py::array_t<double>>(values.attr("ravel")());
-          Array<double> vals(values.size());
-          for(auto i : Range(vals))
-            vals[i] = d_array.at(i);
+          if(storage == VoxelStorage::NATIVE)
+            {
+              auto d_array = py::cast<py::array_t<double>>(values.attr("ravel")());
+              Array<double> vals(values.size());
+              for(auto i : Range(vals))
+                vals[i] = shift + scale * d_array.at(i);
+              return make_shared<VoxelCoefficientFunction<double>>
+                (start, end, dim_vals, move(vals), linear, trafo);
+            }
+
+          // keep the compact storage type
+          auto copy = make_shared<Array<char>>(values.nbytes());
+          auto contiguous = py::array::ensure(values, py::array::c_style);
+          memcpy(copy->Data(), contiguous.data(), values.nbytes());
           return make_shared<VoxelCoefficientFunction<double>>
-              (start, end, dim_vals, move(vals), linear, trafo);
+            (start, end, dim_vals, copy, copy->Data(), storage, scale, shift, linear, trafo);
         }, py::arg("start"), py::arg("end"), py::arg("values"),
-        py::arg("linear")=true, py::arg("trafocf")=DummyArgument(), R"delimiter(CoefficientFunction defined on a grid.
+        py::arg("linear")=true, py::arg("trafocf")=DummyArgument(),
+        py::arg("scale")=1.0, py::arg("shift")=0.0, R"delimiter(CoefficientFunction defined on a grid.
 
 Start and end mark the cartesian boundary of domain. The function will be continued by a constant function outside of this box. Inside a cartesian grid will be created by the dimensions of the numpy input array 'values'. This array must have the dimensions of the mesh and the values stored as:
 x1y1z1, x2y1z1, ..., xNy1z1, x1y2z1, ...
 
 If linear is True the function will be interpolated linearly between the values. Otherwise the nearest voxel value is taken.
 
+The value of the function is shift + scale * value. Values of type float32, uint8 and uint16 are kept in this type.
+
+)delimiter");
+
+  m.def("LoadVoxelCoefficient",
+        [voxel_storage](string filename, py::tuple pystart, py::tuple pyend, py::tuple pyshape,
+           string dtype, size_t offset, bool linear, py::object trafocf, double scale, double shift)
+        -> shared_ptr<CoefficientFunction>
+        {
+          shared_ptr<CoefficientFunction> trafo;
+          try { trafo = MakeCoefficient(trafocf); }
+          catch(...) { trafo=nullptr; }
+          bool complex;
+          auto storage = voxel_storage(dtype, complex);
+          Array<double> start, end;
+          Array<size_t> dim_vals;
+          for(auto val : pystart)
+            start.Append(py::cast<double>(val));
+          for(auto val : pyend)
+            end.Append(py::cast<double>(val));
+          for(auto val : pyshape)
+            dim_vals.Insert(0, py::cast<size_t>(val));
+          return LoadVoxelCoefficientFunction (filename, offset, start, end, dim_vals,
+                                               storage, complex, scale, shift, linear, trafo);
+        }, py::arg("filename"), py::arg("start"), py::arg("end"), py::arg("shape"),
+        py::arg("dtype")="float64", py::arg("offset")=0,
+        py::arg("linear")=true, py::arg("trafocf")=DummyArgument(),
+        py::arg("scale")=1.0, py::arg("shift")=0.0, R"delimiter(VoxelCoefficient with values in a raw binary file.
+
+The file is memory mapped, the values are not copied. They start at byte 'offset' and are stored as a C-ordered array of the given shape and dtype, as written by numpy.ndarray.tofile. See VoxelCoefficient for the other arguments.
+
 )delimiter");
 
 }
@@ -0,0 +1,80 @@
+/*********************************************************************/
+/* File:   shapecache.cpp                                            */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+/* 
+   Cache of tabulated shape functions
+*/
+
+#include <fem.hpp>
+
+namespace ngfem
+{
+
+  SIMD_ShapeCache & SIMD_ShapeCache :: Instance()
+  {
+    static SIMD_ShapeCache cache;
+    return cache;
+  }
+
+  void SIMD_ShapeCache :: Clear ()
+  {
+    lock_guard<mutex> guard(mut);
+    tables.clear();
+    memory = 0;
+    generation++;
+  }
+
+  const Matrix<> * SIMD_ShapeCache ::
+  Get (const Key & key, size_t height, size_t width,
+       const std::function<void(SliceMatrix<>)> & calc)
+  {
+    static Timer t("SIMD_ShapeCache::Get - calc table");
+
+    // a few recently used tables per thread
+    struct RecentTable
+    {
+      Key key;
+      size_t generation = size_t(-1);
+      shared_ptr<Matrix<>> table;
+    };
+    constexpr size_t NRECENT = 16;
+    thread_local RecentTable recent[NRECENT];
+
+    size_t gen = generation;
+    RecentTable & slot = recent[KeyHash()(key) % NRECENT];
+    if (slot.generation == gen && slot.key == key)
+      return slot.table.get();
+
+    shared_ptr<Matrix<>> table;
+    {
+      lock_guard<mutex> guard(mut);
+      auto pos = tables.find(key);
+      if (pos != tables.end())
+        table = pos->second;
+      else if (memory + height*width*sizeof(double) > max_memory)
+        return nullptr;
+    }
+
+    if (!table)
+      {
+        RegionTimer reg(t);
+        table = make_shared<Matrix<>> (height, width);
+        calc (*table);
+
+        lock_guard<mutex> guard(mut);
+        auto ins = tables.emplace (key, table);
+        if (ins.second)
+          memory += height*width*sizeof(double);
+        else
+          table = ins.first->second;   // built concurrently by another thread
+      }
+
+    slot.key = key;
+    slot.generation = gen;
+    slot.table = table;
+    return table.get();
+  }
+
+}
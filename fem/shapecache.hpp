@@ -0,0 +1,114 @@
+#ifndef FILE_SHAPECACHE
+#define FILE_SHAPECACHE
+
+#include <unordered_map>
+
+/*********************************************************************/
+/* File:   shapecache.hpp                                            */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+namespace ngfem
+{
+
+  /**
+     Shape functions and reference gradients on SIMD integration rules.
+
+     Reference shapes of uniform-order elements depend only on the
+     element family, the element type, the order and the vertex
+     orientation. They are tabulated once per global integration rule
+     (a rule created by SIMD_IntegrationRule(eltype, order)), such that
+     evaluation becomes a matrix-vector product.
+
+     Tables are stored as matrices of doubles, one row per shape
+     function, with SIMD<double>::Size() consecutive columns per SIMD
+     integration point. Gradient tables consist of DIM such blocks of
+     columns, one for every reference direction.
+
+     The cache is thread-safe. Every thread keeps a few recently used
+     tables, so lookups usually do not lock. Clear() may be called while
+     other threads still use tables. New tables are not stored once the
+     memory limit is reached.
+  */
+  class NGS_DLL_HEADER SIMD_ShapeCache
+  {
+  public:
+    struct Key
+    {
+      size_t family;      // hash of the shape-class
+      size_t classnr;     // vertex-orientation class
+      const void * ir;    // data of the global integration rule
+      int eltype;
+      int order;
+      int ndof;
+      bool grad;
+
+      bool operator== (const Key & k2) const
+      {
+        return family == k2.family && classnr == k2.classnr && ir == k2.ir &&
+          eltype == k2.eltype && order == k2.order && ndof == k2.ndof && grad == k2.grad;
+      }
+    };
+
+    struct KeyHash
+    {
+      size_t operator() (const Key & k) const
+      {
+        return k.family ^ (k.classnr * 2654435761u) ^ (size_t(k.ir) >> 4)
+          ^ (size_t(k.eltype) << 56) ^ (size_t(k.order) << 48) ^ (size_t(k.ndof) << 32) ^ size_t(k.grad);
+      }
+    };
+
+  private:
+    mutex mut;
+    std::unordered_map<Key, shared_ptr<Matrix<>>, KeyHash> tables;
+    size_t memory = 0;
+    size_t max_memory = 256*1024*1024;
+    /// incremented by Clear, invalidates per-thread lookups
+    atomic<size_t> generation{0};
+    bool enabled = true;
+
+  public:
+    static SIMD_ShapeCache & Instance();
+
+    bool IsEnabled () const { return enabled; }
+    void SetEnabled (bool aenabled) { enabled = aenabled; }
+
+    /// limit for the size of all tables (in bytes)
+    void SetMaxMemory (size_t amax) { max_memory = amax; }
+    size_t GetMaxMemory () const { return max_memory; }
+    size_t GetMemory () const { return memory; }
+    size_t GetNumTables () const { return tables.size(); }
+
+    /// drop all tables
+    void Clear ();
+
+    /**
+       Returns the table for key, calling calc(table) to build it if
+       it does not exist. Returns nullptr if the table does not fit
+       into the memory limit. The pointer is valid until the next
+       call of Get from the same thread.
+    */
+    const Matrix<> * Get (const Key & key, size_t height, size_t width,
+                          const std::function<void(SliceMatrix<>)> & calc);
+  };
+
+
+  /// rank permutation of the vertex numbers, a complete orientation class
+  template <int N, typename TVN>
+  INLINE size_t VertexPermutationClass (const TVN & vnums)
+  {
+    size_t classnr = 0;
+    for (int i = 0; i < N; i++)
+      {
+        int rank = 0;
+        for (int j = 0; j < N; j++)
+          if (vnums[j] < vnums[i]) rank++;
+        classnr = classnr*N + rank;
+      }
+    return classnr;
+  }
+
+}
+
+#endif
@@ -1303,8 +1303,38 @@ namespace ngfem
 
           // NgProfiler::StopThreadTimer (timer_SymbBFIstart, TaskManager::GetThreadId());
 
-          ProxyUserData ud;
+          if constexpr (is_same<SCAL,double>::value && is_same<SCAL_SHAPES,double>::value &&
+                        is_same<SCAL_RES,double>::value)
+            if (!is_mixedfe)
+              if (auto kernel = GetCompiledKernel())
+                {
+                  CalcElementMatrixAddCompiled (kernel->function, fel, mir, elmat, symmetric_so_far, lh);
+                  return;
+                }
+
+          ProxyUserData ud(0, gridfunction_cfs.Size(), lh);
           const_cast<ElementTransformation&>(trafo).userdata = &ud;
+          ud.PrepareGridFunctions (gridfunction_cfs, ir.GetNIP(), trafo, lh);
+
+          // coefficients constant on the element are evaluated in one point
+          IntegrationRule ir1;
+          BaseMappedIntegrationRule * mir1 = nullptr;
+          if (elementwise_constant)
+            {
+              ir1 = GetIntegrationRule(fel, lh).Range(0,1);
+              mir1 = &trafo(ir1, lh);
+            }
+          auto evaluate = [&] (FlatMatrix<SIMD<SCAL>> values)
+            {
+              if (mir1)
+                {
+                  Vec<1,SCAL> hval;
+                  cf -> Evaluate ((*mir1)[0], hval);
+                  values.Row(0) = SIMD<SCAL>(hval(0));
+                }
+              else
+                cf -> Evaluate (mir, values);
+            };
 
           // bool symmetric_so_far = true;
           int k1 = 0;
@@ -1346,7 +1376,7 @@ namespace ngfem
                                   ud.testfunction = proxy2;
                                   ud.test_comp = l;
                                   
-                                  cf -> Evaluate (mir, proxyvalues.Rows(kk,kk+1));
+                                  evaluate (proxyvalues.Rows(kk,kk+1));
                                 }
                               else
                                 ; 
@@ -1360,7 +1390,7 @@ namespace ngfem
                             ud.testfunction = proxy2;
                             ud.test_comp = k;
                             
-                            cf -> Evaluate (mir, diagproxyvalues.Rows(k,k+1));
+                            evaluate (diagproxyvalues.Rows(k,k+1));
                           }
                       // td.Stop();
                       }
@@ -1542,9 +1572,9 @@ namespace ngfem
     const IntegrationRule& ir = GetIntegrationRule (fel, lh);
     BaseMappedIntegrationRule & mir = trafo(ir, lh);
     
-    ProxyUserData ud;
+    ProxyUserData ud(0, gridfunction_cfs.Size(), lh);
     const_cast<ElementTransformation&>(trafo).userdata = &ud;
-    
+    ud.PrepareGridFunctions (gridfunction_cfs, ir.Size(), trafo, lh);
     
     // tstart.Stop();
     // bool symmetric_so_far = true;
@@ -1590,8 +1620,16 @@ namespace ngfem
                             ud.testfunction = proxy2;
                             ud.test_comp = l;
                             
-                            cf -> Evaluate (mir, val);
-                            proxyvalues(STAR,k,l) = val.Col(0);
+                            if (!elementwise_constant)
+                              {
+                                cf -> Evaluate (mir, val);
+                                proxyvalues(STAR,k,l) = val.Col(0);
+                              }
+                            else
+                              {
+                                cf -> Evaluate (mir[0], val.Row(0));
+                                proxyvalues(STAR,k,l) = val(0,0);
+                              }
                           }
                         else
                           proxyvalues(STAR,k,l) = 0.0;
@@ -1716,6 +1754,233 @@ namespace ngfem
   }
 
 
+  string SymbolicBilinearFormIntegrator :: GenerateElementMatrixCode () const
+  {
+    if (element_vb != VOL || cf->IsComplex())
+      return "";
+    for (auto proxy : trial_proxies)
+      if (proxy->IsComplex()) return "";
+    for (auto proxy : test_proxies)
+      if (proxy->IsComplex()) return "";
+
+    stringstream s;
+    s << "#include<fem.hpp>" << endl
+      << "using namespace ngfem;" << endl
+      << "extern \"C\" {" << endl;
+#ifdef WIN32
+    s << "__declspec(dllexport) ";
+#endif
+    s << "void CompiledElementMatrix (size_t nip," << endl
+      << "  const SIMD<double> * const * trial_bmats, const size_t * trial_first, const size_t * trial_ndof," << endl
+      << "  const SIMD<double> * const * test_bmats, const size_t * test_first, const size_t * test_ndof," << endl
+      << "  const SIMD<double> * dvals, SIMD<double> * work," << endl
+      << "  bool symmetric, double * elmat, size_t dist) {" << endl;
+
+    // rows of dvals are the nonzero components of the proxy pairs, in this order
+    // (trial component k outer, test component l inner, as in CalcElementMatrixAddCompiled)
+    size_t row = 0;
+    // as in the generic version, blocks are symmetric as long as all pairs so far are
+    bool sym_so_far = true;
+    for (size_t k1 : Range(trial_proxies))
+      for (size_t l1 : Range(test_proxies))
+        {
+          if (!nonzeros_proxies(l1, k1)) continue;
+          size_t dim1 = trial_proxies[k1]->Dimension();
+          size_t dim2 = test_proxies[l1]->Dimension();
+          sym_so_far &= diagonal_proxies(l1, k1) && same_diffops(l1, k1);
+
+          // rows[k*dim2+l] is the row of component (k,l), or -1
+          Array<int> rows(dim1*dim2);
+          rows = -1;
+          for (size_t k : Range(dim1))
+            for (size_t l : Range(dim2))
+              if (nonzeros(test_cum[l1]+l, trial_cum[k1]+k))
+                rows[k*dim2+l] = row++;
+
+          s << "{ // trial proxy " << k1 << ", test proxy " << l1 << endl
+            << "size_t n1 = trial_ndof[" << k1 << "], n2 = test_ndof[" << l1 << "];" << endl
+            << "const SIMD<double> * b1 = trial_bmats[" << k1 << "];" << endl
+            << "const SIMD<double> * b2 = test_bmats[" << l1 << "];" << endl
+            << "double * mat = elmat + test_first[" << l1 << "]*dist + trial_first[" << k1 << "];" << endl
+            << "[[maybe_unused]] bool sym = " << (sym_so_far ? "symmetric" : "false") << ";" << endl;
+
+          // work(j,l) = sum_k D(k,l) * b1(j,k), per integration point
+          s << "for (size_t j = 0; j < n1; j++)" << endl
+            << "for (size_t q = 0; q < nip; q++) {" << endl;
+          for (size_t k : Range(dim1))
+            s << "SIMD<double> b1_" << k << " = b1[(j*" << dim1 << "+" << k << ")*nip+q];" << endl;
+          for (size_t l : Range(dim2))
+            {
+              s << "work[(j*" << dim2 << "+" << l << ")*nip+q] = SIMD<double>(0.0)";
+              for (size_t k : Range(dim1))
+                if (rows[k*dim2+l] >= 0)
+                  s << " + dvals[" << rows[k*dim2+l] << "*nip+q] * b1_" << k;
+              s << ";" << endl;
+            }
+          s << "}" << endl;
+
+          // mat(i,j) += sum_l b2(i,l) * work(j,l), summed over integration points
+          s << "for (size_t i = 0; i < n2; i++)" << endl
+            << "for (size_t j = 0; j < (sym ? i+1 : n1); j++) {" << endl
+            << "SIMD<double> sum(0.0);" << endl
+            << "for (size_t q = 0; q < nip; q++)" << endl
+            << "sum += SIMD<double>(0.0)";
+          for (size_t l : Range(dim2))
+            s << " + b2[(i*" << dim2 << "+" << l << ")*nip+q] * work[(j*" << dim2 << "+" << l << ")*nip+q]";
+          s << ";" << endl
+            << "mat[i*dist+j] += HSum(sum);" << endl
+            << "}" << endl;
+          if (sym_so_far)
+            s << "if (sym)" << endl
+              << "for (size_t i = 0; i < n2; i++)" << endl
+              << "for (size_t j = 0; j < i; j++)" << endl
+              << "mat[j*dist+i] = mat[i*dist+j];" << endl;
+          s << "}" << endl;
+        }
+    s << "}" << endl << "}" << endl;
+    return s.str();
+  }
+
+  void SymbolicBilinearFormIntegrator :: CompileElementMatrix (bool wait)
+  {
+    string code = GenerateElementMatrixCode();
+    if (code.empty())
+      {
+        cout << IM(3) << "Element matrix kernel not supported for this integrator" << endl;
+        return;
+      }
+    cout << IM(5) << "Element matrix kernel:" << endl << code << endl;
+
+    // the old kernel is used for assembling until the new one is loaded,
+    // it is unloaded when the last assembling thread releases it
+    auto slot = compiled_kernel;
+    auto compile_func = [slot, code] ()
+      {
+        try
+          {
+            auto kernel = make_shared<CompiledKernel>();
+            kernel->library = CompileCode ( { code }, { } );
+            kernel->function = kernel->library->GetFunction<lib_elmat_kernel>("CompiledElementMatrix");
+            std::atomic_store (&slot->kernel, kernel);
+            cout << IM(7) << "Compilation of element matrix kernel done" << endl;
+          }
+        catch (const std::exception & e)
+          {
+            cerr << IM(3) << "Compilation of element matrix kernel failed: " << e.what() << endl;
+          }
+      };
+    if (wait)
+      compile_func();
+    else
+      std::thread( compile_func ).detach();
+  }
+
+  void SymbolicBilinearFormIntegrator ::
+  CalcElementMatrixAddCompiled (lib_elmat_kernel kernel,
+                                const FiniteElement & fel,
+                                const SIMD_BaseMappedIntegrationRule & mir,
+                                FlatMatrix<double> elmat,
+                                bool & symmetric_so_far,
+                                LocalHeap & lh) const
+  {
+    static Timer t("SymbolicBFI::CalcElementMatrixAdd compiled", 2);
+    ThreadRegionTimer reg(t, TaskManager::GetThreadId());
+
+    auto & trafo = mir.GetTransformation();
+    ProxyUserData ud(0, gridfunction_cfs.Size(), lh);
+    const_cast<ElementTransformation&>(trafo).userdata = &ud;
+    ud.PrepareGridFunctions (gridfunction_cfs, mir.IR().GetNIP(), trafo, lh);
+    size_t nip = mir.Size();
+
+    // B-matrices, once per proxy, shared by test and trial proxies with the same diffop
+    FlatArray<const SIMD<double>*> trial_bmats(trial_proxies.Size(), lh), test_bmats(test_proxies.Size(), lh);
+    FlatArray<size_t> trial_first(trial_proxies.Size(), lh), test_first(test_proxies.Size(), lh);
+    FlatArray<size_t> trial_ndof(trial_proxies.Size(), lh), test_ndof(test_proxies.Size(), lh);
+    size_t maxdim2 = 0, nnz = 0;
+    for (size_t k1 : Range(trial_proxies))
+      {
+        auto proxy = trial_proxies[k1];
+        IntRange r = proxy->Evaluator()->UsedDofs(fel);
+        FlatMatrix<SIMD<double>> bmat(elmat.Width()*proxy->Dimension(), nip, lh);
+        proxy->Evaluator()->CalcMatrix(fel, mir, bmat);
+        trial_bmats[k1] = &bmat(r.First()*proxy->Dimension(), 0);
+        trial_first[k1] = r.First();
+        trial_ndof[k1] = r.Size();
+      }
+    for (size_t l1 : Range(test_proxies))
+      {
+        auto proxy = test_proxies[l1];
+        IntRange r = proxy->Evaluator()->UsedDofs(fel);
+        test_first[l1] = r.First();
+        test_ndof[l1] = r.Size();
+        maxdim2 = max2(maxdim2, size_t(proxy->Dimension()));
+
+        test_bmats[l1] = nullptr;
+        for (size_t k1 : Range(trial_proxies))
+          if (same_diffops(l1, k1))
+            test_bmats[l1] = trial_bmats[k1];
+        if (!test_bmats[l1])
+          {
+            FlatMatrix<SIMD<double>> bmat(elmat.Height()*proxy->Dimension(), nip, lh);
+            proxy->Evaluator()->CalcMatrix(fel, mir, bmat);
+            test_bmats[l1] = &bmat(r.First()*proxy->Dimension(), 0);
+          }
+      }
+
+    for (size_t k1 : Range(trial_proxies))
+      for (size_t l1 : Range(test_proxies))
+        if (nonzeros_proxies(l1, k1))
+          for (size_t k : Range(trial_proxies[k1]->Dimension()))
+            for (size_t l : Range(test_proxies[l1]->Dimension()))
+              if (nonzeros(test_cum[l1]+l, trial_cum[k1]+k))
+                nnz++;
+
+    // weighted values of the coefficient function, in the order of the generated code
+    FlatMatrix<SIMD<double>> dvals(nnz, nip, lh);
+    IntegrationRule ir1;
+    BaseMappedIntegrationRule * mir1 = nullptr;
+    if (elementwise_constant)
+      {
+        ir1 = GetIntegrationRule(fel, lh).Range(0,1);
+        mir1 = &trafo(ir1, lh);
+      }
+    size_t row = 0;
+    for (size_t k1 : Range(trial_proxies))
+      for (size_t l1 : Range(test_proxies))
+        if (nonzeros_proxies(l1, k1))
+          for (size_t k : Range(trial_proxies[k1]->Dimension()))
+            for (size_t l : Range(test_proxies[l1]->Dimension()))
+              if (nonzeros(test_cum[l1]+l, trial_cum[k1]+k))
+                {
+                  ud.trialfunction = trial_proxies[k1];
+                  ud.trial_comp = k;
+                  ud.testfunction = test_proxies[l1];
+                  ud.test_comp = l;
+                  if (mir1)
+                    dvals.Row(row) = SIMD<double>(cf -> Evaluate ((*mir1)[0]));
+                  else
+                    cf -> Evaluate (mir, dvals.Rows(row, row+1));
+                  for (size_t q = 0; q < nip; q++)
+                    dvals(row, q) *= mir[q].GetWeight();
+                  row++;
+                }
+
+    FlatVector<SIMD<double>> work(elmat.Width()*maxdim2*nip, lh);
+    bool symmetric = symmetric_so_far && is_symmetric;
+    kernel (nip,
+            trial_bmats.Data(), trial_first.Data(), trial_ndof.Data(),
+            test_bmats.Data(), test_first.Data(), test_ndof.Data(),
+            dvals.Data(), work.Data(), symmetric, elmat.Data(), elmat.Width());
+
+    // the kernel keeps blocks symmetric only while all pairs are
+    for (size_t k1 : Range(trial_proxies))
+      for (size_t l1 : Range(test_proxies))
+        if (nonzeros_proxies(l1, k1))
+          symmetric &= diagonal_proxies(l1, k1) && same_diffops(l1, k1);
+    symmetric_so_far = symmetric;
+  }
+
+
   void 
   SymbolicBilinearFormIntegrator ::
   CalcElementMatrix (const FiniteElement & fel,
@@ -2135,8 +2400,7 @@ namespace ngfem
               ud.AssignMemory (proxy, ir.GetNIP(), proxy->Dimension(), lh);
               proxy->Evaluator()->Apply(fel_trial, mir, elveclin, ud.GetAMemory(proxy));
             }
-          for (CoefficientFunction * cf : gridfunction_cfs)
-            ud.AssignMemory (cf, ir.GetNIP(), cf->Dimension(), lh);
+          ud.PrepareGridFunctions (gridfunction_cfs, ir.GetNIP(), trafo, lh);
     
           // AFlatMatrix<> val(1, mir.IR().GetNIP(), lh);
           FlatMatrix<AutoDiff<1,SIMD<double>>> val(1, mir.Size(), lh);
@@ -2363,8 +2627,7 @@ namespace ngfem
                   ud.AssignMemory (proxy, ir_facet.GetNIP(), proxy->Dimension(), lh);
                   proxy->Evaluator()->Apply(fel, mir, elveclin, ud.GetAMemory(proxy));
                 }
-              for (CoefficientFunction * cf : gridfunction_cfs)
-                ud.AssignMemory (cf, ir_facet.GetNIP(), cf->Dimension(), lh);
+              ud.PrepareGridFunctions (gridfunction_cfs, ir_facet.GetNIP(), trafo, lh);
 
               FlatMatrix<AutoDiff<1,SIMD<double>>> val(1, mir.Size(), lh);
               
@@ -2577,8 +2840,7 @@ namespace ngfem
 
           for (ProxyFunction * proxy : trial_proxies)
             ud.AssignMemory (proxy, simd_ir.GetNIP(), proxy->Dimension(), lh);
-          for (CoefficientFunction * cf : gridfunction_cfs)
-            ud.AssignMemory (cf, simd_ir.GetNIP(), cf->Dimension(), lh);
+          ud.PrepareGridFunctions (gridfunction_cfs, simd_ir.GetNIP(), trafo, lh);
           
           for (ProxyFunction * proxy : trial_proxies)
             proxy->Evaluator()->Apply(fel_trial, simd_mir, elx, ud.GetAMemory(proxy)); 
@@ -2718,8 +2980,7 @@ namespace ngfem
           
               for (ProxyFunction * proxy : trial_proxies)
                 ud.AssignMemory (proxy, ir_facet.GetNIP(), proxy->Dimension(), lh);
-              for (CoefficientFunction * cf : gridfunction_cfs)
-                ud.AssignMemory (cf, ir_facet.GetNIP(), cf->Dimension(), lh);
+              ud.PrepareGridFunctions (gridfunction_cfs, ir_facet.GetNIP(), trafo, lh);
           
               for (ProxyFunction * proxy : trial_proxies)
                 proxy->Evaluator()->Apply(fel_trial, mir, elx, ud.GetAMemory(proxy)); 
@@ -3371,8 +3632,7 @@ namespace ngfem
             ud.fel = &fel1;   // necessary to check remember-map
             for (ProxyFunction * proxy : trial_proxies)
               ud.AssignMemory (proxy, simd_ir_facet.GetNIP(), proxy->Dimension(), lh);
-            for (CoefficientFunction * cf : gridfunction_cfs)
-              ud.AssignMemory (cf, simd_ir_facet.GetNIP(), cf->Dimension(), lh);
+            ud.PrepareGridFunctions (gridfunction_cfs, simd_ir_facet.GetNIP(), trafo1, lh);
             // tstart.Stop();
             // tapply.Start();
 
@@ -262,6 +262,14 @@ class ProxyUserData
   FlatArray<const CoefficientFunction*> remember_cf_first;
   FlatArray<FlatMatrix<SIMD<double>>> remember_cf_asecond;
   FlatArray<bool> remember_cf_computed;
+
+  // element vectors of gridfunctions, shared by all nodes of the same gf
+  FlatArray<const void*> remember_gf_first;
+  FlatArray<int> remember_gf_comp;
+  FlatArray<VorB> remember_gf_vb;
+  FlatArray<size_t> remember_gf_elnr;
+  FlatArray<const FiniteElement*> remember_gf_fel;
+  FlatArray<FlatVector<double>> remember_gf_elvec;
 public:
   class ProxyFunction * testfunction = nullptr;
   int test_comp;
@@ -274,14 +282,20 @@ public:
 
   ProxyUserData ()
     : remember_first(0,nullptr), remember_second(0,nullptr), remember_asecond(0,nullptr),
-      remember_cf_first(0, nullptr), remember_cf_asecond(0,nullptr), remember_cf_computed(0, nullptr)
+      remember_cf_first(0, nullptr), remember_cf_asecond(0,nullptr), remember_cf_computed(0, nullptr),
+      remember_gf_first(0, nullptr), remember_gf_comp(0, nullptr),
+      remember_gf_vb(0, nullptr), remember_gf_elnr(0, nullptr),
+      remember_gf_fel(0, nullptr), remember_gf_elvec(0, nullptr)
   { ; }
   ProxyUserData (size_t ntrial, size_t ncf, LocalHeap & lh)
     : remember_first(ntrial, lh), remember_second(ntrial, lh),
       remember_asecond(ntrial, lh),
       remember_cf_first(ncf, lh), remember_cf_asecond(ncf, lh),
-      remember_cf_computed(ncf, lh)
-  { remember_first = nullptr; remember_cf_first = nullptr; }
+      remember_cf_computed(ncf, lh),
+      remember_gf_first(ncf, lh), remember_gf_comp(ncf, lh),
+      remember_gf_vb(ncf, lh), remember_gf_elnr(ncf, lh),
+      remember_gf_fel(ncf, lh), remember_gf_elvec(ncf, lh)
+  { remember_first = nullptr; remember_cf_first = nullptr; remember_gf_first = nullptr; }
 
   ProxyUserData (int ntrial, LocalHeap & lh)
     : ProxyUserData (ntrial, 0, lh) { ; } 
@@ -376,6 +390,56 @@ public:
   {
     remember_cf_computed[remember_cf_first.PosSure(cf)] = val;
   }
+
+  // result memory and element data for the gridfunction-cfs of an integrand
+  void PrepareGridFunctions (FlatArray<CoefficientFunction*> cfs, size_t nip,
+                             const ElementTransformation & trafo, LocalHeap & lh)
+  {
+    for (CoefficientFunction * cf : cfs)
+      AssignMemory (cf, nip, cf->Dimension(), lh);
+    for (CoefficientFunction * cf : cfs)
+      cf->PrepareUserData (*this, trafo, lh);
+  }
+  
+  void AssignElementVector (const void * gf, int comp, ElementId ei,
+                            const FiniteElement * fel, FlatVector<double> elvec)
+  {
+    for (size_t i = 0; i < remember_gf_first.Size(); i++)
+      {
+        if (remember_gf_first[i] == nullptr ||
+            (remember_gf_first[i] == gf && remember_gf_comp[i] == comp))
+          {
+            remember_gf_first[i] = gf;
+            remember_gf_comp[i] = comp;
+            remember_gf_vb[i] = ei.VB();
+            remember_gf_elnr[i] = ei.Nr();
+            remember_gf_fel[i] = fel;
+            new (&remember_gf_elvec[i]) FlatVector<double> (elvec);
+            return;
+          }
+      }
+    throw Exception ("no space for userdata - memory available");
+  }
+  bool HasElementVector (const void * gf, int comp, ElementId ei) const
+  {
+    for (size_t i = 0; i < remember_gf_first.Size(); i++)
+      if (remember_gf_first[i] == gf && remember_gf_comp[i] == comp)
+        return remember_gf_vb[i] == ei.VB() && remember_gf_elnr[i] == ei.Nr();
+    return false;
+  }
+  // returns the element of the stored vector, or nullptr if not available
+  const FiniteElement * GetElementVector (const void * gf, int comp, ElementId ei,
+                                          FlatVector<double> & elvec) const
+  {
+    for (size_t i = 0; i < remember_gf_first.Size(); i++)
+      if (remember_gf_first[i] == gf && remember_gf_comp[i] == comp)
+        {
+          if (remember_gf_vb[i] != ei.VB() || remember_gf_elnr[i] != ei.Nr()) return nullptr;
+          elvec.AssignMemory (remember_gf_elvec[i].Size(), remember_gf_elvec[i].Data());
+          return remember_gf_fel[i];
+        }
+    return nullptr;
+  }
 };
 
   
@@ -652,6 +716,25 @@ public:
 
     int trial_difforder, test_difforder;
     bool is_symmetric;
+
+    // element matrix kernel generated for the proxy dimensions and nonzero pattern
+    typedef void (*lib_elmat_kernel) (size_t nip,
+                                      const SIMD<double> * const * trial_bmats, const size_t * trial_first, const size_t * trial_ndof,
+                                      const SIMD<double> * const * test_bmats, const size_t * test_first, const size_t * test_ndof,
+                                      const SIMD<double> * dvals, SIMD<double> * work,
+                                      bool symmetric, double * elmat, size_t dist);
+    struct CompiledKernel
+    {
+      unique_ptr<SharedLibrary> library;
+      lib_elmat_kernel function = nullptr;
+    };
+    // the current kernel is replaced by atomic_store when a compilation is finished,
+    // assembling threads keep their copy (and the library) alive during the call
+    struct CompiledKernelSlot
+    {
+      shared_ptr<CompiledKernel> kernel;
+    };
+    shared_ptr<CompiledKernelSlot> compiled_kernel = make_shared<CompiledKernelSlot>();
   public:
     NGS_DLL_HEADER SymbolicBilinearFormIntegrator (shared_ptr<CoefficientFunction> acf, VorB avb,
                                                    VorB aelement_boundary);
@@ -708,6 +791,22 @@ public:
                                    const ElementTransformation & trafo, 
                                    FlatMatrix<SCAL_RES> elmat,
                                    LocalHeap & lh) const;
+
+    /// C++ code of the element matrix kernel, empty if not supported
+    NGS_DLL_HEADER string GenerateElementMatrixCode () const;
+    /// compiles the kernel, the generic version is used until it is loaded
+    NGS_DLL_HEADER void CompileElementMatrix (bool wait = false);
+    shared_ptr<CompiledKernel> GetCompiledKernel () const
+    { return std::atomic_load (&compiled_kernel->kernel); }
+    bool HasCompiledElementMatrix () const
+    { return GetCompiledKernel() != nullptr; }
+
+    void CalcElementMatrixAddCompiled (lib_elmat_kernel kernel,
+                                       const FiniteElement & fel,
+                                       const SIMD_BaseMappedIntegrationRule & mir,
+                                       FlatMatrix<double> elmat,
+                                       bool & symmetric_so_far,
+                                       LocalHeap & lh) const;
     
     NGS_DLL_HEADER virtual void 
     CalcLinearizedElementMatrix (const FiniteElement & fel,
@@ -35,6 +35,9 @@ namespace ngfem
     HD virtual ELEMENT_TYPE ElementType() const final { return ET; }
     // HD NGS_DLL_HEADER virtual int Dim () const override { return DIM; } 
 
+    /// orientation class for the SIMD_ShapeCache, false if shapes are not cached
+    INLINE bool GetShapeCacheClass (size_t & classnr) const { return false; }
+
     
     HD NGS_DLL_HEADER virtual void CalcShape (const IntegrationPoint & ip, 
 					      BareSliceVector<> shape) const override;
@@ -125,7 +128,11 @@ namespace ngfem
     HD NGS_DLL_HEADER 
     virtual void CalcMappedDShape (const SIMD_BaseMappedIntegrationRule & mir, 
                                    BareSliceMatrix<SIMD<double>> dshapes) const override;
-    
+
+  protected:
+    /// tabulated shapes (or reference gradients) on a global rule, nullptr if not available
+    const Matrix<> * GetCachedShapes (const SIMD_IntegrationRule & ir, bool grad) const;
+  public:
 #endif
 
     /// compute dshape, matrix: ndof x (spacedim spacedim)
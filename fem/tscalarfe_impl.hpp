@@ -37,10 +37,54 @@ namespace ngfem
       T_CalcShape (GetTIP<DIM>(ir[i]), shape.Col(i));        
   }
 
+  template <class FEL, ELEMENT_TYPE ET, class BASE>
+  const Matrix<> * T_ScalarFiniteElement<FEL,ET,BASE> :: 
+  GetCachedShapes (const SIMD_IntegrationRule & ir, bool grad) const
+  {
+    auto & cache = SIMD_ShapeCache::Instance();
+    size_t classnr;
+    if (!cache.IsEnabled() || !ir.IsGlobal() ||
+        !static_cast<const FEL*> (this) -> GetShapeCacheClass (classnr))
+      return nullptr;
+
+    constexpr size_t SW = SIMD<double>::Size();
+    size_t nip = ir.Size();
+    SIMD_ShapeCache::Key key { typeid(FEL).hash_code(), classnr, ir.Data(),
+                               int(ET), int(order), int(ndof), grad };
+
+    return cache.Get
+      (key, ndof, (grad ? DIM : 1) * nip * SW,
+       [&] (SliceMatrix<> table)
+       {
+         if (!grad)
+           for (size_t i = 0; i < nip; i++)
+             T_CalcShape (GetTIP<DIM>(ir[i]),
+                          SBLambda ([&](size_t j, SIMD<double> shape)
+                                    { shape.Store (&table(j, i*SW)); }));
+         else
+           for (size_t i = 0; i < nip; i++)
+             T_CalcShape (GetTIPGrad<DIM>(ir[i]),
+                          SBLambda ([&](size_t j, auto shape)
+                                    {
+                                      auto gradj = ngbla::GetGradient(shape);
+                                      for (int k = 0; k < DIM; k++)
+                                        gradj(k).Store (&table(j, (k*nip+i)*SW));
+                                    }));
+       });
+  }
+
   template <class FEL, ELEMENT_TYPE ET, class BASE>
   void T_ScalarFiniteElement<FEL,ET,BASE> :: 
   CalcShape (const SIMD_IntegrationRule & ir, BareSliceMatrix<SIMD<double>> shapes) const
   {
+    if (auto table = GetCachedShapes (ir, false))
+      {
+        constexpr size_t SW = SIMD<double>::Size();
+        for (size_t j = 0; j < ndof; j++)
+          for (size_t i = 0; i < ir.Size(); i++)
+            shapes(j,i) = SIMD<double> (&(*table)(j, i*SW));
+        return;
+      }
     /*
     for (size_t i = 0; i < ir.Size(); i++)
       T_CalcShape (GetTIP<DIM>(ir[i]),
@@ -80,6 +124,18 @@ namespace ngfem
   void T_ScalarFiniteElement<FEL,ET,BASE> :: 
   Evaluate (const SIMD_IntegrationRule & ir, BareSliceVector<> coefs, BareVector<SIMD<double>> values) const
   {
+    if (auto table = GetCachedShapes (ir, false))
+      {
+        constexpr size_t SW = SIMD<double>::Size();
+        STACK_ARRAY(double, mem, ndof);
+        FlatVector<> hcoefs(ndof, &mem[0]);
+        for (size_t j = 0; j < ndof; j++)
+          hcoefs(j) = coefs(j);
+        MultMatTransVec (*table, hcoefs,
+                         FlatVector<> (ir.Size()*SW, reinterpret_cast<double*> (&values(0))));
+        return;
+      }
+
     FlatArray<SIMD<IntegrationPoint>> hir = ir;
     size_t i = 0;
     for ( ; i+2 <= hir.Size(); i+=2)
@@ -121,6 +177,15 @@ namespace ngfem
             SliceMatrix<> coefs,
             BareSliceMatrix<SIMD<double>> values) const
   {
+    if (auto table = GetCachedShapes (ir, false))
+      {
+        constexpr size_t SW = SIMD<double>::Size();
+        SliceMatrix<> hvalues(coefs.Width(), ir.Size()*SW, SW*values.Dist(),
+                              reinterpret_cast<double*> (&values(0,0)));
+        hvalues = Trans(coefs) * *table;
+        return;
+      }
+
     FlatArray<SIMD<IntegrationPoint>> hir = ir;    
     size_t j = 0;
     for ( ; j+4 <= coefs.Width(); j+=4)
@@ -231,6 +296,18 @@ namespace ngfem
   AddTrans (const SIMD_IntegrationRule & ir, BareVector<SIMD<double>> values,
             BareSliceVector<> coefs) const
   {
+    if (auto table = GetCachedShapes (ir, false))
+      {
+        constexpr size_t SW = SIMD<double>::Size();
+        STACK_ARRAY(double, mem, ndof);
+        FlatVector<> hcoefs(ndof, &mem[0]);
+        MultMatVec (*table, FlatVector<> (ir.Size()*SW, reinterpret_cast<double*> (&values(0))),
+                    hcoefs);
+        for (size_t j = 0; j < ndof; j++)
+          coefs(j) += hcoefs(j);
+        return;
+      }
+
     FlatArray<SIMD<IntegrationPoint>> hir = ir;
     /*
     for (int i = 0; i < hir.Size(); i++)
@@ -332,6 +409,15 @@ namespace ngfem
             BareSliceMatrix<SIMD<double>> values,
             SliceMatrix<> coefs) const
   {
+    if (auto table = GetCachedShapes (ir, false))
+      {
+        constexpr size_t SW = SIMD<double>::Size();
+        SliceMatrix<> hvalues(coefs.Width(), ir.Size()*SW, SW*values.Dist(),
+                              reinterpret_cast<double*> (&values(0,0)));
+        coefs += *table * Trans(hvalues);
+        return;
+      }
+
     FlatArray<SIMD<IntegrationPoint>> hir = ir;    
     size_t j = 0;
     for ( ; j+4 <= coefs.Width(); j+=4)
@@ -484,6 +570,25 @@ namespace ngfem
                 BareSliceVector<> coefs,
                 BareSliceMatrix<SIMD<double>> values) const
   {
+    if constexpr (DIM > 0)
+      if (GetCachedShapes (bmir.IR(), true))
+        {
+          // reference gradients from the table, mapped in place
+          EvaluateGrad (bmir.IR(), coefs, values);
+          Switch<4-DIM>
+            (bmir.DimSpace()-DIM, [&bmir,values] (auto CODIM)
+             {
+               constexpr int DIMSPACE = DIM+CODIM.value;
+               auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIMSPACE>&> (bmir);
+               for (size_t i = 0; i < mir.Size(); i++)
+                 {
+                   Vec<DIM,SIMD<double>> refgrad = values.Col(i).Range(DIM);
+                   values.Col(i).Range(DIMSPACE) = Trans(mir[i].GetJacobianInverse()) * refgrad;
+                 }
+             });
+          return;
+        }
+    
     Switch<4-DIM>
       (bmir.DimSpace()-DIM, [this,&bmir,coefs,values] (auto CODIM)
        {
@@ -514,6 +619,20 @@ namespace ngfem
                 BareSliceVector<> coefs,
                 BareSliceMatrix<SIMD<double>> values) const
   {
+    if (auto table = GetCachedShapes (ir, true))
+      {
+        constexpr size_t SW = SIMD<double>::Size();
+        size_t nip = ir.Size();
+        STACK_ARRAY(double, mem, ndof);
+        FlatVector<> hcoefs(ndof, &mem[0]);
+        for (size_t j = 0; j < ndof; j++)
+          hcoefs(j) = coefs(j);
+        for (int k = 0; k < DIM; k++)
+          MultMatTransVec (table->Cols(k*nip*SW, (k+1)*nip*SW), hcoefs,
+                           FlatVector<> (nip*SW, reinterpret_cast<double*> (&values(k,0))));
+        return;
+      }
+
     for (int i = 0; i < ir.Size(); i++)
       {
         Vec<DIM,SIMD<double>> sum(0.0);
@@ -566,6 +685,37 @@ namespace ngfem
                 BareSliceVector<> coefs) const
   {
     if constexpr (DIM == 0) return;
+    if constexpr (DIM > 0)
+      if (auto table = GetCachedShapes (bmir.IR(), true))
+        {
+          // pulled back to reference gradients, then one product per direction
+          constexpr size_t SW = SIMD<double>::Size();
+          size_t nip = bmir.Size();
+          STACK_ARRAY(SIMD<double>, memref, DIM*nip);
+          FlatMatrix<SIMD<double>> refvals(DIM, nip, &memref[0]);
+          Switch<4-DIM>
+            (bmir.DimSpace()-DIM, [&bmir,values,refvals] (auto CODIM)
+             {
+               constexpr int DIMSPACE = DIM+CODIM.value;
+               auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIMSPACE>&> (bmir);
+               for (size_t i = 0; i < mir.Size(); i++)
+                 {
+                   Vec<DIMSPACE,SIMD<double>> vali = values.Col(i).Range(DIMSPACE);
+                   refvals.Col(i) = mir[i].GetJacobianInverse() * vali;
+                 }
+             });
+          STACK_ARRAY(double, mem, ndof);
+          FlatVector<> hcoefs(ndof, &mem[0]);
+          for (int k = 0; k < DIM; k++)
+            {
+              MultMatVec (table->Cols(k*nip*SW, (k+1)*nip*SW),
+                          FlatVector<> (nip*SW, reinterpret_cast<double*> (&refvals(k,0))),
+                          hcoefs);
+              for (size_t j = 0; j < ndof; j++)
+                coefs(j) += hcoefs(j);
+            }
+          return;
+        }
     Iterate<4-DIM>
       ([&](auto CODIM)
        {
@@ -608,6 +758,15 @@ namespace ngfem
                 BareSliceMatrix<SIMD<double>> values,
                 SliceMatrix<> coefs) const
   {
+    if constexpr (DIM > 0)
+      if (GetCachedShapes (bmir.IR(), true))
+        {
+          for (size_t j = 0; j < coefs.Width(); j++)
+            AddGradTrans (bmir, values.Rows(j*bmir.DimSpace(), (j+1)*bmir.DimSpace()),
+                          coefs.Col(j));
+          return;
+        }
+    
     Iterate<4-DIM>
       ([&](auto CODIM)
        {
@@ -746,6 +905,34 @@ namespace ngfem
   CalcMappedDShape (const SIMD_BaseMappedIntegrationRule & bmir, 
                     BareSliceMatrix<SIMD<double>> dshapes) const
   {
+   if constexpr (DIM > 0)
+     if (auto table = GetCachedShapes (bmir.IR(), true))
+       {
+         // mapped from the tabulated reference gradients
+         constexpr size_t SW = SIMD<double>::Size();
+         size_t nip = bmir.Size();
+         Switch<4-DIM>
+           (bmir.DimSpace()-DIM, [&] (auto CODIM)
+            {
+              constexpr int DIMSPACE = DIM+CODIM.value;
+              auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIMSPACE>&> (bmir);
+              for (size_t i = 0; i < nip; i++)
+                {
+                  auto jacinv = mir[i].GetJacobianInverse();
+                  for (size_t j = 0; j < ndof; j++)
+                    {
+                      Vec<DIM,SIMD<double>> refgrad;
+                      for (int k = 0; k < DIM; k++)
+                        refgrad(k) = SIMD<double> (&(*table)(j, (k*nip+i)*SW));
+                      Vec<DIMSPACE,SIMD<double>> grad = Trans(jacinv) * refgrad;
+                      for (int k = 0; k < DIMSPACE; k++)
+                        dshapes(j*DIMSPACE+k, i) = grad(k);
+                    }
+                }
+            });
+         return;
+       }
+    
    if (bmir.DimSpace() == DIM)
       {
         auto & mir = static_cast<const SIMD_MappedIntegrationRule<DIM,DIM>&> (bmir);
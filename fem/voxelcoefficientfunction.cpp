@@ -1,78 +1,192 @@
-
 #include "voxelcoefficientfunction.hpp"
 
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace ngfem
 {
+  size_t VoxelStorageSize (VoxelStorage storage, bool complex)
+  {
+    switch (storage)
+      {
+      case VoxelStorage::NATIVE: return complex ? sizeof(Complex) : sizeof(double);
+      case VoxelStorage::FLOAT32: return sizeof(float);
+      case VoxelStorage::UINT8: return sizeof(uint8_t);
+      case VoxelStorage::UINT16: return sizeof(uint16_t);
+      }
+    return 0;
+  }
+
   template<typename T>
-  T VoxelCoefficientFunction<T> :: T_Evaluate(const BaseMappedIntegrationPoint& ip) const
+  void VoxelCoefficientFunction<T> :: CheckSizes() const
   {
-    auto pnt = ip.GetPoint();
-    if (trafocf)
-      trafocf->Evaluate(ip,pnt);
-    
-    ArrayMem<size_t, 3> ind;
-    ArrayMem<double, 3> weight;
-    for(auto i : Range(start))
+    if (start.Size() == 0 || start.Size() > 3 || end.Size() != start.Size() ||
+        dim_vals.Size() != start.Size())
+      throw Exception("VoxelCoefficient: start, end and values must have the same dimension 1, 2 or 3");
+    if (is_same_v<T, Complex> && storage != VoxelStorage::NATIVE)
+      throw Exception("VoxelCoefficient: complex values must be stored as complex128");
+    for (auto n : dim_vals)
+      if (n < (linear ? 2 : 1))
+        throw Exception("VoxelCoefficient: too few values in one direction");
+  }
+
+  template<typename T> template <typename FUNC>
+  void VoxelCoefficientFunction<T> :: Dispatch (FUNC func) const
+  {
+    switch (storage)
+      {
+      case VoxelStorage::NATIVE: func (static_cast<const T*>(data)); break;
+      case VoxelStorage::FLOAT32: func (static_cast<const float*>(data)); break;
+      case VoxelStorage::UINT8: func (static_cast<const uint8_t*>(data)); break;
+      case VoxelStorage::UINT16: func (static_cast<const uint16_t*>(data)); break;
+      }
+  }
+
+  template<typename T> template <typename TRAW>
+  T VoxelCoefficientFunction<T> :: T_Evaluate(const TRAW * raw, const double * pnt) const
+  {
+    size_t D = start.Size();
+    size_t ind[3];
+    double weight[3];
+    for(auto i : Range(D))
       {
         auto nvals = linear ? dim_vals[i] - 1 : dim_vals[i];
         double len = (end[i] - start[i])/nvals;
         double coord = min2(end[i], max2(start[i], pnt[i]));
-        if(!linear && coord == end[i])
-          coord *= (1-1e-12);
         double pos = (coord - start[i])/len;
-        ind.Append(pos);
-        if(linear)
-          weight.Append(1.-(pos-ind[i]));
+        ind[i] = min2(size_t(pos), dim_vals[i]-1);
+        weight[i] = 1.-(pos-ind[i]);
       }
 
     if(!linear)
       {
         size_t offset = dim_vals[0];
         size_t index = ind[0];
-        for(auto i : IntRange(1,ind.Size()))
+        for(auto i : IntRange(1,D))
           {
             index += offset * ind[i];
             offset *= dim_vals[i];
           }
-        return values[index];
+        return Value(raw, index);
       }
 
-    Array<size_t> indices(pow(2, ind.Size()));
-    Array<double> tot_weight(indices.Size());
+    // corner c takes the upper neighbour in direction i if bit i is set
+    T result = 0.;
+    for (size_t c = 0; c < (size_t(1) << D); c++)
+      {
+        size_t index = 0, offset = 1;
+        double w = 1;
+        for (auto i : Range(D))
+          {
+            bool upper = c & (size_t(1) << i);
+            index += offset * (upper ? min2(ind[i]+1, dim_vals[i]-1) : ind[i]);
+            w *= upper ? 1.-weight[i] : weight[i];
+            offset *= dim_vals[i];
+          }
+        result += w * Value(raw, index);
+      }
+    return result;
+  }
+
+  // the values of the lanes
+  template <typename T, typename FUNC>
+  INLINE SIMD<T> GatherSIMD (FUNC value)
+  {
+    if constexpr (is_same_v<T, double>)
+      return SIMD<double> ([&] (int k) { return value(k); });
+    else
+      return SIMD<Complex> (SIMD<double> ([&] (int k) { return value(k).real(); }),
+                            SIMD<double> ([&] (int k) { return value(k).imag(); }));
+  }
 
-    indices[0] = ind[0];
-    indices[1] = min2(ind[0]+1, dim_vals[0]-1);
-    tot_weight[0] = weight[0];
-    tot_weight[1] = 1.-weight[0];
-    size_t offset = dim_vals[0];
-    size_t indsize = 2;
+  template<typename T> template <typename TRAW>
+  void VoxelCoefficientFunction<T> :: T_Evaluate(const TRAW * raw, const SIMD_BaseMappedIntegrationRule & ir,
+                                                 BareSliceMatrix<SIMD<T>> values) const
+  {
+    constexpr int W = SIMD<double>::Size();
+    size_t D = start.Size();
 
-    for(auto i : IntRange(1, ind.Size()))
+    ArrayMem<SIMD<double>, 64> trafomem(trafocf ? trafocf->Dimension()*ir.Size() : 0);
+    FlatMatrix<SIMD<double>> trafopnts(trafocf ? trafocf->Dimension() : 0, ir.Size(), trafomem.Data());
+    if (trafocf)
+      trafocf->Evaluate (ir, trafopnts);
+    auto points = ir.GetPoints();
+    // missing coordinates are 0, as in the scalar version
+    size_t dimx = trafocf ? trafocf->Dimension() : ir.DimSpace();
+
+    for (size_t ii = 0; ii < ir.Size(); ii++)
       {
-        for(auto j : Range(indsize))
+        SIMD<double> weight[3];
+        size_t ind[3][W];
+        for (auto i : Range(D))
           {
-            auto indplus1 = min2(ind[i]+1, dim_vals[i]-1);
-            indices[indsize + j] = offset * indplus1 + indices[j];
-            indices[j] += offset * ind[i];
-            tot_weight[indsize + j] = (1.-weight[i]) * tot_weight[j];
-            tot_weight[j] *= weight[i];
+            auto nvals = linear ? dim_vals[i] - 1 : dim_vals[i];
+            double len = (end[i] - start[i])/nvals;
+            SIMD<double> coord = 0.;
+            if (i < dimx)
+              coord = trafocf ? trafopnts(i,ii) : points(ii,i);
+            coord = IfPos (coord-end[i], SIMD<double>(end[i]), coord);
+            coord = IfPos (start[i]-coord, SIMD<double>(start[i]), coord);
+            SIMD<double> pos = (coord - start[i])/len;
+            SIMD<double> fpos = floor(pos);
+            fpos = IfPos (fpos-double(dim_vals[i]-1), SIMD<double>(double(dim_vals[i]-1)), fpos);
+            weight[i] = 1.-(pos-fpos);
+            for (int k = 0; k < W; k++)
+              ind[i][k] = size_t(fpos[k]);
           }
-        indsize *= 2;
-        offset *= dim_vals[i];
-      }
 
-    T result = 0.;
-    for(auto i : Range(indices))
-      result += tot_weight[i] * values[indices[i]];
+        if (!linear)
+          {
+            values(0,ii) = GatherSIMD<T> ([&] (int k)
+              {
+                size_t index = 0, offset = 1;
+                for (auto i : Range(D))
+                  {
+                    index += offset * ind[i][k];
+                    offset *= dim_vals[i];
+                  }
+                return Value(raw, index);
+              });
+            continue;
+          }
 
-    return result;
+        SIMD<T> result = 0.;
+        for (size_t c = 0; c < (size_t(1) << D); c++)
+          {
+            SIMD<double> w = 1.;
+            for (auto i : Range(D))
+              w *= (c & (size_t(1) << i)) ? 1.-weight[i] : weight[i];
+            result += w * GatherSIMD<T> ([&] (int k)
+              {
+                size_t index = 0, offset = 1;
+                for (auto i : Range(D))
+                  {
+                    size_t indi = ind[i][k];
+                    if (c & (size_t(1) << i))
+                      indi = min2(indi+1, dim_vals[i]-1);
+                    index += offset * indi;
+                    offset *= dim_vals[i];
+                  }
+                return Value(raw, index);
+              });
+          }
+        values(0,ii) = result;
+      }
   }
 
   template<typename T>
   Complex VoxelCoefficientFunction<T> :: EvaluateComplex(const BaseMappedIntegrationPoint& ip) const
   {
     if constexpr(is_same_v<T, Complex>)
-      return T_Evaluate(ip);
+      {
+        Vector<Complex> res(1);
+        Evaluate (ip, res);
+        return res(0);
+      }
     throw Exception("Complex evaluate for real VoxelCoefficient called!");
   }
 
@@ -81,7 +195,12 @@ namespace ngfem
   {
     if constexpr(is_same_v<T, Complex>)
       {
-        values = T_Evaluate(mip);
+        Vec<3> pnt = 0.;
+        if (trafocf)
+          trafocf->Evaluate(mip, pnt.Range(0, trafocf->Dimension()));
+        else
+          pnt.Range(0, mip.GetPoint().Size()) = mip.GetPoint();
+        Dispatch ([&] (auto raw) { values = T_Evaluate(raw, &pnt(0)); });
         return;
       }
     throw Exception("Complex evaluate for real VoxelCoefficient called!");
@@ -91,10 +210,148 @@ namespace ngfem
   double VoxelCoefficientFunction<T> :: Evaluate(const BaseMappedIntegrationPoint& ip) const
   {
     if constexpr(is_same_v<T, double>)
-      return T_Evaluate(ip);
+      {
+        Vec<3> pnt = 0.;
+        if (trafocf)
+          trafocf->Evaluate(ip, pnt.Range(0, trafocf->Dimension()));
+        else
+          pnt.Range(0, ip.GetPoint().Size()) = ip.GetPoint();
+        double result;
+        Dispatch ([&] (auto raw) { result = T_Evaluate(raw, &pnt(0)); });
+        return result;
+      }
     throw Exception("Real evaluate for complex VoxelCoefficient called!");
   }
 
+  template<typename T>
+  void VoxelCoefficientFunction<T> :: Evaluate(const BaseMappedIntegrationRule & ir,
+                                               BareSliceMatrix<double> values) const
+  {
+    if constexpr(is_same_v<T, double>)
+      {
+        Matrix<> trafopnts(trafocf ? ir.Size() : 0, trafocf ? trafocf->Dimension() : 0);
+        if (trafocf)
+          trafocf->Evaluate (ir, trafopnts);
+        auto points = ir.GetPoints();
+        Dispatch ([&] (auto raw)
+          {
+            Vec<3> pnt = 0.;
+            for (size_t i = 0; i < ir.Size(); i++)
+              {
+                if (trafocf)
+                  pnt.Range(0, trafopnts.Width()) = trafopnts.Row(i);
+                else
+                  pnt.Range(0, points.Width()) = points.Row(i);
+                values(i,0) = T_Evaluate(raw, &pnt(0));
+              }
+          });
+        return;
+      }
+    throw Exception("Real evaluate for complex VoxelCoefficient called!");
+  }
+
+  template<typename T>
+  void VoxelCoefficientFunction<T> :: Evaluate(const BaseMappedIntegrationRule & ir,
+                                               BareSliceMatrix<Complex> values) const
+  {
+    if constexpr(is_same_v<T, Complex>)
+      {
+        Matrix<> trafopnts(trafocf ? ir.Size() : 0, trafocf ? trafocf->Dimension() : 0);
+        if (trafocf)
+          trafocf->Evaluate (ir, trafopnts);
+        auto points = ir.GetPoints();
+        Dispatch ([&] (auto raw)
+          {
+            Vec<3> pnt = 0.;
+            for (size_t i = 0; i < ir.Size(); i++)
+              {
+                if (trafocf)
+                  pnt.Range(0, trafopnts.Width()) = trafopnts.Row(i);
+                else
+                  pnt.Range(0, points.Width()) = points.Row(i);
+                values(i,0) = T_Evaluate(raw, &pnt(0));
+              }
+          });
+        return;
+      }
+    // real values as complex
+    CoefficientFunctionNoDerivative::Evaluate (ir, values);
+  }
+
+  template<typename T>
+  void VoxelCoefficientFunction<T> :: Evaluate(const SIMD_BaseMappedIntegrationRule & ir,
+                                               BareSliceMatrix<SIMD<double>> values) const
+  {
+    if constexpr(is_same_v<T, double>)
+      {
+        Dispatch ([&] (auto raw) { T_Evaluate (raw, ir, values); });
+        return;
+      }
+    throw ExceptionNOSIMD("Real evaluate for complex VoxelCoefficient called!");
+  }
+
+  template<typename T>
+  void VoxelCoefficientFunction<T> :: Evaluate(const SIMD_BaseMappedIntegrationRule & ir,
+                                               BareSliceMatrix<SIMD<Complex>> values) const
+  {
+    if constexpr(is_same_v<T, Complex>)
+      {
+        Dispatch ([&] (auto raw) { T_Evaluate (raw, ir, values); });
+        return;
+      }
+    CoefficientFunctionNoDerivative::Evaluate (ir, values);
+  }
+
   template class VoxelCoefficientFunction<double>;
   template class VoxelCoefficientFunction<Complex>;
+
+
+  shared_ptr<CoefficientFunction>
+  LoadVoxelCoefficientFunction (const string & filename, size_t offset,
+                                const Array<double> & start, const Array<double> & end,
+                                const Array<size_t> & dim_vals,
+                                VoxelStorage storage, bool complex,
+                                double scale, double shift, bool linear,
+                                shared_ptr<CoefficientFunction> trafo)
+  {
+    size_t nvals = 1;
+    for (auto n : dim_vals)
+      nvals *= n;
+    size_t size = offset + nvals * VoxelStorageSize(storage, complex);
+
+    shared_ptr<void> owner;
+    const char * data;
+#ifndef WIN32
+    int fd = open (filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw Exception ("VoxelCoefficient: cannot open file " + filename);
+    struct stat st;
+    if (fstat (fd, &st) != 0 || size_t(st.st_size) < size)
+      {
+        close (fd);
+        throw Exception ("VoxelCoefficient: file " + filename + " has less than "
+                         + ToString(size) + " bytes");
+      }
+    void * ptr = mmap (nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close (fd);
+    if (ptr == MAP_FAILED)
+      throw Exception ("VoxelCoefficient: cannot map file " + filename);
+    madvise (ptr, size, MADV_WILLNEED);
+    owner = shared_ptr<void> (ptr, [size] (void * p) { munmap (p, size); });
+    data = static_cast<const char*>(ptr) + offset;
+#else
+    auto buffer = make_shared<Array<char>> (size);
+    ifstream in (filename, ios::binary);
+    if (!in.read (buffer->Data(), size))
+      throw Exception ("VoxelCoefficient: cannot read " + ToString(size) + " bytes from " + filename);
+    owner = buffer;
+    data = buffer->Data() + offset;
+#endif
+
+    if (complex)
+      return make_shared<VoxelCoefficientFunction<Complex>>
+        (start, end, dim_vals, owner, data, storage, scale, shift, linear, trafo);
+    return make_shared<VoxelCoefficientFunction<double>>
+      (start, end, dim_vals, owner, data, storage, scale, shift, linear, trafo);
+  }
 } // namespace ngfem
@@ -5,12 +5,22 @@
 
 namespace ngfem
 {
+  /// type of the stored voxel values, the value is shift + scale * stored value
+  enum class VoxelStorage { NATIVE, FLOAT32, UINT8, UINT16 };
+
+  NGS_DLL_HEADER size_t VoxelStorageSize (VoxelStorage storage, bool complex);
+
   template<typename SCAL>
   class VoxelCoefficientFunction : public CoefficientFunctionNoDerivative
   {
     Array<double> start, end;
     Array<size_t> dim_vals;
     Array<SCAL> values;
+    // owner of external (e.g. memory mapped) data
+    shared_ptr<void> data_owner;
+    const void * data;
+    VoxelStorage storage;
+    double scale = 1, shift = 0;
     bool linear;
     shared_ptr<CoefficientFunction> trafocf;
   public:
@@ -22,8 +32,23 @@ namespace ngfem
                              shared_ptr<CoefficientFunction> trafo=nullptr)
       : CoefficientFunctionNoDerivative(1, is_same_v<SCAL, Complex>),
         start(_start), end(_end), dim_vals(_dim_vals),
-        values(move(_values)), linear(_linear), trafocf(trafo)
-    { ; }
+        values(move(_values)), data(values.Data()), storage(VoxelStorage::NATIVE),
+        linear(_linear), trafocf(trafo)
+    { CheckSizes(); }
+
+    /// values stored in external memory, kept alive by owner
+    VoxelCoefficientFunction(const Array<double>& _start,
+                             const Array<double>& _end,
+                             const Array<size_t>& _dim_vals,
+                             shared_ptr<void> owner, const void * _data,
+                             VoxelStorage _storage, double _scale, double _shift,
+                             bool _linear,
+                             shared_ptr<CoefficientFunction> trafo=nullptr)
+      : CoefficientFunctionNoDerivative(1, is_same_v<SCAL, Complex>),
+        start(_start), end(_end), dim_vals(_dim_vals),
+        data_owner(owner), data(_data), storage(_storage),
+        scale(_scale), shift(_shift), linear(_linear), trafocf(trafo)
+    { CheckSizes(); }
 
     using CoefficientFunctionNoDerivative::Evaluate;
     double Evaluate(const BaseMappedIntegrationPoint& ip) const override;
@@ -31,9 +56,47 @@ namespace ngfem
 
     void Evaluate(const BaseMappedIntegrationPoint& mip, FlatVector<Complex> values) const override;
 
+    void Evaluate(const BaseMappedIntegrationRule & ir, BareSliceMatrix<double> values) const override;
+    void Evaluate(const BaseMappedIntegrationRule & ir, BareSliceMatrix<Complex> values) const override;
+    void Evaluate(const SIMD_BaseMappedIntegrationRule & ir, BareSliceMatrix<SIMD<double>> values) const override;
+    void Evaluate(const SIMD_BaseMappedIntegrationRule & ir, BareSliceMatrix<SIMD<Complex>> values) const override;
+
   private:
-    SCAL T_Evaluate(const BaseMappedIntegrationPoint& ip) const;
+    void CheckSizes() const;
+
+    // calls func with the typed pointer to the stored values
+    template <typename FUNC>
+    void Dispatch (FUNC func) const;
+
+    template <typename TRAW>
+    SCAL Value (const TRAW * raw, size_t i) const
+    {
+      if constexpr (is_same_v<TRAW, SCAL>)
+        return shift + scale * raw[i];
+      else
+        return shift + scale * double(raw[i]);
+    }
+
+    template <typename TRAW>
+    SCAL T_Evaluate(const TRAW * raw, const double * pnt) const;
+
+    template <typename TRAW>
+    void T_Evaluate(const TRAW * raw, const SIMD_BaseMappedIntegrationRule & ir,
+                    BareSliceMatrix<SIMD<SCAL>> values) const;
   };
+
+  /**
+     Voxel coefficient with values read from a raw file. The file is
+     memory mapped and not copied, the values start at byte offset in
+     the file, with the first coordinate running fastest.
+   */
+  NGS_DLL_HEADER shared_ptr<CoefficientFunction>
+  LoadVoxelCoefficientFunction (const string & filename, size_t offset,
+                                const Array<double> & start, const Array<double> & end,
+                                const Array<size_t> & dim_vals,
+                                VoxelStorage storage, bool complex,
+                                double scale, double shift, bool linear,
+                                shared_ptr<CoefficientFunction> trafo = nullptr);
 } // namespace ngfem
 
 #endif // NGSOLVE_VOXELCOEFFICIENTFUNCTION_HPP
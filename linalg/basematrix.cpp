@@ -285,6 +285,14 @@ namespace ngla
   }
 
 
+  double Residual (const BaseMatrix & a, const BaseVector & u,
+                   const BaseVector & f, BaseVector & r)
+  {
+    a.Mult (u, r);
+    return sqrt (r.ScaleAddNorm2 (-1, f));
+  }
+
+
 
   string GetInverseName (INVERSETYPE type)
   {
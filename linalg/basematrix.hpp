@@ -237,6 +237,10 @@ namespace ngla
     return VMatVecExpr (a, b);
   }
 
+  /// r = f - a u, returns the norm of r, with one sweep over r after the product
+  NGS_DLL_HEADER double Residual (const BaseMatrix & a, const BaseVector & u,
+                                  const BaseVector & f, BaseVector & r);
+
 
 
   class DynamicMatVecExpression : public DynamicBaseExpression
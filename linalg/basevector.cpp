@@ -11,6 +11,7 @@
 #define FILE_BASEVECTOR_CPP
 
 #include <la.hpp>
+#include <random>
 
 #ifdef PARALLEL
 #include "../parallel/parallelvector.hpp"
@@ -73,7 +74,9 @@ namespace ngla
 
   BaseVector & BaseVector :: Scale (Complex scal)
   {
-    FVComplex() *= scal;
+    auto me = FVComplex();
+    ParallelForRange (me.Size(),
+                      [me,scal] (IntRange r) { me.Range(r) *= scal; });
     return *this;
   }
 
@@ -95,7 +98,9 @@ namespace ngla
 
   BaseVector & BaseVector :: SetScalar (Complex scal)
   {
-    FVComplex() = scal;
+    auto me = FVComplex();
+    ParallelForRange (me.Size(),
+                      [me,scal] (IntRange r) { me.Range(r) = scal; });
     return *this;
   }
 
@@ -127,10 +132,19 @@ namespace ngla
       throw Exception (string ("BaseVector::Set: size of me = ") +
                        ToString(Size()) + " != size of other = " + ToString(v.Size()));
 
+    auto me = FVComplex();
     if (v.IsComplex())
-      FVComplex() = scal * v.FVComplex();
+      {
+        auto you = v.FVComplex();
+        ParallelForRange (me.Size(),
+                          [me,you,scal] (IntRange r) { me.Range(r) = scal * you.Range(r); });
+      }
     else
-      FVComplex() = scal * v.FVDouble();      
+      {
+        auto you = v.FVDouble();
+        ParallelForRange (me.Size(),
+                          [me,you,scal] (IntRange r) { me.Range(r) = scal * you.Range(r); });
+      }
     return *this;
   }
     
@@ -162,13 +176,272 @@ namespace ngla
       throw Exception (string ("BaseVector::Add: size of me = ") +
                        ToString(Size()) + " != size of other = " + ToString(v.Size()));
 
+    auto me = FVComplex();
     if (v.IsComplex())
-      FVComplex() += scal * v.FVComplex();
+      {
+        auto you = v.FVComplex();
+        ParallelForRange (me.Size(),
+                          [me,you,scal] (IntRange r) { me.Range(r) += scal * you.Range(r); });
+      }
     else
-      FVComplex() += scal * v.FVDouble();      
+      {
+        auto you = v.FVDouble();
+        ParallelForRange (me.Size(),
+                          [me,you,scal] (IntRange r) { me.Range(r) += scal * you.Range(r); });
+      }
+    return *this;
+  }
+
+
+
+  // sum of the parts of 16 tasks, as in L2Norm and InnerProduct
+  template <typename T, typename FUNC>
+  static T ParallelSum (size_t n, FUNC f)
+  {
+    T parts[16];
+    ParallelJob ([n,f,&parts] (TaskInfo ti)
+                 {
+                   parts[ti.task_nr] = f (IntRange(0,n).Split (ti.task_nr, ti.ntasks));
+                 }, 16);
+    T sum = 0.0;
+    for (auto part : parts) sum += part;
+    return sum;
+  }
+
+  // me = a * me + b * you, returns the squared norm of me
+  template <typename SCAL>
+  static double UpdateNorm2 (FlatVector<SCAL> me, SCAL a, SCAL b, FlatVector<SCAL> you)
+  {
+    return ParallelSum<double> (me.Size(), [me,you,a,b] (IntRange r)
+                                {
+                                  double sum = 0;
+                                  for (auto i : r)
+                                    {
+                                      SCAL val = a * me(i) + b * you(i);
+                                      me(i) = val;
+                                      sum += ngbla::L2Norm2 (val);
+                                    }
+                                  return sum;
+                                });
+  }
+
+  static void CheckFusedSizes (const BaseVector & me, const BaseVector & v, const char * name)
+  {
+    if (me.Size() != v.Size())
+      throw Exception (string ("BaseVector::") + name + ": size of me = " + ToString(me.Size())
+                       + " != size of other = " + ToString(v.Size()));
+  }
+
+  static void CheckFusedComplex (const BaseVector & me, const BaseVector & v, const char * name)
+  {
+    CheckFusedSizes (me, v, name);
+    if (!me.IsComplex() || !v.IsComplex())
+      throw Exception (string ("BaseVector::") + name + " with complex scalar needs complex vectors");
+  }
+
+  double BaseVector :: AddNorm2 (double scal, const BaseVector & v)
+  {
+    static Timer t("BaseVector::AddNorm2");
+    RegionTimer reg(t);
+    CheckFusedSizes (*this, v, "AddNorm2");
+    t.AddFlops (2*FVDouble().Size());
+    return UpdateNorm2<double> (FVDouble(), 1, scal, v.FVDouble());
+  }
+
+  double BaseVector :: AddNorm2 (Complex scal, const BaseVector & v)
+  {
+    CheckFusedComplex (*this, v, "AddNorm2");
+    return UpdateNorm2<Complex> (FVComplex(), 1, scal, v.FVComplex());
+  }
+
+  BaseVector & BaseVector :: ScaleAdd (double scal, const BaseVector & v)
+  {
+    static Timer t("BaseVector::ScaleAdd");
+    RegionTimer reg(t);
+    CheckFusedSizes (*this, v, "ScaleAdd");
+
+    auto me = FVDouble();
+    auto you = v.FVDouble();
+    t.AddFlops (me.Size());
+    ParallelFor (me.Range(),
+                 [me,you,scal] (size_t i) { me(i) = scal * me(i) + you(i); });
     return *this;
   }
 
+  BaseVector & BaseVector :: ScaleAdd (Complex scal, const BaseVector & v)
+  {
+    CheckFusedComplex (*this, v, "ScaleAdd");
+    auto me = FVComplex();
+    auto you = v.FVComplex();
+    ParallelFor (me.Range(),
+                 [me,you,scal] (size_t i) { me(i) = scal * me(i) + you(i); });
+    return *this;
+  }
+
+  double BaseVector :: ScaleAddNorm2 (double scal, const BaseVector & v)
+  {
+    static Timer t("BaseVector::ScaleAddNorm2");
+    RegionTimer reg(t);
+    CheckFusedSizes (*this, v, "ScaleAddNorm2");
+    t.AddFlops (2*FVDouble().Size());
+    return UpdateNorm2<double> (FVDouble(), scal, 1, v.FVDouble());
+  }
+
+
+  // me += sum_j scal(j) * vecs[j], blockwise to keep me in cache
+  template <typename SCAL>
+  static void T_MultiAdd (FlatVector<SCAL> me, FlatVector<SCAL> scal, FlatArray<SCAL*> vecs)
+  {
+    ParallelForRange (me.Size(), [me,scal,vecs] (IntRange r)
+                      {
+                        constexpr size_t bs = 1024;
+                        for (size_t first = r.First(); first < r.Next(); first += bs)
+                          {
+                            IntRange rb(first, min2(first+bs, r.Next()));
+                            for (size_t j = 0; j < vecs.Size(); j++)
+                              me.Range(rb) += scal(j) * FlatVector<SCAL>(me.Size(), vecs[j]).Range(rb);
+                          }
+                      });
+  }
+
+  BaseVector & BaseVector :: MultiAdd (FlatVector<double> scal, FlatArray<const BaseVector*> v)
+  {
+    static Timer t("BaseVector::MultiAdd");
+    RegionTimer reg(t);
+
+    Array<double*> vecs;
+    for (size_t j = 0; j < v.Size(); j++)
+      {
+        CheckFusedSizes (*this, *v[j], "MultiAdd");
+        vecs.Append (v[j]->FVDouble().Data());
+      }
+    t.AddFlops (v.Size()*FVDouble().Size());
+    T_MultiAdd<double> (FVDouble(), scal, vecs);
+    return *this;
+  }
+
+  BaseVector & BaseVector :: MultiAdd (FlatVector<Complex> scal, FlatArray<const BaseVector*> v)
+  {
+    Array<Complex*> vecs;
+    for (size_t j = 0; j < v.Size(); j++)
+      {
+        CheckFusedComplex (*this, *v[j], "MultiAdd");
+        vecs.Append (v[j]->FVComplex().Data());
+      }
+    T_MultiAdd<Complex> (FVComplex(), scal, vecs);
+    return *this;
+  }
+
+
+  template <typename SCAL>
+  static SCAL T_InnerProductNorm2 (FlatVector<SCAL> me, FlatVector<SCAL> you, bool conjugate,
+                                   double & norm2)
+  {
+    SCAL ip[16];
+    double nrm[16];
+    ParallelJob ([me,you,conjugate,&ip,&nrm] (TaskInfo ti)
+                 {
+                   auto r = IntRange(0,me.Size()).Split (ti.task_nr, ti.ntasks);
+                   SCAL sum = 0.0;
+                   double sumn = 0;
+                   for (auto i : r)
+                     {
+                       SCAL val = me(i);
+                       sum += (conjugate ? Conj(val) : val) * you(i);
+                       sumn += ngbla::L2Norm2 (val);
+                     }
+                   ip[ti.task_nr] = sum;
+                   nrm[ti.task_nr] = sumn;
+                 }, 16);
+    SCAL sum = 0.0;
+    norm2 = 0;
+    for (int i = 0; i < 16; i++)
+      {
+        sum += ip[i];
+        norm2 += nrm[i];
+      }
+    return sum;
+  }
+
+  double BaseVector :: InnerProductNorm2D (const BaseVector & v2, double & norm2) const
+  {
+    static Timer t("BaseVector::InnerProductNorm2");
+    RegionTimer reg(t);
+    CheckFusedSizes (*this, v2, "InnerProductNorm2D");
+    t.AddFlops (2*FVDouble().Size());
+    return T_InnerProductNorm2<double> (FVDouble(), v2.FVDouble(), false, norm2);
+  }
+
+  Complex BaseVector :: InnerProductNorm2C (const BaseVector & v2, double & norm2, bool conjugate) const
+  {
+    CheckFusedComplex (*this, v2, "InnerProductNorm2C");
+    return T_InnerProductNorm2<Complex> (FVComplex(), v2.FVComplex(), conjugate, norm2);
+  }
+
+
+  // res(j) = <me,vecs[j]>, blockwise to keep me in cache
+  template <typename SCAL>
+  static void T_MultiInnerProduct (FlatVector<SCAL> me, FlatArray<SCAL*> vecs,
+                                   FlatVector<SCAL> res, bool conjugate)
+  {
+    Matrix<SCAL> parts(16, vecs.Size());
+    ParallelJob ([me,vecs,conjugate,&parts] (TaskInfo ti)
+                 {
+                   auto r = IntRange(0,me.Size()).Split (ti.task_nr, ti.ntasks);
+                   auto part = parts.Row(ti.task_nr);
+                   part = SCAL(0.0);
+                   constexpr size_t bs = 1024;
+                   for (size_t first = r.First(); first < r.Next(); first += bs)
+                     {
+                       IntRange rb(first, min2(first+bs, r.Next()));
+                       for (size_t j = 0; j < vecs.Size(); j++)
+                         {
+                           FlatVector<SCAL> vj(me.Size(), vecs[j]);
+                           SCAL sum = 0.0;
+                           if (conjugate)
+                             for (auto i : rb) sum += Conj(me(i)) * vj(i);
+                           else
+                             for (auto i : rb) sum += me(i) * vj(i);
+                           part(j) += sum;
+                         }
+                     }
+                 }, 16);
+    for (size_t j = 0; j < vecs.Size(); j++)
+      {
+        SCAL sum = 0.0;
+        for (size_t i = 0; i < 16; i++)
+          sum += parts(i,j);
+        res(j) = sum;
+      }
+  }
+
+  void BaseVector :: MultiInnerProductD (FlatArray<const BaseVector*> v, FlatVector<double> res) const
+  {
+    static Timer t("BaseVector::MultiInnerProduct");
+    RegionTimer reg(t);
+
+    Array<double*> vecs;
+    for (size_t j = 0; j < v.Size(); j++)
+      {
+        CheckFusedSizes (*this, *v[j], "MultiInnerProductD");
+        vecs.Append (v[j]->FVDouble().Data());
+      }
+    t.AddFlops (v.Size()*FVDouble().Size());
+    T_MultiInnerProduct<double> (FVDouble(), vecs, res, false);
+  }
+
+  void BaseVector :: MultiInnerProductC (FlatArray<const BaseVector*> v, FlatVector<Complex> res,
+                                         bool conjugate) const
+  {
+    Array<Complex*> vecs;
+    for (size_t j = 0; j < v.Size(); j++)
+      {
+        CheckFusedComplex (*this, *v[j], "MultiInnerProductC");
+        vecs.Append (v[j]->FVComplex().Data());
+      }
+    T_MultiInnerProduct<Complex> (FVComplex(), vecs, res, conjugate);
+  }
+
 
   double BaseVector :: InnerProductD (const BaseVector & v2) const
   {
@@ -229,14 +502,15 @@ namespace ngla
 
   size_t BaseVector :: CheckSum () const
   {
-    size_t sum = 0;
     auto fv = FVDouble();
-    for (auto i : ngstd::Range(fv))
-      {
-        double val = fv(i);
-        sum += *reinterpret_cast<size_t*> (&val);
-      }
-    return sum;
+    return ParallelReduce (fv.Size(),
+                           [fv] (size_t i)
+                           {
+                             double val = fv(i);
+                             return *reinterpret_cast<size_t*> (&val);
+                           },
+                           [] (size_t a, size_t b) { return a+b; },
+                           size_t(0));
   }
 
   Array<MemoryUsage> BaseVector :: GetMemoryUsage () const
@@ -246,9 +520,24 @@ namespace ngla
 
   void BaseVector :: SetRandom () 
   {
+    // one generator per block, the values do not depend on the number of threads
+    constexpr size_t bs = 4096;
     FlatVector<double> fv = FVDouble();
-    for (size_t i = 0; i < fv.Size(); i++)
-      fv(i) = double (rand()) / RAND_MAX;
+    unsigned seed = rand();
+    // splitmix64, decorrelates the seeds of neighbouring blocks
+    auto mix = [] (uint64_t z)
+      {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+      };
+    ParallelFor ((fv.Size()+bs-1) / bs, [fv,seed,mix] (size_t block)
+                 {
+                   std::mt19937_64 gen(mix ((uint64_t(seed) << 32) + block + 0x9e3779b97f4a7c15ull));
+                   std::uniform_real_distribution<double> dist(0.0, 1.0);
+                   for (size_t i = block*bs; i < min2((block+1)*bs, fv.Size()); i++)
+                     fv(i) = dist(gen);
+                 });
   }
   
   /*  
@@ -349,6 +638,18 @@ namespace ngla
 
 
 
+  // whole-vector index sets run in parallel, element-sized ones (called
+  // from within parallel assembling loops) stay serial
+  template <typename FUNC>
+  static void IndirectLoop (size_t n, FUNC f)
+  {
+    if (n < 16384)
+      f (IntRange(0, n));
+    else
+      ParallelForRange (n, f);
+  }
+
+
   template<>
   void S_BaseVector<double> :: GetIndirect (FlatArray<int> ind, 
                                             FlatVector<double> v) const 
@@ -356,11 +657,14 @@ namespace ngla
     if (EntrySize() == 1)
       {
         FlatVector<double> lsv(Size(), &FVDouble()(0));
-        for (auto i : ind.Range())
-          {
-            int index = ind[i];
-            v(i) = IsRegularIndex(index) ? lsv(index) : 0;
-          }
+        IndirectLoop (ind.Size(), [&] (IntRange r)
+                      {
+                        for (auto i : r)
+                          {
+                            int index = ind[i];
+                            v(i) = IsRegularIndex(index) ? lsv(index) : 0;
+                          }
+                      });
         /*
         int i = 0;
         double temp[8];
@@ -386,11 +690,14 @@ namespace ngla
         FlatSysVector<double> lsv(Size(), EntrySize(), &FVDouble()(0));
         FlatSysVector<double> sv(ind.Size(), EntrySize(), &v(0));
         
-        for (size_t i = 0; i < ind.Size(); i++)
-          if (IsRegularIndex(ind[i]))
-            sv(i) = lsv(ind[i]);
-          else
-            sv(i) = -1.0;
+        IndirectLoop (ind.Size(), [&] (IntRange r)
+                      {
+                        for (auto i : r)
+                          if (IsRegularIndex(ind[i]))
+                            sv(i) = lsv(ind[i]);
+                          else
+                            sv(i) = -1.0;
+                      });
       }
   }
   
@@ -401,11 +708,14 @@ namespace ngla
     FlatSysVector<double> lsv(Size(), EntrySize(), &FVDouble()(0));
     FlatSysVector<Complex> sv(ind.Size(), EntrySize(), &v(0));
 
-    for (size_t i = 0; i < ind.Size(); i++)
-      if (IsRegularIndex(ind[i]))
-	sv(i) = lsv(ind[i]);
-      else
-	sv(i) = -1.0;
+    IndirectLoop (ind.Size(), [&] (IntRange r)
+                  {
+                    for (auto i : r)
+                      if (IsRegularIndex(ind[i]))
+                        sv(i) = lsv(ind[i]);
+                      else
+                        sv(i) = -1.0;
+                  });
     /*
     FlatVector<Complex> fv = FVComplex();
     int es = EntrySize() / 2;
@@ -439,19 +749,21 @@ namespace ngla
   { 
     FlatVector<Complex> fv = FVComplex();
     int es = EntrySize() / 2;
-    int ii = 0;
-    for (size_t i = 0; i < ind.Size(); i++)
-      if (IsRegularIndex(ind[i]))
-	{
-	  int base = es * ind[i];
-	  for (int j = 0; j < es; j++)
-	    v[ii++] = fv[base++];
-	}
-      else
-	{
-	  for (int j = 0; j < es; j++)
-	    v[ii++] = 0;
-	}
+    IndirectLoop (ind.Size(), [&] (IntRange r)
+                  {
+                    for (auto i : r)
+                      if (IsRegularIndex(ind[i]))
+                        {
+                          size_t base = es * ind[i];
+                          for (int j = 0; j < es; j++)
+                            v[i*es+j] = fv[base+j];
+                        }
+                      else
+                        {
+                          for (int j = 0; j < es; j++)
+                            v[i*es+j] = 0;
+                        }
+                  });
   }
   
 
@@ -551,9 +863,13 @@ namespace ngla
           }
         else
           {
-            for (size_t i = 0; i < ind.Size(); i++)
-              if (IsRegularIndex(ind[i]))
-                AtomicAdd (lsv(ind[i]), v(i));
+            // repeated indices are safe with atomics, large sets run in parallel
+            IndirectLoop (ind.Size(), [&] (IntRange r)
+                          {
+                            for (auto i : r)
+                              if (IsRegularIndex(ind[i]))
+                                AtomicAdd (lsv(ind[i]), v(i));
+                          });
             // lsv(ind[i]) += v(i);
           }
       }
@@ -584,9 +900,12 @@ namespace ngla
           }
         else
           {
-            for (size_t i = 0; i < ind.Size(); i++)
-              if (IsRegularIndex(ind[i]))
-                AtomicAdd (fv(ind[i]), v(i));
+            IndirectLoop (ind.Size(), [&] (IntRange r)
+                          {
+                            for (auto i : r)
+                              if (IsRegularIndex(ind[i]))
+                                AtomicAdd (fv(ind[i]), v(i));
+                          });
           }
       }
     else
@@ -839,13 +1158,81 @@ namespace ngla
       vecs[i] -> Add(scal, *bv[i]);
     return *this;
   }
+
+  double BlockVector :: AddNorm2 (double scal, const BaseVector & v)
+  {
+    auto & bv = dynamic_cast_BlockVector(v);
+    double sum = 0;
+    for (size_t i : ngstd::Range(vecs))
+      sum += vecs[i] -> AddNorm2(scal, *bv[i]);
+    return sum;
+  }
+
+  BaseVector & BlockVector :: ScaleAdd (double scal, const BaseVector & v)
+  {
+    auto & bv = dynamic_cast_BlockVector(v);
+    for (size_t i : ngstd::Range(vecs))
+      vecs[i] -> ScaleAdd(scal, *bv[i]);
+    return *this;
+  }
+
+  double BlockVector :: ScaleAddNorm2 (double scal, const BaseVector & v)
+  {
+    auto & bv = dynamic_cast_BlockVector(v);
+    double sum = 0;
+    for (size_t i : ngstd::Range(vecs))
+      sum += vecs[i] -> ScaleAddNorm2(scal, *bv[i]);
+    return sum;
+  }
+
+  BaseVector & BlockVector :: MultiAdd (FlatVector<double> scal, FlatArray<const BaseVector*> v)
+  {
+    Array<const BaseVector*> comps(v.Size());
+    for (size_t i : ngstd::Range(vecs))
+      {
+        for (size_t j : ngstd::Range(v))
+          comps[j] = dynamic_cast_BlockVector(*v[j])[i].get();
+        vecs[i] -> MultiAdd(scal, comps);
+      }
+    return *this;
+  }
+
+  double BlockVector :: InnerProductNorm2D (const BaseVector & v2, double & norm2) const
+  {
+    const auto & v2b = dynamic_cast_BlockVector(v2);
+    double pp = 0, ps = 0;
+    norm2 = 0;
+    for (size_t k = 0; k<vecs.Size(); k++) {
+      double nk;
+      auto p = vecs[k]->InnerProductNorm2D(*v2b[k], nk);
+      norm2 += nk;
+      if (ispar.Test(k)) pp += p;
+      else ps += p;
+    }
+    return pp + comm.AllReduce(ps, MPI_SUM);
+  }
+
+  void BlockVector :: MultiInnerProductD (FlatArray<const BaseVector*> v, FlatVector<double> res) const
+  {
+    Array<const BaseVector*> comps(v.Size());
+    Vector<double> resk(v.Size()), ps(v.Size());
+    res = 0.0;
+    ps = 0.0;
+    for (size_t k = 0; k<vecs.Size(); k++) {
+      for (size_t j : ngstd::Range(v))
+        comps[j] = dynamic_cast_BlockVector(*v[j])[k].get();
+      vecs[k]->MultiInnerProductD(comps, resk);
+      if (ispar.Test(k)) res += resk;
+      else ps += resk;
+    }
+    for (size_t j : ngstd::Range(v))
+      res(j) += comm.AllReduce(ps(j), MPI_SUM);
+  }
   
   
   template <typename TSCAL>
   S_BaseVectorPtr<TSCAL> :: ~S_BaseVectorPtr ()
-  {
-    if (ownmem) delete [] pdata;
-  }
+  { ; }
 
   template <typename TSCAL>
   AutoVector S_BaseVectorPtr<TSCAL> :: CreateVector () const
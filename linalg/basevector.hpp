@@ -233,6 +233,30 @@ namespace ngla
     virtual BaseVector & Add (double scal, const BaseVector & v);
     virtual BaseVector & Add (Complex scal, const BaseVector & v);
 
+    /*
+      Fused kernels, one sweep over the vectors instead of one per
+      operation. Squared norms are hermitian, inner products are
+      conjugated in the first argument if conjugate is set.
+    */
+    /// this += scal * v, returns the squared norm of the result
+    virtual double AddNorm2 (double scal, const BaseVector & v);
+    virtual double AddNorm2 (Complex scal, const BaseVector & v);
+    /// this = scal * this + v
+    virtual BaseVector & ScaleAdd (double scal, const BaseVector & v);
+    virtual BaseVector & ScaleAdd (Complex scal, const BaseVector & v);
+    /// this = scal * this + v, returns the squared norm of the result
+    virtual double ScaleAddNorm2 (double scal, const BaseVector & v);
+    /// this += sum_i scal(i) * v[i]
+    virtual BaseVector & MultiAdd (FlatVector<double> scal, FlatArray<const BaseVector*> v);
+    virtual BaseVector & MultiAdd (FlatVector<Complex> scal, FlatArray<const BaseVector*> v);
+    /// returns <this,v2>, and the squared norm of this in norm2
+    virtual double InnerProductNorm2D (const BaseVector & v2, double & norm2) const;
+    virtual Complex InnerProductNorm2C (const BaseVector & v2, double & norm2, bool conjugate = false) const;
+    /// res(i) = <this,v[i]>
+    virtual void MultiInnerProductD (FlatArray<const BaseVector*> v, FlatVector<double> res) const;
+    virtual void MultiInnerProductC (FlatArray<const BaseVector*> v, FlatVector<Complex> res,
+                                     bool conjugate = false) const;
+
     virtual ostream & Print (ostream & ost) const;
     virtual void Save(ostream & ost) const;
     virtual void Load(istream & ist);
@@ -490,6 +514,57 @@ namespace ngla
       return vec->Add (scal,v);
     }
 
+    virtual double AddNorm2 (double scal, const BaseVector & v)
+    {
+      return vec->AddNorm2 (scal,v);
+    }
+    virtual double AddNorm2 (Complex scal, const BaseVector & v)
+    {
+      return vec->AddNorm2 (scal,v);
+    }
+
+    virtual BaseVector & ScaleAdd (double scal, const BaseVector & v)
+    {
+      return vec->ScaleAdd (scal,v);
+    }
+    virtual BaseVector & ScaleAdd (Complex scal, const BaseVector & v)
+    {
+      return vec->ScaleAdd (scal,v);
+    }
+
+    virtual double ScaleAddNorm2 (double scal, const BaseVector & v)
+    {
+      return vec->ScaleAddNorm2 (scal,v);
+    }
+
+    virtual BaseVector & MultiAdd (FlatVector<double> scal, FlatArray<const BaseVector*> v)
+    {
+      return vec->MultiAdd (scal,v);
+    }
+    virtual BaseVector & MultiAdd (FlatVector<Complex> scal, FlatArray<const BaseVector*> v)
+    {
+      return vec->MultiAdd (scal,v);
+    }
+
+    virtual double InnerProductNorm2D (const BaseVector & v2, double & norm2) const
+    {
+      return vec->InnerProductNorm2D (v2, norm2);
+    }
+    virtual Complex InnerProductNorm2C (const BaseVector & v2, double & norm2, bool conjugate) const
+    {
+      return vec->InnerProductNorm2C (v2, norm2, conjugate);
+    }
+
+    virtual void MultiInnerProductD (FlatArray<const BaseVector*> v, FlatVector<double> res) const
+    {
+      vec->MultiInnerProductD (v, res);
+    }
+    virtual void MultiInnerProductC (FlatArray<const BaseVector*> v, FlatVector<Complex> res,
+                                     bool conjugate) const
+    {
+      vec->MultiInnerProductC (v, res, conjugate);
+    }
+
     virtual ostream & Print (ostream & ost) const
     {
       return vec->Print (ost);
@@ -705,6 +780,13 @@ namespace ngla
 
     virtual BaseVector & Set (double scal, const BaseVector & v);
     virtual BaseVector & Add (double scal, const BaseVector & v);
+
+    virtual double AddNorm2 (double scal, const BaseVector & v);
+    virtual BaseVector & ScaleAdd (double scal, const BaseVector & v);
+    virtual double ScaleAddNorm2 (double scal, const BaseVector & v);
+    virtual BaseVector & MultiAdd (FlatVector<double> scal, FlatArray<const BaseVector*> v);
+    virtual double InnerProductNorm2D (const BaseVector & v2, double & norm2) const;
+    virtual void MultiInnerProductD (FlatArray<const BaseVector*> v, FlatVector<double> res) const;
   };
 
   
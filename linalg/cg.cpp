@@ -70,6 +70,48 @@ namespace ngla
     useseed = false;
   }
 
+
+  FlatArray<shared_ptr<BaseVector>> KrylovSpaceSolver :: WorkVectors (const BaseVector & f, int n) const
+  {
+    bool parallel = f.GetParallelStatus() != NOT_PARALLEL;
+    for (auto & vec : workvecs)
+      if (vec->Size() != f.Size() || vec->EntrySize() != f.EntrySize() ||
+          (vec->GetParallelStatus() != NOT_PARALLEL) != parallel)
+        {
+          workvecs.SetSize0();
+          break;
+        }
+    while (workvecs.Size() < n)
+      workvecs.Append (f.CreateVector());
+    return workvecs.Range(0, n);
+  }
+
+
+  // <v,v> = |v|^2 for these inner products, the fused norm kernels apply
+  template <class IPTYPE>
+  constexpr bool IsHermitianIP ()
+  {
+    return is_same<IPTYPE,double>::value || is_same<IPTYPE,ComplexConjugate>::value;
+  }
+
+  // returns S_InnerProduct<IPTYPE>(v1,v2) and norm2 = <v1,v1>, in one sweep
+  template <class IPTYPE>
+  typename SCAL_TRAIT<IPTYPE>::SCAL
+  S_InnerProductNorm2 (const BaseVector & v1, const BaseVector & v2, double & norm2);
+
+  template <> inline double
+  S_InnerProductNorm2<double> (const BaseVector & v1, const BaseVector & v2, double & norm2)
+  {
+    return v1.InnerProductNorm2D (v2, norm2);
+  }
+
+  template <> inline Complex
+  S_InnerProductNorm2<ComplexConjugate> (const BaseVector & v1, const BaseVector & v2, double & norm2)
+  {
+    return Conj (v1.InnerProductNorm2C (v2, norm2, true));
+  }
+
+
     template <class SCAL>
   void BruteInnerProduct(const BaseVector & a, const BaseVector & b, Vector<SCAL> & result, const int start = 0)
   {
@@ -140,9 +182,10 @@ namespace ngla
 	if(sh)
 	  sh->SetThreadPercentage(0);
 
-	auto d = f.CreateVector();
-	auto w = f.CreateVector();
-	auto s = f.CreateVector();
+        auto work = WorkVectors (f, 3);
+        BaseVector & d = *work[0];
+        BaseVector & w = *work[1];
+        BaseVector & s = *work[2];
 
 	int n = 0;
 	Vector<SCAL> al(dim), be(dim), wd(dim), wdn(dim), kss(dim);
@@ -560,9 +603,12 @@ namespace ngla
 	if(sh)
 	  sh->SetThreadPercentage(0);
  
-        auto d = f.CreateVector();
-        auto w = f.CreateVector();
-        auto s = f.CreateVector();
+        auto work = WorkVectors (f, 3);
+        BaseVector & d = *work[0];
+        BaseVector & w = *work[1];
+        BaseVector & s = *work[2];
+        // without preconditioner, the preconditioned residual is d itself
+        BaseVector & cd = c ? w : d;
 
 	int n = 0;
 	SCAL al, be, wd, wdn, kss;
@@ -579,11 +625,11 @@ namespace ngla
 
 	if (c)
 	  w = (*c) * d;
-	else
-	  w = d;
 
-	s = w;
-	wdn = S_InnerProduct<IPTYPE> (w,d);
+	s = cd;
+	wdn = S_InnerProduct<IPTYPE> (cd,d);
+        errors.SetSize0();
+        errors.Append (sqrt(Abs(wdn)));
 
 	if (printrates) cout << IM(1) << "0 " << sqrt(Abs(wdn)) << endl;
 	if (wdn == 0.0) wdn = 1;	
@@ -605,19 +651,26 @@ namespace ngla
 	    
 	    al = wd / kss;
 	    u += al * s;
-	    d -= al * w;
 
-	    if (c)
-	      w = (*c) * d;
-	    else
-	      w = d;
-	    wdn = S_InnerProduct<IPTYPE> (d, w);
+            if constexpr (IsHermitianIP<IPTYPE>())
+              {
+                // update the residual together with its norm
+                if (!c)
+                  wdn = d.AddNorm2 (-al, w);
+              }
+            if (c || !IsHermitianIP<IPTYPE>())
+              {
+                d -= al * w;
+                if (c)
+                  w = (*c) * d;
+                wdn = S_InnerProduct<IPTYPE> (d, cd);
+              }
 
 	    be = wdn / wd;
-	    
-	    s *= be;
-	    s += w;
 
+            s.ScaleAdd (be, cd);
+
+            errors.Append (sqrt(Abs(wdn)));
 	    if (printrates ) cout << IM(1) << n << " " << sqrt (Abs (wdn)) << endl;
 	    if ( sh )
 	      sh->SetThreadPercentage(100.*max2(double(n)/double(maxsteps),
@@ -653,19 +706,33 @@ namespace ngla
 	if(sh)
 	  sh->SetThreadPercentage(0);
  
-	auto r = f.CreateVector();
-	auto r_tilde = f.CreateVector();
-	auto p = f.CreateVector();
-	auto p_tilde = f.CreateVector();
-	auto s = f.CreateVector();
-	auto s_tilde = f.CreateVector();
-	auto t = f.CreateVector();
-	auto v = f.CreateVector();
+        auto work = WorkVectors (f, 8);
+        BaseVector & r = *work[0];
+        BaseVector & r_tilde = *work[1];
+        BaseVector & p = *work[2];
+        BaseVector & p_tilde = *work[3];
+        BaseVector & s = *work[4];
+        BaseVector & s_tilde = *work[5];
+        BaseVector & t = *work[6];
+        BaseVector & v = *work[7];
 
 	int n = 0;
 	SCAL rho_old, rho_new, beta, alpha, omega;
 	double err, err_i;
 
+        // omega = <t,s> / <t,t>
+        auto Omega = [] (const BaseVector & t, const BaseVector & s) -> SCAL
+          {
+            if constexpr (IsHermitianIP<IPTYPE>())
+              {
+                double tt;
+                SCAL ts = S_InnerProductNorm2<IPTYPE> (t, s, tt);
+                return ts / tt;
+              }
+            else
+              return S_InnerProduct<IPTYPE> (t, s) / S_InnerProduct<IPTYPE> (t, t);
+          };
+
 	if (initialize)
 	  {
 	    u = 0.0;
@@ -687,9 +754,7 @@ namespace ngla
 	v = (*a) * p_tilde;
 	alpha = rho_new / S_InnerProduct<IPTYPE> (r_tilde, v);
 	s = r;
-	s -= alpha * v;
-
-	err_i = L2Norm(s);
+	err_i = sqrt (s.AddNorm2 (-alpha, v));
 	if (c)
 	  s_tilde = (*c) * s;
 	else
@@ -697,12 +762,12 @@ namespace ngla
 
 	t = (*a) * s_tilde;
 
-	omega = S_InnerProduct<IPTYPE> (t, s) / S_InnerProduct<IPTYPE> (t, t);
+	omega = Omega (t, s);
 	u += alpha * p_tilde + omega * s_tilde;
 	r = s;
-	r -= omega * t;
-
-	err_i = L2Norm(r);
+	err_i = sqrt (r.AddNorm2 (-omega, t));
+        errors.SetSize0();
+        errors.Append (err_i);
 	if (printrates) cout << IM(1) << "0 " << err_i << endl;
 
 
@@ -732,13 +797,12 @@ namespace ngla
 	    v = (*a) * p_tilde;
 	    alpha = rho_new / S_InnerProduct<IPTYPE> (r_tilde, v);
 	    s = r;
-	    s -= alpha * v;
-
-	    err_i = L2Norm(s);
+	    err_i = sqrt (s.AddNorm2 (-alpha, v));
 	    u += alpha * p_tilde;
 	    
 	    if ( err_i < err )
 	      {
+                errors.Append (err_i);
 		break;
 	      }
 
@@ -749,12 +813,11 @@ namespace ngla
 
 	    t = (*a) * s_tilde;
 	    
-	    omega = S_InnerProduct<IPTYPE> (t, s) / S_InnerProduct<IPTYPE> (t, t);
+	    omega = Omega (t, s);
 	    u +=  omega * s_tilde;
 	    r = s;
-	    r -= omega * t;
-
-	    err_i = L2Norm(r);
+	    err_i = sqrt (r.AddNorm2 (-omega, t));
+            errors.Append (err_i);
 
 	    if (printrates ) cout << IM(1) << n << " " << err_i << endl;
 	    if(sh)
@@ -790,8 +853,9 @@ namespace ngla
 	if(sh)
 	  sh->SetThreadPercentage(0);
  
-	auto d = f.CreateVector();
-	auto w = f.CreateVector();
+        auto work = WorkVectors (f, 2);
+        BaseVector & d = *work[0];
+        BaseVector & w = *work[1];
 
 	int n = 0;
 	double err, err0;
@@ -808,6 +872,7 @@ namespace ngla
 
 
         err = err0 = 1;
+        errors.SetSize0();
 
 	while (n++ < maxsteps && err > prec * err0)
           {
@@ -822,6 +887,7 @@ namespace ngla
 
             err = Abs (S_InnerProduct<IPTYPE> (w, d));
             if (n == 1) err0 = err;
+            errors.Append (sqrt (err));
 
 	    if (printrates ) cout << IM(1) << n << " " << sqrt (err) << endl;
           }
@@ -870,13 +936,15 @@ namespace ngla
       {
 	// Solve A u = f
 
-	auto v = f.CreateVector();
-	auto av = f.CreateVector();
-	auto r = f.CreateVector();
-	auto w = f.CreateVector();
-	auto hv = f.CreateVector();
+        // the Krylov basis follows the 5 work vectors
+        auto work = WorkVectors (f, 5);
+        BaseVector & v = *work[0];
+        BaseVector & av = *work[1];
+        BaseVector & r = *work[2];
+        BaseVector & w = *work[3];
+        BaseVector & hv = *work[4];
 
-        Array<AutoVector> vi(maxsteps);
+        Array<const BaseVector*> vi(maxsteps);
         Matrix<SCAL> h(maxsteps+1, maxsteps);
         Matrix<SCAL> h2(maxsteps+1, maxsteps);
         Vector<SCAL> gammai(maxsteps), ci(maxsteps), si(maxsteps);
@@ -906,6 +974,8 @@ namespace ngla
         v = (1.0/sqrt(S_InnerProduct<IPTYPE>(r,r))) * r;
 
         gammai(0) = norm;
+        errors.SetSize0();
+        errors.Append (norm);
 
 	if (printrates) cout << IM(1) << "0 " << norm << endl;
 	
@@ -918,8 +988,9 @@ namespace ngla
 	int j = -1;
 	while (j++ < maxsteps-2 && norm > err)
 	  {
-            vi[j].AssignPointer (f.CreateVector());
-            vi[j] = v;
+            BaseVector & vj = *WorkVectors (f, 6+j)[5+j];
+            vj = v;
+            vi[j] = &vj;
 
             av = (*a) * v;
             if (c)
@@ -928,12 +999,24 @@ namespace ngla
                 av = hv;
               }
 
+            // all inner products in one sweep over av, and one reduction
+            auto basis = vi.Range(0, j+1);
+            Vector<SCAL> hcol(j+1);
+            if constexpr (is_same<IPTYPE,double>::value)
+              av.MultiInnerProductD (basis, hcol);
+            else if constexpr (is_same<IPTYPE,Complex>::value)
+              av.MultiInnerProductC (basis, hcol, false);
+            else if constexpr (is_same<IPTYPE,ComplexConjugate>::value)
+              av.MultiInnerProductC (basis, hcol, true);
+            else
+              for (int i = 0; i <= j; i++)
+                hcol(i) = S_InnerProduct<IPTYPE> (*vi[i], av);
             for (int i = 0; i <= j; i++)
-              h2(i,j) = h(i,j) = S_InnerProduct<IPTYPE> (*vi[i], av);
+              h2(i,j) = h(i,j) = hcol(i);
 
             w = av;
-            for (int i = 0; i <= j; i++)
-              w -= h(i,j) * (*vi[i]);
+            hcol *= -1.0;
+            w.MultiAdd (hcol, basis);
 
             v = (1.0 / sqrt (S_InnerProduct<IPTYPE> (w, w))) * w;
             h2(j+1,j) = h(j+1,j) = S_InnerProduct<IPTYPE> (v, av);
@@ -958,6 +1041,7 @@ namespace ngla
 
 
             norm = fabs (gammai(j));
+            errors.Append (norm);
           }
         
         j--;
@@ -971,8 +1055,7 @@ namespace ngla
             y(i) = sum / h(i,i);
           }
 
-        for (int i = 0; i <= j; i++)
-          x += y(i) * *vi[i];
+        x.MultiAdd (y.Range(0, j+1), vi.Range(0, j+1));
 
 	const_cast<int&> (steps) = j;
 	
@@ -1073,20 +1156,21 @@ void QMRSolver<SCAL> :: Mult (const BaseVector & b, BaseVector & x) const
       SCAL rho, rho_1, xi, gamma, gamma_1, theta, theta_1, eta, delta, ep=1.0, beta;
       
 
-      auto r = b.CreateVector();
-      auto v_tld = b.CreateVector();
-      auto y = b.CreateVector();
-      auto w_tld = b.CreateVector();
-      auto z = b.CreateVector();
-      auto v = b.CreateVector();
-      auto w = b.CreateVector();
-      auto y_tld = b.CreateVector();
-      auto z_tld = b.CreateVector();
-      auto p = b.CreateVector();
-      auto q = b.CreateVector();
-      auto p_tld = b.CreateVector();
-      auto d = b.CreateVector();
-      auto s = b.CreateVector();
+      auto work = WorkVectors (b, 14);
+      BaseVector & r = *work[0];
+      BaseVector & v_tld = *work[1];
+      BaseVector & y = *work[2];
+      BaseVector & w_tld = *work[3];
+      BaseVector & z = *work[4];
+      BaseVector & v = *work[5];
+      BaseVector & w = *work[6];
+      BaseVector & y_tld = *work[7];
+      BaseVector & z_tld = *work[8];
+      BaseVector & p = *work[9];
+      BaseVector & q = *work[10];
+      BaseVector & p_tld = *work[11];
+      BaseVector & d = *work[12];
+      BaseVector & s = *work[13];
 
       double normb = b.L2Norm();
 
@@ -1095,7 +1179,7 @@ void QMRSolver<SCAL> :: Mult (const BaseVector & b, BaseVector & x) const
 	x = 0;
 
 
-      r = b - (*a) * x;
+      double rnorm = Residual (*a, x, b, r);
 
       if (normb == 0.0)
 	normb = 1;
@@ -1106,7 +1190,10 @@ void QMRSolver<SCAL> :: Mult (const BaseVector & b, BaseVector & x) const
       double tol = prec;
       int max_iter = maxsteps;
       
-      if ((resid = r.L2Norm() / normb) <= tol) {
+      resid = rnorm / normb;
+      errors.SetSize0();
+      errors.Append (resid * normb);
+      if (resid <= tol) {
 	tol = resid;
 	max_iter = 0;
 	((int&)status) = 0;
@@ -1274,11 +1361,11 @@ void QMRSolver<SCAL> :: Mult (const BaseVector & b, BaseVector & x) const
 	    }
 	  
 	  x += d;
-	  r -= s;
-
-	  if ( printrates ) cout << IM(1) << i << " " << r.L2Norm() << endl;
+	  resid = sqrt (r.AddNorm2 (-1, s)) / normb;
+          errors.Append (resid * normb);
+	  if ( printrates ) cout << IM(1) << i << " " << resid * normb << endl;
 	  
-	  if ((resid = r.L2Norm() / normb) <= tol) {
+	  if (resid <= tol) {
 	    tol = resid;
 	    max_iter = i;
 	    ((int&)status) = 0;
@@ -40,6 +40,18 @@ namespace ngla
     ///
     const BaseStatusHandler * sh;
 
+    /// work vectors, kept between calls of Mult
+    mutable Array<shared_ptr<BaseVector>> workvecs;
+    /// residuals of the last Mult, starting with the initial one
+    mutable Array<double> errors;
+
+    /**
+       The first n work vectors, created like f. They are re-used as long
+       as f keeps size and type, so a solver object must not run several
+       Mult concurrently.
+    */
+    NGS_DLL_HEADER FlatArray<shared_ptr<BaseVector>> WorkVectors (const BaseVector & f, int n) const;
+
   public:
     ///
     NGS_DLL_HEADER KrylovSpaceSolver();
@@ -87,6 +99,12 @@ namespace ngla
     ///
     int GetSteps () const
     { return steps; }
+    ///
+    FlatArray<double> GetErrors () const
+    { return errors; }
+    /// releases the memory of the work vectors
+    void FreeWorkVectors ()
+    { workvecs.SetSize0(); }
 
     ///
     NGS_DLL_HEADER AutoVector CreateRowVector() const override { return a->CreateColVector(); }
@@ -671,6 +671,272 @@ namespace ngla
   template class ElementByElementMatrix<double>;
   template class ElementByElementMatrix<Complex>;
 
+
+
+  template <class SCAL>
+  CompactElementByElementMatrix<SCAL> ::
+  CompactElementByElementMatrix (size_t h, size_t w,
+                                 FlatArray<int> nrowi, FlatArray<int> ncoli,
+                                 bool adisjointrows, bool adisjointcols)
+    : height(h), width(w), disjointrows(adisjointrows), disjointcols(adisjointcols),
+      rowdnums(nrowi), coldnums(ncoli)
+  {
+    static Timer t("CompactEBE-matrix::ctor"); RegionTimer reg(t);
+    constexpr size_t SW = SIMD<double>::Size();
+    constexpr size_t SS = sizeof(SCAL)/sizeof(double);
+    size_t ne = nrowi.Size();
+
+    // group elements of equal sizes
+    elgroup.SetSize (ne);
+    elpos.SetSize (ne);
+    for (size_t i = 0; i < ne; i++)
+      {
+        elgroup[i] = -1;
+        if (nrowi[i] == 0 || ncoli[i] == 0) continue;
+        INT<2> key(nrowi[i], ncoli[i]);
+        int pos = -1;
+        for (size_t j = 0; j < group_sizes.Size(); j++)
+          if (group_sizes[j] == key) pos = j;
+        if (pos == -1)
+          {
+            pos = group_sizes.Size();
+            group_sizes.Append (key);
+          }
+        elgroup[i] = pos;
+      }
+
+    Array<int> cnt(group_sizes.Size());
+    cnt = 0;
+    for (size_t i = 0; i < ne; i++)
+      if (elgroup[i] != -1)
+        elpos[i] = cnt[elgroup[i]]++;
+    group_elements = Table<int> (cnt);
+    for (size_t i = 0; i < ne; i++)
+      if (elgroup[i] != -1)
+        group_elements[elgroup[i]][elpos[i]] = i;
+
+    // every group consists of full batches, unused lanes stay zero
+    group_first.SetSize (group_sizes.Size());
+    size_t totsize = 0;
+    for (size_t g = 0; g < group_sizes.Size(); g++)
+      {
+        group_first[g] = totsize;
+        totsize += (cnt[g]+SW-1)/SW * group_sizes[g][0]*group_sizes[g][1]*SS;
+      }
+    arena.SetSize (totsize);
+
+    // first touch
+    ParallelForRange (arena.Size(), [&] (IntRange r)
+                      {
+                        for (auto i : r)
+                          arena[i] = SIMD<double>(0.0);
+                      });
+
+    for (auto row : rowdnums) row = -1;
+    for (auto col : coldnums) col = -1;
+  }
+
+
+  template <class SCAL>
+  void CompactElementByElementMatrix<SCAL> :: AddElementMatrix (int elnr,
+                                                                FlatArray<int> rowdnums_in,
+                                                                FlatArray<int> coldnums_in,
+                                                                BareSliceMatrix<SCAL> elmat)
+  {
+    if (elnr >= rowdnums.Size())
+      throw Exception ("CompactEBEMatrix::AddElementMatrix, illegal elnr");
+
+    ArrayMem<int,50> usedrows;
+    for (int i = 0; i < rowdnums_in.Size(); i++)
+      if (rowdnums_in[i] >= 0) usedrows.Append(i);
+    int sr = usedrows.Size();
+
+    ArrayMem<int,50> usedcols;
+    for (int i = 0; i < coldnums_in.Size(); i++)
+      if (coldnums_in[i] >= 0) usedcols.Append(i);
+    int sc = usedcols.Size();
+
+    FlatArray<int> dnr = rowdnums[elnr];
+    FlatArray<int> dnc = coldnums[elnr];
+    if (dnr.Size() != sr || dnc.Size() != sc)
+      throw Exception ("compact ebe, dnr or dnc has illegal size: \n"
+                       "dnr.size = "+ToString(dnr.Size()) + " sr = " +ToString(sr) + "\n"
+                       "dnc.size = "+ToString(dnc.Size()) + " sc = " +ToString(sc));
+
+    if (elgroup[elnr] != -1)
+      for (int i = 0; i < sr; i++)
+        for (int j = 0; j < sc; j++)
+          *EntryPtr(elnr, i, j) = elmat(usedrows[i], usedcols[j]);
+
+    for (int i = 0; i < sr; i++)
+      dnr[i] = rowdnums_in[usedrows[i]];
+    for (int j = 0; j < sc; j++)
+      dnc[j] = coldnums_in[usedcols[j]];
+  }
+
+
+  template <class SCAL> template <bool TRANS>
+  void CompactElementByElementMatrix<SCAL> ::
+  Apply (double s, FlatVector<SCAL> fx, FlatVector<SCAL> fy) const
+  {
+    static Timer t("CompactEBE-matrix::Apply batch");
+    constexpr size_t SW = SIMD<double>::Size();
+    constexpr size_t SS = sizeof(SCAL)/sizeof(double);
+    bool disjoint = TRANS ? disjointcols : disjointrows;
+
+    for (size_t g = 0; g < group_sizes.Size(); g++)
+      {
+        size_t h = group_sizes[g][0], w = group_sizes[g][1];
+        size_t nx = TRANS ? h : w;
+        size_t ny = TRANS ? w : h;
+        FlatArray<int> els = group_elements[g];
+        size_t nbatch = (els.Size()+SW-1)/SW;
+
+        ParallelForRange
+          (nbatch, [&] (IntRange r)
+           {
+             // lane k of entry i is at position i*SW+k
+             STACK_ARRAY(SIMD<double>, memx, nx*SS);
+             STACK_ARRAY(SIMD<double>, memy, ny*SS);
+             SCAL * px = reinterpret_cast<SCAL*> (&memx[0]);
+             SCAL * py = reinterpret_cast<SCAL*> (&memy[0]);
+
+             for (auto b : r)
+               {
+                 size_t first = b*SW;
+                 size_t num = min2(SW, els.Size()-first);
+
+                 for (size_t k = 0; k < SW; k++)
+                   {
+                     if (k >= num)
+                       {
+                         for (size_t i = 0; i < nx; i++)
+                           px[i*SW+k] = SCAL(0.0);
+                         continue;
+                       }
+                     FlatArray<int> dx = TRANS ? rowdnums[els[first+k]] : coldnums[els[first+k]];
+                     for (size_t i = 0; i < nx; i++)
+                       px[i*SW+k] = (dx[i] >= 0) ? fx(dx[i]) : SCAL(0.0);
+                   }
+
+                 const SIMD<double> * pa = &arena[group_first[g] + b*h*w*SS];
+                 {
+                   ThreadRegionTimer reg(t, TaskManager::GetThreadId());
+                   NgProfiler::AddThreadFlops(t, TaskManager::GetThreadId(), num*h*w);
+
+                   if constexpr (is_same<SCAL,double>::value)
+                     {
+                       if (!TRANS)
+                         for (size_t i = 0; i < h; i++)
+                           {
+                             SIMD<double> sum(0.0);
+                             for (size_t j = 0; j < w; j++)
+                               sum = FMA(pa[i*w+j], memx[j], sum);
+                             memy[i] = sum;
+                           }
+                       else
+                         {
+                           for (size_t j = 0; j < w; j++)
+                             memy[j] = SIMD<double>(0.0);
+                           for (size_t i = 0; i < h; i++)
+                             for (size_t j = 0; j < w; j++)
+                               memy[j] = FMA(pa[i*w+j], memx[i], memy[j]);
+                         }
+                     }
+                   else
+                     {
+                       const SCAL * ppa = reinterpret_cast<const SCAL*> (pa);
+                       for (size_t i = 0; i < ny*SW; i++)
+                         py[i] = SCAL(0.0);
+                       for (size_t i = 0; i < h; i++)
+                         for (size_t j = 0; j < w; j++)
+                           for (size_t k = 0; k < SW; k++)
+                             if (!TRANS)
+                               py[i*SW+k] += ppa[(i*w+j)*SW+k] * px[j*SW+k];
+                             else
+                               py[j*SW+k] += ppa[(i*w+j)*SW+k] * px[i*SW+k];
+                     }
+                 }
+
+                 for (size_t k = 0; k < num; k++)
+                   {
+                     FlatArray<int> dy = TRANS ? coldnums[els[first+k]] : rowdnums[els[first+k]];
+                     for (size_t i = 0; i < ny; i++)
+                       {
+                         if (dy[i] < 0) continue;   // reserved but not used
+                         SCAL val = s * py[i*SW+k];
+                         if (disjoint)
+                           fy(dy[i]) += val;
+                         else
+                           AtomicAdd (fy(dy[i]), val);
+                       }
+                   }
+               }
+           });
+      }
+  }
+
+
+  template <class SCAL>
+  void CompactElementByElementMatrix<SCAL> :: MultAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("CompactEBE-matrix::MultAdd");
+    RegionTimer reg(t);
+    Apply<false> (s, x.FV<SCAL>(), y.FV<SCAL>());
+  }
+
+  template <class SCAL>
+  void CompactElementByElementMatrix<SCAL> :: MultTransAdd (double s, const BaseVector & x, BaseVector & y) const
+  {
+    static Timer t("CompactEBE-matrix::MultTransAdd");
+    RegionTimer reg(t);
+    Apply<true> (s, x.FV<SCAL>(), y.FV<SCAL>());
+  }
+
+
+  template <class SCAL>
+  Matrix<SCAL> CompactElementByElementMatrix<SCAL> :: GetElementMatrix (int elnr) const
+  {
+    Matrix<SCAL> mat(rowdnums[elnr].Size(), coldnums[elnr].Size());
+    for (size_t i = 0; i < mat.Height(); i++)
+      for (size_t j = 0; j < mat.Width(); j++)
+        mat(i,j) = *EntryPtr(elnr, i, j);
+    return mat;
+  }
+
+  template <class SCAL>
+  size_t CompactElementByElementMatrix<SCAL> :: NZE () const
+  {
+    size_t nze = 0;
+    for (size_t g = 0; g < group_sizes.Size(); g++)
+      nze += group_elements[g].Size() * group_sizes[g][0] * group_sizes[g][1];
+    return nze;
+  }
+
+  template <class SCAL>
+  Array<MemoryUsage> CompactElementByElementMatrix<SCAL> :: GetMemoryUsage () const
+  {
+    return { { "CompactEBE", arena.Size()*sizeof(SIMD<double>), 1 } };
+  }
+
+  template <class SCAL>
+  ostream & CompactElementByElementMatrix<SCAL> :: Print (ostream & ost) const
+  {
+    ost << "Compact Element-by-Element Matrix:" << endl;
+    ost << "num blocks = " << rowdnums.Size() << ", groups = " << group_sizes.Size() << endl;
+    for (int i = 0; i < rowdnums.Size(); i++)
+      {
+        ost << "block " << i << endl;
+        ost << "rows = " << rowdnums[i] << endl;
+        ost << "cols = " << coldnums[i] << endl;
+        ost << "matrix = " << GetElementMatrix(i) << endl;
+      }
+    return ost;
+  }
+
+  template class CompactElementByElementMatrix<double>;
+  template class CompactElementByElementMatrix<Complex>;
+
   
   ConstantElementByElementMatrix ::
   ConstantElementByElementMatrix (size_t ah, size_t aw, Matrix<> amatrix,
@@ -116,7 +116,82 @@ namespace ngla
     }
     
     size_t NZE () const override { return GetNZE(); }
-  };  
+  };
+
+
+
+  /**
+     Element-by-element matrix with all element matrices in one arena.
+
+     Elements are grouped by their matrix size. Within a group,
+     SIMD<double>::Size() consecutive elements form a batch, and entry
+     (i,j) of all elements of a batch is stored contiguously. Thus the
+     batch is applied by a single SIMD matrix-vector product.
+     The sizes must be known in advance, they count the non-negative
+     row and col dofs passed to AddElementMatrix.
+   */
+  template <class SCAL>
+  class NGS_DLL_HEADER CompactElementByElementMatrix : public BaseMatrix
+  {
+    size_t height, width;
+    bool disjointrows, disjointcols;
+    Table<int> rowdnums, coldnums;
+
+    /// (rows, cols) of every group
+    Array<INT<2>> group_sizes;
+    Table<int> group_elements;
+    /// first batch of the group in the arena
+    Array<size_t> group_first;
+    /// group and position in group of every element
+    Array<int> elgroup, elpos;
+    Array<SIMD<double>> arena;
+
+  public:
+    CompactElementByElementMatrix (size_t h, size_t w,
+                                   FlatArray<int> nrowi, FlatArray<int> ncoli,
+                                   bool adisjointrows, bool adisjointcols);
+
+    bool IsComplex() const override { return typeid(SCAL)==typeid(Complex); }
+    int VHeight() const override { return height; }
+    int VWidth() const override { return width; }
+
+    AutoVector CreateRowVector () const override { return make_shared<VVector<SCAL>> (width); }
+    AutoVector CreateColVector () const override { return make_shared<VVector<SCAL>> (height); }
+
+    void MultAdd (double s, const BaseVector & x, BaseVector & y) const override;
+    void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override;
+
+    /// negative dofs are skipped. Thread-safe for distinct elements
+    void AddElementMatrix (int elnr,
+                           FlatArray<int> dnums1,
+                           FlatArray<int> dnums2,
+                           BareSliceMatrix<SCAL> elmat);
+
+    FlatArray<int> GetElementRowDNums (int elnr) const { return rowdnums[elnr]; }
+    FlatArray<int> GetElementColumnDNums (int elnr) const { return coldnums[elnr]; }
+    Matrix<SCAL> GetElementMatrix (int elnr) const;
+
+    size_t NZE () const override;
+    Array<MemoryUsage> GetMemoryUsage () const override;
+    ostream & Print (ostream & ost) const override;
+
+  private:
+    template <bool TRANS>
+    void Apply (double s, FlatVector<SCAL> fx, FlatVector<SCAL> fy) const;
+
+    /// the SW entries (i,j) of the batch containing element elnr
+    SCAL * EntryPtr (int elnr, size_t i, size_t j) const
+    {
+      constexpr size_t SW = SIMD<double>::Size();
+      constexpr size_t SS = sizeof(SCAL)/sizeof(double);
+      int g = elgroup[elnr];
+      size_t w = group_sizes[g][1];
+      size_t batchsize = group_sizes[g][0]*w*SS;
+      const SIMD<double> * p = &arena[group_first[g]+(elpos[elnr]/SW)*batchsize+(i*w+j)*SS];
+      return const_cast<SCAL*> (reinterpret_cast<const SCAL*> (p)) + elpos[elnr]%SW;
+    }
+  };
+
 
 
   class NGS_DLL_HEADER ConstantElementByElementMatrix : public BaseMatrix
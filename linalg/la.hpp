@@ -42,6 +42,7 @@ namespace ngla
 #include "commutingAMG.hpp"
 #include "special_matrix.hpp"
 #include "elementbyelement.hpp"
+#include "statcond.hpp"
 #include "cg.hpp"
 #include "chebyshev.hpp"
 #include "eigen.hpp"
@@ -1059,16 +1059,47 @@ inverse : string
     
   py::class_<KrylovSpaceSolver, shared_ptr<KrylovSpaceSolver>, BaseMatrix> (m, "KrylovSpaceSolver")
     .def("GetSteps", &KrylovSpaceSolver::GetSteps)
+    .def("Solve", [](KrylovSpaceSolver & self, const BaseVector & rhs, BaseVector & sol, bool initialize)
+         {
+           self.SetInitialize (initialize);
+           self.Mult (rhs, sol);
+         }, py::arg("rhs"), py::arg("sol"), py::arg("initialize")=true,
+         py::call_guard<py::gil_scoped_release>(), docu_string(R"raw_string(
+Solves for rhs, the work vectors are kept for the next call.
+
+Parameters:
+
+rhs : ngsolve.la.BaseVector
+  input right hand side
+
+sol : ngsolve.la.BaseVector
+  solution vector, used as initial guess if initialize is False
+
+initialize : bool
+  start from zero
+
+)raw_string"))
+    .def_property_readonly("iterations", &KrylovSpaceSolver::GetSteps, "number of iterations of the last solve")
+    .def_property_readonly("errors", [](KrylovSpaceSolver & self)
+                           {
+                             py::list errors;
+                             for (double err : self.GetErrors())
+                               errors.append (err);
+                             return errors;
+                           }, "residuals of the last solve, starting with the initial residual")
+    .def("FreeWorkVectors", &KrylovSpaceSolver::FreeWorkVectors, "release memory of work vectors")
     ;
 
   m.def("CGSolver", [](shared_ptr<BaseMatrix> mat, shared_ptr<BaseMatrix> pre,
                                           bool iscomplex, bool printrates, 
-                                          double precision, int maxsteps)
+                                          double precision, int maxsteps, bool conjugate)
                                        {
                                          shared_ptr<KrylovSpaceSolver> solver;
                                          if(mat->IsComplex()) iscomplex = true;
                                          
-                                         if (iscomplex)
+                                         if (iscomplex && conjugate)
+                                           solver = make_shared<CGSolver<ComplexConjugate>> (mat, pre);
+                                         else if (iscomplex)
                                            solver = make_shared<CGSolver<Complex>> (mat, pre);
                                          else
                                            solver = make_shared<CGSolver<double>> (mat, pre);
@@ -1078,7 +1109,7 @@ inverse : string
                                          return solver;
                                        },
            py::arg("mat"), py::arg("pre"), py::arg("complex") = false, py::arg("printrates")=true,
-        py::arg("precision")=1e-8, py::arg("maxsteps")=200, docu_string(R"raw_string(
+        py::arg("precision")=1e-8, py::arg("maxsteps")=200, py::arg("conjugate")=false, docu_string(R"raw_string(
 A CG Solver.
 
 Parameters:
@@ -1101,6 +1132,47 @@ precision : float
 maxsteps : int
   input maximal steps. CGSolver stops after this steps.
 
+conjugate : bool
+  use the hermitian inner product for complex matrices
+
+)raw_string"))
+    ;
+
+  m.def("BiCGStabSolver", [](shared_ptr<BaseMatrix> mat, shared_ptr<BaseMatrix> pre,
+                             bool printrates, 
+                             double precision, int maxsteps)
+        {
+          shared_ptr<KrylovSpaceSolver> solver;
+          if (!mat->IsComplex())
+            solver = make_shared<BiCGStabSolver<double>> (mat, pre);
+          else
+            solver = make_shared<BiCGStabSolver<Complex>> (mat, pre);
+          solver->SetPrecision(precision);
+          solver->SetMaxSteps(maxsteps);
+          solver->SetPrintRates (printrates);
+          return solver;
+        },
+        py::arg("mat"), py::arg("pre"), py::arg("printrates")=true,
+        py::arg("precision")=1e-8, py::arg("maxsteps")=200, docu_string(R"raw_string(
+A BiCGStab Solver.
+
+Parameters:
+
+mat : ngsolve.la.BaseMatrix
+  input matrix 
+
+pre : ngsolve.la.BaseMatrix
+  input preconditioner matrix
+
+printrates : bool
+  input printrates
+
+precision : float
+  input requested precision. BiCGStabSolver stops if precision is reached.
+
+maxsteps : int
+  input maximal steps. BiCGStabSolver stops after this steps.
+
 )raw_string"))
     ;
 
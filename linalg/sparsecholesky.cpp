@@ -580,7 +580,7 @@ namespace ngla
     static Timer timerb("SparseCholesky::Factor - B", 3);
     static Timer timerc("SparseCholesky::Factor - C", 3);
 
-    RegionTimer reg (factor_timer);
+    TraceRegion reg (factor_timer);
 
     
     int n = nused; // Height();
@@ -939,7 +939,7 @@ namespace ngla
     // static Timer timerc1("SparseCholesky::Factor - merge1", 2);
     // static Timer timerc2("SparseCholesky::Factor - merge2", 2);
 
-    RegionTimer reg (factor_timer);
+    TraceRegion reg (factor_timer);
     
     size_t n = nused; // Height();
     if (n > 2000){
@@ -1925,8 +1925,10 @@ namespace ngla
   MultAdd (TSCAL_VEC s, const BaseVector & x, BaseVector & y) const
   {
     static Timer timer("SparseCholesky<d,d,d>::MultAdd");
-    RegionTimer reg (timer);
-    timer.AddFlops (2.0*lfact.Size());
+    TraceRegion reg (timer);
+    reg.AddFlops (2.0*lfact.Size());
+    // factor and its row indices are read twice, forward and backward
+    reg.AddBytes (2.0*lfact.Size()*sizeof(TM) + 2.0*rowindex2.Size()*sizeof(int));
 
     // int n = Height();
     
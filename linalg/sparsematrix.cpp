@@ -115,11 +115,17 @@ namespace ngla
 	firsti.SetSize (size+1);
 	// colnr.SetSize (nze);
         colnr = NumaDistributedArray<int> (nze);
-        
-	for (int i = 0; i < size+1; i++)
-	  firsti[i] = graph.firsti[i];
-	for (size_t i = 0; i < nze; i++)
-	  colnr[i] = graph.colnr[i];
+
+        ParallelForRange (size+1, [&] (IntRange r)
+                          { firsti[r] = graph.firsti[r]; });
+        CalcBalancing ();
+        // copy rows by the threads working on them (numa first touch)
+        ParallelFor (balance, [&] (int row)
+                     {
+                       colnr.Range(firsti[row], firsti[row+1]) =
+                         graph.colnr.Range(firsti[row], firsti[row+1]);
+                     });
+        return;
       }
     // inversetype = agraph.GetInverseType();
     CalcBalancing ();
@@ -130,8 +130,10 @@ namespace ngla
   void SparseMatrix<TM,TV_ROW,TV_COL> ::
   MultAdd (double s, const BaseVector & x, BaseVector & y) const
   {
-    static Timer t("SparseMatrix::MultAdd"); RegionTimer reg(t);
-    t.AddFlops (this->NZE());
+    static Timer t("SparseMatrix::MultAdd"); TraceRegion reg(t);
+    reg.AddFlops (this->NZE());
+    reg.AddBytes (this->NZE()*(sizeof(TM)+sizeof(int)) + this->Height()*sizeof(size_t)
+                  + x.Size()*sizeof(TVX) + 2*y.Size()*sizeof(TVY));
 
     if (task_manager)
       {
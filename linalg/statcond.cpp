@@ -0,0 +1,379 @@
+/*********************************************************************/
+/* File:   statcond.cpp                                              */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+/*
+   Static condensation of element-interior dofs
+*/
+
+#include <la.hpp>
+
+namespace ngla
+{
+
+  /*
+    LU factorization with row pivoting, P A = L U, L unit lower.
+    Row i was interchanged with row p[i] in step i.
+    Right-looking and blocked: the panels are factored column by column,
+    the trailing matrix is updated by matrix products, which are the
+    ngblas kernels for double.
+  */
+  template <typename SCAL>
+  static void CalcLU (SliceMatrix<SCAL> a, FlatArray<int> p)
+  {
+    constexpr size_t bs = 32;
+    size_t n = a.Height();
+
+    for (size_t i1 = 0; i1 < n; i1 += bs)
+      {
+        size_t i2 = min2(n, i1+bs);
+
+        for (size_t i = i1; i < i2; i++)
+          {
+            size_t imax = i;
+            double vmax = abs(a(i,i));
+            for (size_t j = i+1; j < n; j++)
+              if (abs(a(j,i)) > vmax)
+                {
+                  imax = j;
+                  vmax = abs(a(j,i));
+                }
+            p[i] = imax;
+            if (vmax == 0)
+              throw Exception ("StaticCondensation: singular interior block");
+
+            if (imax != i)
+              for (size_t k = 0; k < n; k++)
+                Swap (a(i,k), a(imax,k));
+
+            SCAL inv = SCAL(1.0) / a(i,i);
+            for (size_t j = i+1; j < n; j++)
+              {
+                SCAL lji = a(j,i) * inv;
+                a(j,i) = lji;
+                for (size_t k = i+1; k < i2; k++)
+                  a(j,k) -= lji * a(i,k);
+              }
+          }
+
+        if (i2 == n) break;
+
+        // U12 = L11^{-1} A12
+        for (size_t i = i1+1; i < i2; i++)
+          for (size_t j = i1; j < i; j++)
+            a.Row(i).Range(i2,n) -= a(i,j) * a.Row(j).Range(i2,n);
+
+        // A22 -= L21 U12
+        a.Rows(i2,n).Cols(i2,n) -= a.Rows(i2,n).Cols(i1,i2) * a.Rows(i1,i2).Cols(i2,n);
+      }
+  }
+
+  /*
+    x <- A^{-1} x, or A^{-T} x, for all columns of x.
+    A = P^T L U,  A^T = U^T L^T P
+  */
+  template <typename SCAL>
+  static void SolveLU (SliceMatrix<SCAL> a, FlatArray<int> p, SliceMatrix<SCAL> x, bool trans)
+  {
+    size_t n = a.Height();
+    auto swap_rows = [&] (size_t i)
+      {
+        if (size_t(p[i]) != i)
+          for (size_t k = 0; k < x.Width(); k++)
+            Swap (x(i,k), x(p[i],k));
+      };
+
+    if (!trans)
+      {
+        for (size_t i = 0; i < n; i++)
+          swap_rows (i);
+        for (size_t i = 1; i < n; i++)
+          x.Row(i) -= Trans(x.Rows(0,i)) * a.Row(i).Range(0,i);
+        for (size_t i = n; i-- > 0; )
+          {
+            x.Row(i) -= Trans(x.Rows(i+1,n)) * a.Row(i).Range(i+1,n);
+            x.Row(i) *= SCAL(1.0) / a(i,i);
+          }
+      }
+    else
+      {
+        for (size_t i = 0; i < n; i++)
+          {
+            x.Row(i) -= Trans(x.Rows(0,i)) * a.Col(i).Range(0,i);
+            x.Row(i) *= SCAL(1.0) / a(i,i);
+          }
+        for (size_t i = n-1; i-- > 0; )
+          x.Row(i) -= Trans(x.Rows(i+1,n)) * a.Col(i).Range(i+1,n);
+        for (size_t i = n; i-- > 0; )
+          swap_rows (i);
+      }
+  }
+
+
+
+  template <class SCAL>
+  StaticCondensation<SCAL> ::
+  StaticCondensation (size_t andof, FlatArray<int> nidofs, FlatArray<int> nodofs,
+                      bool asymmetric)
+    : ndof(andof), symmetric(asymmetric),
+      idnums(nidofs), odnums(nodofs), pivots(nidofs)
+  {
+    static Timer t("StaticCondensation::ctor"); RegionTimer reg(t);
+    size_t ne = nidofs.Size();
+
+    condensed.SetSize (ne);
+    condensed = false;
+
+    // group elements of equal sizes
+    Array<int> elgroup(ne);
+    for (size_t i = 0; i < ne; i++)
+      {
+        elgroup[i] = -1;
+        if (nidofs[i] == 0) continue;
+        INT<2> key(nidofs[i], nodofs[i]);
+        int pos = -1;
+        for (size_t j = 0; j < group_sizes.Size(); j++)
+          if (group_sizes[j] == key) pos = j;
+        if (pos == -1)
+          {
+            pos = group_sizes.Size();
+            group_sizes.Append (key);
+          }
+        elgroup[i] = pos;
+      }
+
+    Array<int> cnt(group_sizes.Size());
+    cnt = 0;
+    for (auto g : elgroup)
+      if (g != -1) cnt[g]++;
+    group_elements = Table<int> (cnt);
+    cnt = 0;
+    for (size_t i = 0; i < ne; i++)
+      if (elgroup[i] != -1)
+        group_elements[elgroup[i]][cnt[elgroup[i]]++] = i;
+
+    // arena layout: group by group, element by element
+    first.SetSize (ne);
+    first = 0;
+    size_t totsize = 0;
+    for (size_t g = 0; g < group_sizes.Size(); g++)
+      {
+        size_t ni = group_sizes[g][0], no = group_sizes[g][1];
+        size_t elsize = ni*ni + no*ni + (symmetric ? 0 : no*ni);
+        for (auto elnr : group_elements[g])
+          {
+            first[elnr] = totsize;
+            totsize += elsize;
+          }
+      }
+    arena.SetSize (totsize);
+
+    // first touch by the threads applying the operators
+    for (size_t g = 0; g < group_sizes.Size(); g++)
+      {
+        size_t ni = group_sizes[g][0], no = group_sizes[g][1];
+        size_t elsize = ni*ni + no*ni + (symmetric ? 0 : no*ni);
+        FlatArray<int> els = group_elements[g];
+        ParallelForRange (els.Size(), [&] (IntRange r)
+                          {
+                            for (auto i : r)
+                              arena.Range(first[els[i]], first[els[i]]+elsize) = SCAL(0.0);
+                          });
+      }
+  }
+
+
+  template <class SCAL>
+  void StaticCondensation<SCAL> ::
+  Condense (size_t elnr, FlatArray<int> aidnums, FlatArray<int> aodnums,
+            FlatMatrix<SCAL> a, FlatMatrix<SCAL> b,
+            FlatMatrix<SCAL> c, FlatMatrix<SCAL> d, LocalHeap & lh)
+  {
+    static Timer tfac("StaticCondensation::Condense - factor");
+    static Timer tmult("StaticCondensation::Condense - mult");
+    HeapReset hr(lh);
+    size_t ni = d.Height();
+    size_t no = a.Height();
+    if (ni != idnums[elnr].Size() || no != odnums[elnr].Size())
+      throw Exception ("StaticCondensation::Condense, illegal element size:\n"
+                       "ni = " + ToString(ni) + ", expected " + ToString(idnums[elnr].Size()) + "\n"
+                       "no = " + ToString(no) + ", expected " + ToString(odnums[elnr].Size()));
+
+    idnums[elnr] = aidnums;
+    odnums[elnr] = aodnums;
+
+    {
+      ThreadRegionTimer reg (tfac, TaskManager::GetThreadId());
+      NgProfiler::AddThreadFlops (tfac, TaskManager::GetThreadId(), 2*ni*ni*ni/3);
+      FlatMatrix<SCAL> fac = GetFactor(elnr);
+      fac = d;
+      CalcLU<SCAL> (fac, pivots[elnr]);
+      GetC(elnr) = c;
+      if (!symmetric)
+        GetB(elnr) = b;
+    }
+
+    ThreadRegionTimer reg (tmult, TaskManager::GetThreadId());
+    NgProfiler::AddThreadFlops (tmult, TaskManager::GetThreadId(), ni*ni*no + no*ni*no);
+
+    // a -= b D^{-1} c^T
+    FlatMatrix<SCAL> hct (ni, no, lh);
+    hct = Trans(c);
+    SolveInner (elnr, hct, false);
+    a -= b * hct;
+    condensed[elnr] = true;
+  }
+
+
+  template <class SCAL>
+  void StaticCondensation<SCAL> :: SolveInner (size_t elnr, SliceMatrix<SCAL> x, bool trans) const
+  {
+    SolveLU<SCAL> (GetFactor(elnr), pivots[elnr], x, trans);
+  }
+
+
+  template <class SCAL>
+  void StaticCondensation<SCAL> ::
+  Apply (OPERATOR op, double s, const BaseVector & x, BaseVector & y, bool trans) const
+  {
+    static Timer t("StaticCondensation::Apply");
+    static Timer tinner("StaticCondensation::Apply inner solve");
+    static Timer tharm("StaticCondensation::Apply harmonic extension");
+    RegionTimer reg(t);
+    RegionTimer reg2(op == INNER_SOLVE ? tinner : tharm);
+
+    FlatVector<SCAL> fx = x.FV<SCAL>();
+    FlatVector<SCAL> fy = y.FV<SCAL>();
+
+    for (size_t g = 0; g < group_sizes.Size(); g++)
+      {
+        size_t ni = group_sizes[g][0], no = group_sizes[g][1];
+        FlatArray<int> els = group_elements[g];
+
+        ParallelForRange
+          (els.Size(), [&] (IntRange r)
+           {
+             // all elements of the group have the same sizes
+             STACK_ARRAY(SCAL, memi, ni);
+             STACK_ARRAY(SCAL, memo, no);
+             FlatMatrix<SCAL> hi(ni, 1, &memi[0]);
+             FlatMatrix<SCAL> ho(no, 1, &memo[0]);
+             size_t flops = 0;
+
+             for (auto k : r)
+               {
+                 int elnr = els[k];
+                 if (!condensed[elnr]) continue;
+                 FlatArray<int> ind = idnums[elnr];
+                 FlatArray<int> outd = odnums[elnr];
+
+                 // interior dofs of different elements are disjoint, exterior dofs are shared
+                 auto gather_inner = [&] ()
+                   {
+                     for (size_t i = 0; i < ni; i++)
+                       hi(i,0) = (ind[i] >= 0) ? fx(ind[i]) : SCAL(0.0);
+                   };
+                 auto scatter_inner = [&] (SCAL fac)
+                   {
+                     for (size_t i = 0; i < ni; i++)
+                       if (ind[i] >= 0)
+                         fy(ind[i]) += fac * hi(i,0);
+                   };
+                 auto scatter_outer = [&] (SCAL fac)
+                   {
+                     for (size_t i = 0; i < no; i++)
+                       AtomicAdd (fy(outd[i]), SCAL(fac * ho(i,0)));
+                   };
+
+                 switch (op)
+                   {
+                   case INNER_SOLVE:
+                     {
+                       gather_inner();
+                       SolveInner (elnr, hi, trans);
+                       scatter_inner (s);
+                       flops += 2*ni*ni;
+                       break;
+                     }
+
+                   case HARMONIC_EXTENSION:
+                     {
+                       // -D^{-1} C^T,  or  -C D^{-T}
+                       FlatMatrix<SCAL> mc = GetC(elnr);
+                       if (!trans)
+                         {
+                           for (size_t i = 0; i < no; i++)
+                             ho(i,0) = fx(outd[i]);
+                           hi = Trans(mc) * ho;
+                           SolveInner (elnr, hi, false);
+                           scatter_inner (-s);
+                         }
+                       else
+                         {
+                           gather_inner();
+                           SolveInner (elnr, hi, true);
+                           ho = mc * hi;
+                           scatter_outer (-s);
+                         }
+                       flops += 2*ni*ni + ni*no;
+                       break;
+                     }
+
+                   case HARMONIC_EXTENSION_TRANS:
+                     {
+                       // -B D^{-1},  or  -D^{-T} B^T
+                       FlatMatrix<SCAL> mb = GetB(elnr);
+                       if (!trans)
+                         {
+                           gather_inner();
+                           SolveInner (elnr, hi, false);
+                           ho = mb * hi;
+                           scatter_outer (-s);
+                         }
+                       else
+                         {
+                           for (size_t i = 0; i < no; i++)
+                             ho(i,0) = fx(outd[i]);
+                           hi = Trans(mb) * ho;
+                           SolveInner (elnr, hi, true);
+                           scatter_inner (-s);
+                         }
+                       flops += 2*ni*ni + ni*no;
+                       break;
+                     }
+                   }
+               }
+             t.AddFlops (flops);
+           });
+      }
+  }
+
+
+
+  template <class SCAL>
+  Array<MemoryUsage> StaticCondensationMatrix<SCAL> :: GetMemoryUsage () const
+  {
+    // the arena is shared by all operators, report it once
+    if (op != StaticCondensation<SCAL>::INNER_SOLVE)
+      return Array<MemoryUsage>();
+    return { { "StaticCondensation", statcond->GetArenaSize()*sizeof(SCAL), 1 } };
+  }
+
+  template <class SCAL>
+  ostream & StaticCondensationMatrix<SCAL> :: Print (ostream & ost) const
+  {
+    string names[] = { "harmonic extension", "harmonic extension trans", "inner solve" };
+    ost << "Static condensation operator: " << names[op] << endl
+        << "ndof = " << statcond->GetNDof()
+        << ", groups = " << statcond->GetNGroups()
+        << ", symmetric = " << statcond->IsSymmetric() << endl;
+    return ost;
+  }
+
+
+  template class StaticCondensation<double>;
+  template class StaticCondensation<Complex>;
+  template class StaticCondensationMatrix<double>;
+  template class StaticCondensationMatrix<Complex>;
+}
@@ -0,0 +1,133 @@
+#ifndef FILE_NGS_STATCOND
+#define FILE_NGS_STATCOND
+
+/* ************************************************************************/
+/* File:   statcond.hpp                                                   */
+/* Date:   Oct. 2026                                                      */
+/* ************************************************************************/
+
+/*
+   Static condensation of element-interior dofs
+*/
+
+namespace ngla
+{
+
+  /**
+     Static condensation data of all elements.
+
+     Elements are grouped by their number of interior and exterior
+     dofs. For every element we keep the LU factors (with row pivoting)
+     of the interior block D, and the coupling block C, for
+     non-symmetric problems also B. They live in one contiguous arena,
+     ordered by groups. Harmonic extensions and inner solves are
+     applied group by group with triangular solves, no inverses are
+     formed.
+
+     Negative interior dof-numbers (hidden dofs) are condensed, but
+     not read from or written to global vectors.
+   */
+  template <class SCAL>
+  class NGS_DLL_HEADER StaticCondensation
+  {
+  public:
+    enum OPERATOR { HARMONIC_EXTENSION, HARMONIC_EXTENSION_TRANS, INNER_SOLVE };
+
+  protected:
+    size_t ndof;
+    bool symmetric;
+    Table<int> idnums, odnums;
+    /// row interchanges of the LU factors, as in LAPACK's getrf
+    Table<int> pivots;
+    /// elements not condensed (yet) are skipped
+    Array<bool> condensed;
+    /// (interior, exterior) size of every group
+    Array<INT<2>> group_sizes;
+    Table<int> group_elements;
+    /// first entry of element data in arena
+    Array<size_t> first;
+    Array<SCAL> arena;
+
+  public:
+    /// nidofs are the numbers of interior dofs including hidden dofs
+    StaticCondensation (size_t andof, FlatArray<int> nidofs, FlatArray<int> nodofs,
+                        bool asymmetric);
+
+    /**
+        a -= b d^{-1} c^T, where b is (no x ni) and c is (no x ni).
+        Stores the factors of d, and c (and b) of element elnr.
+        Thread-safe for distinct elements.
+    */
+    void Condense (size_t elnr, FlatArray<int> aidnums, FlatArray<int> aodnums,
+                   FlatMatrix<SCAL> a, FlatMatrix<SCAL> b,
+                   FlatMatrix<SCAL> c, FlatMatrix<SCAL> d, LocalHeap & lh);
+
+    /// LU factors of the interior block, L unit lower
+    FlatMatrix<SCAL> GetFactor (size_t elnr) const
+    {
+      size_t ni = idnums[elnr].Size();
+      return FlatMatrix<SCAL> (ni, ni, const_cast<SCAL*> (arena.Data()+first[elnr]));
+    }
+
+    /// the coupling block C, of size no x ni
+    FlatMatrix<SCAL> GetC (size_t elnr) const
+    {
+      size_t ni = idnums[elnr].Size(), no = odnums[elnr].Size();
+      return FlatMatrix<SCAL> (no, ni, const_cast<SCAL*> (arena.Data()+first[elnr]+ni*ni));
+    }
+
+    /// the coupling block B, of size no x ni, equal to C if symmetric
+    FlatMatrix<SCAL> GetB (size_t elnr) const
+    {
+      if (symmetric) return GetC(elnr);
+      size_t ni = idnums[elnr].Size(), no = odnums[elnr].Size();
+      return FlatMatrix<SCAL> (no, ni, const_cast<SCAL*> (arena.Data()+first[elnr]+ni*ni+no*ni));
+    }
+
+    /// x <- D^{-1} x, or D^{-T} x, for all columns of x
+    void SolveInner (size_t elnr, SliceMatrix<SCAL> x, bool trans = false) const;
+
+    /// y += s * op * x,  or  y += s * Trans(op) * x
+    void Apply (OPERATOR op, double s, const BaseVector & x, BaseVector & y, bool trans) const;
+
+    size_t GetNDof () const { return ndof; }
+    bool IsSymmetric () const { return symmetric; }
+    size_t GetNGroups () const { return group_sizes.Size(); }
+    size_t GetArenaSize () const { return arena.Size(); }
+  };
+
+
+  /**
+     One of the condensation operators as a matrix:
+     the harmonic extension -D^{-1} C^T, its counterpart -B D^{-1},
+     or the inner solve D^{-1}.
+   */
+  template <class SCAL>
+  class NGS_DLL_HEADER StaticCondensationMatrix : public BaseMatrix
+  {
+    typedef typename StaticCondensation<SCAL>::OPERATOR OPERATOR;
+    shared_ptr<StaticCondensation<SCAL>> statcond;
+    OPERATOR op;
+  public:
+    StaticCondensationMatrix (shared_ptr<StaticCondensation<SCAL>> astatcond, OPERATOR aop)
+      : statcond(astatcond), op(aop) { ; }
+
+    bool IsComplex() const override { return typeid(SCAL)==typeid(Complex); }
+    int VHeight() const override { return statcond->GetNDof(); }
+    int VWidth() const override { return statcond->GetNDof(); }
+
+    AutoVector CreateRowVector () const override { return make_shared<VVector<SCAL>> (VWidth()); }
+    AutoVector CreateColVector () const override { return make_shared<VVector<SCAL>> (VHeight()); }
+
+    void MultAdd (double s, const BaseVector & x, BaseVector & y) const override
+    { statcond->Apply (op, s, x, y, false); }
+    void MultTransAdd (double s, const BaseVector & x, BaseVector & y) const override
+    { statcond->Apply (op, s, x, y, true); }
+
+    Array<MemoryUsage> GetMemoryUsage () const override;
+    ostream & Print (ostream & ost) const override;
+  };
+
+}
+
+#endif
@@ -15,6 +15,8 @@ namespace ngla
     TSCAL * pdata;
     int es;
     bool ownmem;
+    /// own memory, placed on the NUMA nodes of the threads working on it
+    NumaDistributedArray<TSCAL> mem;
     
   public:
     S_BaseVectorPtr (size_t as, int aes, void * adata) throw()
@@ -27,19 +29,20 @@ namespace ngla
     }
 
     S_BaseVectorPtr (size_t as, int aes)
+      : mem(as*aes)
     {
       this->size = as;
       es = aes;
-      pdata = new TSCAL[as*aes];
+      pdata = mem.Data();
       ownmem = true;
       this->entrysize = es * sizeof(TSCAL) / sizeof(double);
     }
 
     void SetSize (size_t as)
     {
-      if (ownmem) delete [] pdata;
       this->size = as;
-      pdata = new TSCAL[as*es];
+      mem = NumaDistributedArray<TSCAL> (as*es);
+      pdata = mem.Data();
       ownmem = true;
     }
 
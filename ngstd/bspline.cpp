@@ -10,7 +10,71 @@ namespace ngstd
                       Array<double> at,
                       Array<double> ac)
     : order(aorder), t(at), c(ac) 
-  { ; }
+  {
+    Tabulate();
+  }
+
+
+  void BSpline :: Tabulate ()
+  {
+    // de Boor's recursion with polynomials in s = x-t[m] on every knot interval
+    auto knot = [&] (int i) { return t[min2(i, int(t.Size())-1)]; };
+    auto coef = [&] (int j) { return (j >= 0 && j < c.Size()) ? c[j] : 0.0; };
+
+    breaks.SetSize0();
+    coefs.SetSize0();
+    Array<double> hc(order*order), hcnew(order);
+    for (int m = 0; m+1 < t.Size(); m++)
+      {
+        if (!(t[m] < t[m+1])) continue;
+
+        // hc[jj*order+k]: coefficient of s^k of polynomial j = m-order+1+jj
+        int first = m-order+1;
+        hc = 0.0;
+        for (int jj = 0; jj < order; jj++)
+          hc[jj*order] = coef(first+jj);
+        
+        for (int p = 1; p < order; p++)
+          for (int j = m; j >= m-order+1+p; j--)
+            {
+              int jj = j-first;
+              double denom = knot(j+order-p) - t[max2(j,0)];
+              hcnew = 0.0;
+              if (j >= 0 && denom != 0)
+                for (int k = 0; k < order; k++)
+                  {
+                    // (s + t[m]-t[j]) * hc[j] + (t[j+order-p]-t[m] - s) * hc[j-1], hc[-1] = 0
+                    double a = hc[jj*order+k];
+                    double b = (j > 0) ? hc[(jj-1)*order+k] : 0.0;
+                    hcnew[k] += ((t[m]-t[j]) * a + (knot(j+order-p)-t[m]) * b) / denom;
+                    if (k+1 < order)
+                      hcnew[k+1] += (a - b) / denom;
+                  }
+              for (int k = 0; k < order; k++)
+                hc[jj*order+k] = hcnew[k];
+            }
+        
+        breaks.Append (t[m]);
+        for (int k = 0; k < order; k++)
+          coefs.Append (hc[(order-1)*order+k]);
+      }
+    if (breaks.Size())
+      breaks.Append (t.Last());
+    else
+      breaks.Append (0);
+    for (int k = 0; k < order; k++)
+      coefs.Append (0);
+
+    size_t nseg = breaks.Size()-1;
+    bin_first.SetSize (max2(nseg, size_t(1)));
+    bin_invh = nseg ? bin_first.Size() / (breaks[nseg]-breaks[0]) : 0;
+    for (size_t b = 0, seg = 0; b < bin_first.Size(); b++)
+      {
+        double xb = breaks[0] + b / bin_invh;
+        while (seg+1 < nseg && xb >= breaks[seg+1]) seg++;
+        bin_first[b] = seg;
+      }
+  }
   
   
   BSpline BSpline :: Differentiate () const
@@ -77,67 +141,28 @@ namespace ngstd
   
   double BSpline :: Evaluate (double x) const
   {
-    // for (int m = order-1; m < t.Size()-order+1; m++)
-    // for (int m = 0; m < t.Size()-order+1; m++)
-    for (int m = 0; m < t.Size()-1; m++)
-      {
-        // cout << "m = " << m << endl;
-        if ( (t[m] <= x) && (x < t[m+1]))
-          {
-            Array<double> hc (c);
-            for (int p = 1; p < order; p++)
-              for (int j = m; j >= m-order+1+p; j--)
-                {
-                  // cout << "j = " << j << ", p = " << p << endl;
-                  if (j > 0)
-                    hc[j] = ((x-t[j]) * hc[j] + (t[j+order-p]-x) * hc[j-1])
-                      / (t[j+order-p]-t[j]);
-                  else if (j == 0)
-                    hc[j] = ((x-t[0]) * hc[j]) / (t[j+order-p]-t[j]);
-                }
-            return hc[m];
-          }
-      }
-    return 0;
+    double val, dval, ddval;
+    EvaluateTable<0> (x, val, dval, ddval);
+    return val;
   }
 
   AutoDiff<1> BSpline :: operator() (AutoDiff<1> x) const
   {
-    // double eps = 1e-5;
-    double val = (*this)(x.Value());
-    // double valr = (*this)(x.Value()+eps);
-    // double vall = (*this)(x.Value()-eps);
-    // double dval = (valr-vall) / (2*eps);
-
-    double dval2 = Differentiate()(x.Value());
-    // cout << "dval = " << dval << " =?= " << dval2 << endl;
-
+    double val, dval, ddval;
+    EvaluateTable<1> (x.Value(), val, dval, ddval);
     AutoDiff<1> res(val);
-    res.DValue(0) = dval2 * x.DValue(0);
+    res.DValue(0) = dval * x.DValue(0);
     return res;
   }
+  
   AutoDiffDiff<1> BSpline :: operator() (AutoDiffDiff<1> x) const
   {
-    /*
-    double eps = 1e-5;
-    double val = (*this)(x.Value());
-    double valr = (*this)(x.Value()+eps);
-    double vall = (*this)(x.Value()-eps);
-
-    double dval = (valr-vall) / (2*eps);
-    double ddval = (valr+vall-2*val) / (eps*eps);
-    */
-    auto diff = Differentiate();
-    auto ddiff = diff.Differentiate();
-    double val = (*this)(x.Value());
-    double dval = diff(x.Value());
-    double ddval = ddiff(x.Value());
-
+    double val, dval, ddval;
+    EvaluateTable<2> (x.Value(), val, dval, ddval);
     AutoDiffDiff<1> res(val);
     res.DValue(0) = dval * x.DValue(0);
     res.DDValue(0) = ddval * x.DValue(0)*x.DValue(0) + dval*x.DDValue(0);
     return res;
-
   }
  
   ostream & operator<< (ostream & ost, const BSpline & sp)
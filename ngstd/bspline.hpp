@@ -16,6 +16,15 @@ namespace ngstd
     int order;
     Array<double> t;
     Array<double> c;
+
+    // piecewise polynomial table: segment i is [breaks[i], breaks[i+1]),
+    // with coefficients of (x-breaks[i])^k at coefs[i*order+k].
+    // Segment breaks.Size()-1 is the zero polynomial, used outside the support.
+    Array<double> breaks;
+    Array<double> coefs;
+    // uniform bins over the support, first segment meeting the bin
+    Array<int> bin_first;
+    double bin_invh = 0;
     
   public:
     BSpline() = default;
@@ -28,6 +37,8 @@ namespace ngstd
     void DoArchive(Archive& ar)
     {
       ar & order & t & c;
+      if (ar.Input())
+        Tabulate();
     }
 
     BSpline Differentiate () const;
@@ -37,8 +48,85 @@ namespace ngstd
     double operator() (double x) const { return Evaluate(x); }
     AutoDiff<1> operator() (AutoDiff<1> x) const;
     AutoDiffDiff<1> operator() (AutoDiffDiff<1> x) const;
+
+    SIMD<double> operator() (SIMD<double> x) const
+    {
+      SIMD<double> val, dval, ddval;
+      EvaluateTable<0> (x, val, dval, ddval);
+      return val;
+    }
+    AutoDiff<1,SIMD<double>> operator() (AutoDiff<1,SIMD<double>> x) const
+    {
+      SIMD<double> val, dval, ddval;
+      EvaluateTable<1> (x.Value(), val, dval, ddval);
+      AutoDiff<1,SIMD<double>> res(val);
+      res.DValue(0) = dval * x.DValue(0);
+      return res;
+    }
+    AutoDiffDiff<1,SIMD<double>> operator() (AutoDiffDiff<1,SIMD<double>> x) const
+    {
+      SIMD<double> val, dval, ddval;
+      EvaluateTable<2> (x.Value(), val, dval, ddval);
+      AutoDiffDiff<1,SIMD<double>> res(val);
+      res.DValue(0) = dval * x.DValue(0);
+      res.DDValue(0) = ddval * x.DValue(0)*x.DValue(0) + dval*x.DDValue(0);
+      return res;
+    }
     
     friend ostream & operator<< (ostream & ost, const BSpline & sp);
+
+  private:
+    /// computes the piecewise polynomial table from knots and coefficients
+    void Tabulate ();
+
+    /// segment containing x, and x relative to the segment start
+    int FindSegment (double x, double & s) const
+    {
+      size_t nseg = breaks.Size()-1;
+      if (!(x >= breaks[0] && x < breaks[nseg]))   // also for nan
+        {
+          s = 0;
+          return nseg;
+        }
+      size_t bin = min2(size_t((x-breaks[0]) * bin_invh), bin_first.Size()-1);
+      int seg = bin_first[bin];
+      while (seg > 0 && x < breaks[seg]) seg--;
+      while (x >= breaks[seg+1]) seg++;
+      s = x - breaks[seg];
+      return seg;
+    }
+
+    /// value and up to DERIV derivatives by Horner's scheme
+    template <int DERIV, typename T>
+    void EvaluateTable (T x, T & val, T & dval, T & ddval) const
+    {
+      constexpr int SW = sizeof(T) / sizeof(double);
+      int seg[SW];
+      double sx[SW];
+      if constexpr (SW == 1)
+        seg[0] = FindSegment (x, sx[0]);
+      else
+        for (int i = 0; i < SW; i++)
+          seg[i] = FindSegment (x[i], sx[i]);
+      auto gather = [&] (int k)
+        {
+          if constexpr (SW == 1)
+            return T(coefs[seg[0]*order+k]);
+          else
+            return T([&] (int i) { return coefs[seg[i]*order+k]; });
+        };
+      T s;
+      if constexpr (SW == 1) s = sx[0];
+      else s = T([&] (int i) { return sx[i]; });
+
+      val = T(0.0), dval = T(0.0), ddval = T(0.0);
+      for (int k = order-1; k >= 0; k--)
+        {
+          if constexpr (DERIV >= 2) ddval = ddval * s + 2.0 * dval;
+          if constexpr (DERIV >= 1) dval = dval * s + val;
+          val = val * s + gather(k);
+        }
+    }
   };
 
   extern ostream & operator<< (ostream & ost, const BSpline & sp);
@@ -65,6 +65,10 @@ namespace ngstd
     globvariables.Update(eval2.globvariables);
     arguments.Update(eval2.arguments);
     num_arguments = eval2.num_arguments;
+    regprogram = eval2.regprogram;
+    num_registers = eval2.num_registers;
+    vectorizable = eval2.vectorizable;
+    lowered_size = eval2.lowered_size;
   }
 
   EvalFunction :: ~EvalFunction ()
@@ -78,6 +82,7 @@ namespace ngstd
     ReadNext();
     res_type = ParseExpression ();
     if (GetToken() != END) WriteBack();
+    Lower();
     return program.Size() > 0;
   }
 
@@ -447,6 +452,234 @@ namespace ngstd
 
 
 
+  void EvalFunction :: Lower ()
+  {
+    regprogram.SetSize0();
+    lowered_size = program.Size();
+    vectorizable = !res_type.iscomplex;
+
+    int stacksize = -1, maxstack = 0;
+    auto emit = [&] (EVAL_TOKEN op, int res, int a = 0, int b = 0)
+      {
+        instruction ins;
+        ins.op = op;
+        ins.res = res; ins.a = a; ins.b = b;
+        ins.comp = 0;
+        ins.operand.val = 0;
+        regprogram.Append (ins);
+        return &regprogram.Last();
+      };
+    // scratch register, above all stack positions
+    const int scratch = -2;
+    
+    for (int i = 0; i < program.Size() && vectorizable; i++)
+      {
+        auto & st = program[i];
+        switch (st.op)
+          {
+          case ADD: case SUB: case MULT: case DIV:
+          case AND: case OR: case GREATER: case GREATEREQUAL:
+          case EQUAL: case LESSEQUAL: case LESS: case ATAN2:
+            emit (st.op, stacksize-1, stacksize-1, stacksize);
+            stacksize--;
+            break;
+
+          case VEC_ADD: case VEC_SUB:
+            {
+              int dim = st.vecdim;
+              for (int j = 0; j < dim; j++)
+                emit (st.op == VEC_ADD ? ADD : SUB, stacksize-2*dim+j+1,
+                      stacksize-2*dim+j+1, stacksize-dim+j+1);
+              stacksize -= dim;
+              break;
+            }
+
+          case SCAL_VEC_MULT:
+            {
+              int dim = st.vecdim;
+              emit (MOVE, scratch, stacksize-dim);
+              for (int j = 0; j < dim; j++)
+                emit (MULT, stacksize-dim+j, scratch, stacksize-dim+j+1);
+              stacksize--;
+              break;
+            }
+
+          case VEC_VEC_MULT:
+            {
+              int dim = st.vecdim;
+              emit (MULT, scratch, stacksize-2*dim+1, stacksize-dim+1);
+              for (int j = 1; j < dim; j++)
+                emit (MULT_ADD, scratch, stacksize-2*dim+j+1, stacksize-dim+j+1);
+              stacksize -= 2*dim-1;
+              emit (MOVE, stacksize, scratch);
+              break;
+            }
+
+          case VEC_DIM:
+            {
+              int dim = program[i-1].vecdim;
+              stacksize -= dim-1;
+              emit (CONSTANT, stacksize)->operand.val = dim;
+              break;
+            }
+
+          case NEG: case NOT: case FUNCTION:
+          case SIN: case COS: case TAN: case ATAN: case EXP: case LOG:
+          case SIGN: case SQRT: case STEP:
+          case BESSELJ0: case BESSELJ1: case BESSELY0: case BESSELY1:
+            emit (st.op, stacksize, stacksize)->operand = st.operand;
+            break;
+
+          case ABS:
+            {
+              int dim = st.vecdim;
+              if (dim == 1)
+                emit (ABS, stacksize, stacksize);
+              else
+                {
+                  emit (MULT, scratch, stacksize, stacksize);
+                  for (int j = 1; j < dim; j++)
+                    emit (MULT_ADD, scratch, stacksize-j, stacksize-j);
+                  stacksize -= dim-1;
+                  emit (SQRT, stacksize, scratch);
+                }
+              break;
+            }
+
+          case CONSTANT: case GLOBVAR:
+            stacksize++;
+            emit (st.op, stacksize)->operand = st.operand;
+            break;
+
+          case VARIABLE:
+            for (int j = 0; j < st.vecdim; j++)
+              {
+                stacksize++;
+                emit (VARIABLE, stacksize)->operand.varnum = st.operand.varnum+j;
+              }
+            break;
+
+          case GLOBGENVAR:
+            if (st.operand.globgenvar->IsComplex())
+              vectorizable = false;
+            else
+              for (int j = 0; j < st.operand.globgenvar->Dimension(); j++)
+                {
+                  stacksize++;
+                  auto ins = emit (GLOBGENVAR, stacksize);
+                  ins->operand = st.operand;
+                  ins->comp = j;
+                }
+            break;
+            
+          case COMMA:
+            break;
+
+          default:   // VEC_ELEM (runtime index), IMAG
+            vectorizable = false;
+          }
+        maxstack = max2(maxstack, stacksize+1);
+      }
+
+    num_registers = maxstack+1;
+    for (auto & ins : regprogram)
+      for (int * r : { &ins.res, &ins.a, &ins.b })
+        if (*r == scratch) *r = maxstack;
+    if (!vectorizable)
+      regprogram.SetSize0();
+  }
+
+
+  void EvalFunction :: Eval (const SIMD<double> * x, size_t xdist,
+                             SIMD<double> * y, size_t ydist, size_t n) const
+  {
+    if (!IsVectorizable())
+      throw Exception ("EvalFunction cannot be evaluated in SIMD lanes");
+
+    ArrayMem<SIMD<double>, 256> regs(num_registers*n);
+    for (auto & ins : regprogram)
+      {
+        SIMD<double> * res = &regs[ins.res*n];
+        const SIMD<double> * a = &regs[ins.a*n];
+        const SIMD<double> * b = &regs[ins.b*n];
+        auto unary = [&] (auto func)
+          { for (size_t i = 0; i < n; i++) res[i] = func(a[i]); };
+        auto binary = [&] (auto func)
+          { for (size_t i = 0; i < n; i++) res[i] = func(a[i], b[i]); };
+        auto lanewise = [&] (auto func)
+          {
+            for (size_t i = 0; i < n; i++)
+              res[i] = SIMD<double>([&] (int k) { return func(a[i][k]); });
+          };
+        auto tobool = [&] (SIMD<double> v) { return IfPos(v-eps, SIMD<double>(1.0), SIMD<double>(0.0)); };
+        
+        switch (ins.op)
+          {
+          case ADD: binary ([] (auto a, auto b) { return a+b; }); break;
+          case SUB: binary ([] (auto a, auto b) { return a-b; }); break;
+          case MULT: binary ([] (auto a, auto b) { return a*b; }); break;
+          case DIV: binary ([] (auto a, auto b) { return a/b; }); break;
+          case MULT_ADD:
+            for (size_t i = 0; i < n; i++) res[i] += a[i]*b[i];
+            break;
+          case MOVE: unary ([] (auto a) { return a; }); break;
+          case NEG: unary ([] (auto a) { return -a; }); break;
+            
+          case AND: binary ([&] (auto a, auto b) { return tobool(a)*tobool(b); }); break;
+          case OR: binary ([&] (auto a, auto b) { return tobool(tobool(a)+tobool(b)); }); break;
+          case NOT: unary ([&] (auto a) { return 1.0-tobool(a); }); break;
+          case GREATER: binary ([] (auto a, auto b) { return IfPos(a-b, SIMD<double>(1.0), SIMD<double>(0.0)); }); break;
+          case LESS: binary ([] (auto a, auto b) { return IfPos(b-a, SIMD<double>(1.0), SIMD<double>(0.0)); }); break;
+          case GREATEREQUAL: binary ([] (auto a, auto b) { return IfPos(b-a, SIMD<double>(0.0), SIMD<double>(1.0)); }); break;
+          case LESSEQUAL: binary ([] (auto a, auto b) { return IfPos(a-b, SIMD<double>(0.0), SIMD<double>(1.0)); }); break;
+          case EQUAL:
+            binary ([&] (auto a, auto b)
+                    { return IfPos(IfPos(a-b, a-b, b-a)-eps, SIMD<double>(0.0), SIMD<double>(1.0)); });
+            break;
+            
+          case CONSTANT:
+            for (size_t i = 0; i < n; i++) res[i] = ins.operand.val;
+            break;
+          case VARIABLE:
+            for (size_t i = 0; i < n; i++) res[i] = x[ins.operand.varnum*xdist+i];
+            break;
+          case GLOBVAR:
+            for (size_t i = 0; i < n; i++) res[i] = *ins.operand.globvar;
+            break;
+          case GLOBGENVAR:
+            for (size_t i = 0; i < n; i++) res[i] = ins.operand.globgenvar->Value<double>(ins.comp);
+            break;
+
+          case FUNCTION: lanewise (ins.operand.fun); break;
+          case SIN: unary ([] (auto a) { return sin(a); }); break;
+          case COS: unary ([] (auto a) { return cos(a); }); break;
+          case TAN: unary ([] (auto a) { return tan(a); }); break;
+          case ATAN: unary ([] (auto a) { return atan(a); }); break;
+          case ATAN2: binary ([] (auto a, auto b) { return atan2(a, b); }); break;
+          case EXP: unary ([] (auto a) { return exp(a); }); break;
+          case LOG: unary ([] (auto a) { return log(a); }); break;
+          case ABS: unary ([] (auto a) { return IfPos(a, a, -a); }); break;
+          case SQRT: unary ([] (auto a) { return sqrt(a); }); break;
+          case SIGN:
+            unary ([] (auto a) { return IfPos(a, SIMD<double>(1.0), IfPos(-a, SIMD<double>(-1.0), SIMD<double>(0.0))); });
+            break;
+          case STEP: unary ([] (auto a) { return IfPos(-a, SIMD<double>(0.0), SIMD<double>(1.0)); }); break;
+          case BESSELJ0: lanewise ([] (double a) { return bessj0(a); }); break;
+          case BESSELJ1: lanewise ([] (double a) { return bessj1(a); }); break;
+          case BESSELY0: lanewise ([] (double a) { return bessy0(a); }); break;
+          case BESSELY1: lanewise ([] (double a) { return bessy1(a); }); break;
+            
+          default:
+            throw Exception ("undefined operation in EvalFunction register program");
+          }
+      }
+
+    for (int j = 0; j < res_type.vecdim; j++)
+      for (size_t i = 0; i < n; i++)
+        y[j*ydist+i] = regs[j*n+i];
+  }
+
+
   bool EvalFunction :: IsConstant () const
   {
     if (res_type.iscomplex) return false;
@@ -130,7 +130,8 @@ class NGS_DLL_HEADER EvalFunction
     AND, OR, NOT, GREATER, LESS, GREATEREQUAL, LESSEQUAL, EQUAL,
     CONSTANT, IMAG, VARIABLE, FUNCTION, GLOBVAR, GLOBGENVAR, /* COEFF_FUNC,*/ END, STRING,
     SIN, COS, TAN, ATAN, ATAN2, EXP, LOG, ABS, SIGN, SQRT, STEP,
-    BESSELJ0, BESSELY0, BESSELJ1, BESSELY1
+    BESSELJ0, BESSELY0, BESSELJ1, BESSELY1,
+    MOVE, MULT_ADD   // only in the register program
   };
 
 public:
@@ -176,6 +177,16 @@ public:
   template <typename TIN, typename TCALC>
   void Eval (const TIN * x, TCALC * stack) const;
 
+  /// can the function be evaluated in SIMD lanes ?
+  bool IsVectorizable () const
+  { return vectorizable && lowered_size == program.Size(); }
+  /**
+     evaluate for n SIMD blocks of points at once, 
+     argument j of block i is x[j*xdist+i], result component j is y[j*ydist+i]
+  */
+  void Eval (const SIMD<double> * x, size_t xdist,
+             SIMD<double> * y, size_t ydist, size_t n) const;
+
 
   /// is expression complex valued ?
   bool IsComplex () const;
@@ -287,6 +298,24 @@ protected:
   /// the evaluation sequence
   Array<step> program;
 
+  /// one operation of the register program, registers are the stack positions
+  struct instruction
+  {
+    EVAL_TOKEN op;
+    int res, a, b;
+    /// component of a generic variable
+    int comp;
+    step::UNION_OP operand;
+  };
+  /// the program lowered to registers, for real valued evaluation
+  Array<instruction> regprogram;
+  int num_registers = 0;
+  bool vectorizable = false;
+  size_t lowered_size = 0;
+
+  /// translates the stack program to the register program
+  void Lower ();
+
   class ResultType
   {
   public:
@@ -56,6 +56,8 @@ namespace ngstd
       Unload();
     }
 
+    const string & GetLibraryName() const { return lib_name; }
+
     template <typename TFunc>
     TFunc GetFunction( string func_name )
     {
@@ -153,6 +153,7 @@ namespace ngstd
 #include "polorder.hpp"
 #include "stringops.hpp"
 #include "statushandler.hpp"
+#include "profiling.hpp"
 
 #include "mpiwrapper.hpp"
 #ifndef WIN32
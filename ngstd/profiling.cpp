@@ -0,0 +1,267 @@
+/*********************************************************************/
+/* File:   profiling.cpp                                             */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+#include <ngstd.hpp>
+
+namespace ngstd
+{
+  bool ProfileTrace::enabled = false;
+  size_t ProfileTrace::sampling = 1;
+  size_t ProfileTrace::max_events = 1000000;
+  double ProfileTrace::starttime = 0;
+  Array<shared_ptr<ProfileTrace::ThreadData>> ProfileTrace::threads;
+
+
+  void ProfileTrace :: Enable (size_t asampling, size_t amaxevents)
+  {
+    sampling = max2 (asampling, size_t(1));
+    max_events = amaxevents;
+    Clear();
+    enabled = true;
+  }
+
+  void ProfileTrace :: Clear ()
+  {
+    threads.SetSize (TaskManager::GetMaxThreads());
+    for (auto & td : threads)
+      {
+        td = make_shared<ThreadData>();
+        td->events.SetAllocSize (min2 (max_events, size_t(10000)));
+        for (auto arr : { &td->time, &td->flops, &td->bytes })
+          {
+            arr->SetSize (NgProfiler::SIZE);
+            *arr = 0.0;
+          }
+        td->counts.SetSize (NgProfiler::SIZE);
+        td->counts = 0;
+      }
+    starttime = WallTime();
+  }
+
+  void ProfileTrace :: Record (ThreadData & td, int timernr, double start,
+                               double flops, double bytes)
+  {
+    double stop = WallTime();
+    td.time[timernr] += stop-start;
+    td.flops[timernr] += flops;
+    td.bytes[timernr] += bytes;
+    td.counts[timernr]++;
+    if (td.events.Size() < max_events)
+      td.events.Append (Event { timernr, td.depth, start, stop, flops, bytes });
+    else
+      td.dropped++;
+  }
+
+
+  static string JSONString (const string & str)
+  {
+    string res = "\"";
+    for (char c : str)
+      switch (c)
+        {
+        case '"': res += "\\\""; break;
+        case '\\': res += "\\\\"; break;
+        case '\n': res += "\\n"; break;
+        case '\t': res += "\\t"; break;
+        default:
+          if (static_cast<unsigned char>(c) < 0x20)
+            res += ' ';
+          else
+            res += c;
+        }
+    return res + "\"";
+  }
+
+  // finite numbers only, JSON has no inf or nan
+  static string JSONNumber (double val)
+  {
+    if (!std::isfinite(val)) return "0";
+    stringstream str;
+    str.precision(10);
+    str << val;
+    return str.str();
+  }
+
+
+  namespace
+  {
+    struct RegionNode
+    {
+      int timernr;
+      double time = 0, flops = 0, bytes = 0;
+      size_t counts = 0;
+      Array<shared_ptr<RegionNode>> children;
+
+      RegionNode (int nr) : timernr(nr) { ; }
+
+      RegionNode & Child (int nr)
+      {
+        for (auto & c : children)
+          if (c->timernr == nr) return *c;
+        children.Append (make_shared<RegionNode>(nr));
+        return *children.Last();
+      }
+
+      void Write (ostream & ost, string indent) const
+      {
+        ost << indent << "{ \"name\": " << JSONString (NgProfiler::timers[timernr].name)
+            << ", \"time\": " << JSONNumber(time)
+            << ", \"counts\": " << counts
+            << ", \"flops\": " << JSONNumber(flops)
+            << ", \"bytes\": " << JSONNumber(bytes)
+            << ", \"children\": [";
+        for (size_t i = 0; i < children.Size(); i++)
+          {
+            ost << (i ? ",\n" : "\n");
+            children[i]->Write (ost, indent+"  ");
+          }
+        ost << (children.Size() ? "\n"+indent : "") << "] }";
+      }
+    };
+  }
+
+
+  void ProfileTrace :: WriteJSON (ostream & ost)
+  {
+    static Timer t("ProfileTrace::WriteJSON");
+    RegionTimer reg(t);
+
+    size_t dropped = 0;
+    for (auto & td : threads)
+      dropped += td->dropped;
+
+    ost << "{\n"
+        << "\"threads\": " << threads.Size() << ",\n"
+        << "\"sampling\": " << sampling << ",\n"
+        << "\"dropped_events\": " << dropped << ",\n"
+        << "\"timers\": [";
+
+    bool first = true;
+    for (int nr = 0; nr < NgProfiler::SIZE; nr++)
+      {
+        if (NgProfiler::timers[nr].name.empty()) continue;
+
+        double time = NgProfiler::GetTime(nr);
+        double flops = NgProfiler::GetFlops(nr);
+        double bytes = 0, maxtime = 0;
+        for (auto & td : threads)
+          {
+            bytes += td->bytes[nr];
+            maxtime = max2 (maxtime, td->time[nr]);
+          }
+
+        ost << (first ? "\n" : ",\n");
+        first = false;
+        ost << "  { \"name\": " << JSONString (NgProfiler::timers[nr].name)
+            << ", \"nr\": " << nr
+            << ", \"time\": " << JSONNumber(time)
+            << ", \"counts\": " << NgProfiler::GetCounts(nr)
+            << ", \"flops\": " << JSONNumber(flops)
+            << ", \"GFlop/s\": " << JSONNumber(time > 0 ? 1e-9*flops/time : 0)
+            << ", \"bytes\": " << JSONNumber(bytes)
+            // regions on different threads run concurrently
+            << ", \"GB/s\": " << JSONNumber(maxtime > 0 ? 1e-9*bytes/maxtime : 0)
+            << ", \"threads\": [";
+
+        bool firstthread = true;
+        for (size_t tid = 0; tid < threads.Size(); tid++)
+          {
+            auto & td = *threads[tid];
+            if (!td.counts[nr]) continue;
+            ost << (firstthread ? "" : ", ");
+            firstthread = false;
+            ost << "{ \"thread\": " << tid
+                << ", \"time\": " << JSONNumber(td.time[nr])
+                << ", \"counts\": " << td.counts[nr]
+                << ", \"flops\": " << JSONNumber(td.flops[nr])
+                << ", \"bytes\": " << JSONNumber(td.bytes[nr])
+                << ", \"GFlop/s\": " << JSONNumber(td.time[nr] > 0 ? 1e-9*td.flops[nr]/td.time[nr] : 0)
+                << ", \"GB/s\": " << JSONNumber(td.time[nr] > 0 ? 1e-9*td.bytes[nr]/td.time[nr] : 0)
+                << " }";
+          }
+        ost << "] }";
+      }
+    ost << "\n],\n";
+
+    // tree of nested regions, merged over threads
+    RegionNode root(-1);
+    Array<int> index;
+    Array<RegionNode*> stack;
+    Array<int> stackdepth;
+    for (auto & td : threads)
+      {
+        auto & events = td->events;
+        index.SetSize (events.Size());
+        for (size_t i = 0; i < index.Size(); i++)
+          index[i] = i;
+        // events are stored when they end, parents before children here
+        QuickSort (index, [&events] (int a, int b)
+                   {
+                     return events[a].start < events[b].start ||
+                       (events[a].start == events[b].start && events[a].depth < events[b].depth);
+                   });
+
+        stack.SetSize0();
+        stackdepth.SetSize0();
+        for (int i : index)
+          {
+            auto & ev = events[i];
+            while (stackdepth.Size() && stackdepth.Last() >= ev.depth)
+              {
+                stack.DeleteLast();
+                stackdepth.DeleteLast();
+              }
+            RegionNode & parent = stack.Size() ? *stack.Last() : root;
+            RegionNode & node = parent.Child (ev.timernr);
+            node.time += ev.stop-ev.start;
+            node.flops += ev.flops;
+            node.bytes += ev.bytes;
+            node.counts++;
+            stack.Append (&node);
+            stackdepth.Append (ev.depth);
+          }
+      }
+
+    ost << "\"tree\": [";
+    for (size_t i = 0; i < root.children.Size(); i++)
+      {
+        ost << (i ? ",\n" : "\n");
+        root.children[i]->Write (ost, "  ");
+      }
+    ost << "\n]\n}\n";
+  }
+
+
+  void ProfileTrace :: WriteChromeTrace (ostream & ost)
+  {
+    static Timer t("ProfileTrace::WriteChromeTrace");
+    RegionTimer reg(t);
+
+    ost << "{ \"displayTimeUnit\": \"ms\",\n"
+        << "\"traceEvents\": [\n";
+    ost << "{ \"name\": \"process_name\", \"ph\": \"M\", \"pid\": 0, \"args\": { \"name\": \"ngsolve\" } }";
+
+    for (size_t tid = 0; tid < threads.Size(); tid++)
+      {
+        auto & td = *threads[tid];
+        if (!td.events.Size()) continue;
+        ost << ",\n{ \"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << tid
+            << ", \"args\": { \"name\": \"thread " << tid << "\" } }";
+        for (auto & ev : td.events)
+          {
+            ost << ",\n{ \"name\": " << JSONString (NgProfiler::timers[ev.timernr].name)
+                << ", \"cat\": \"ngsolve\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << tid
+                << ", \"ts\": " << JSONNumber(1e6*(ev.start-starttime))
+                << ", \"dur\": " << JSONNumber(1e6*(ev.stop-ev.start));
+            if (ev.flops || ev.bytes)
+              ost << ", \"args\": { \"flops\": " << JSONNumber(ev.flops)
+                  << ", \"bytes\": " << JSONNumber(ev.bytes) << " }";
+            ost << " }";
+          }
+      }
+    ost << "\n] }\n";
+  }
+
+}
@@ -0,0 +1,158 @@
+#ifndef FILE_NGS_PROFILING
+#define FILE_NGS_PROFILING
+
+/*********************************************************************/
+/* File:   profiling.hpp                                             */
+/* Date:   Oct. 2026                                                 */
+/*********************************************************************/
+
+namespace ngstd
+{
+
+  /**
+     Per-thread recording of nested timer regions, on top of the
+     NgProfiler timers.
+
+     Regions opened by a TraceRegion are recorded as events with
+     thread, start and stop time, flops and bytes moved. Reports are
+     written as JSON (all timers with per-thread breakdown, and the
+     tree of nested regions), or as Chrome trace events for
+     chrome://tracing or ui.perfetto.dev.
+
+     In sampling mode only every n-th outermost region of a thread is
+     recorded, together with all regions nested inside. If recording
+     is disabled, a TraceRegion costs one branch more than a
+     RegionTimer.
+
+     Enable, Disable and Clear must not be called inside a TraceRegion.
+  */
+  class NGS_DLL_HEADER ProfileTrace
+  {
+  public:
+    struct Event
+    {
+      int timernr;
+      int depth;
+      double start, stop;
+      double flops, bytes;
+    };
+
+    struct ThreadData
+    {
+      Array<Event> events;
+      size_t dropped = 0;
+      int depth = 0;
+      bool sampled = false;
+      size_t outermost = 0;
+      /// accumulated over recorded regions, per timer
+      Array<double> time, flops, bytes;
+      Array<size_t> counts;
+    };
+
+  private:
+    static bool enabled;
+    static size_t sampling;
+    static size_t max_events;
+    static double starttime;
+    static Array<shared_ptr<ThreadData>> threads;
+
+  public:
+    /// records every sampling-th outermost region, at most maxevents per thread
+    static void Enable (size_t asampling = 1, size_t amaxevents = 1000000);
+    /// stops recording, the recorded data are kept
+    static void Disable () { enabled = false; }
+    static void Clear ();
+    static bool IsEnabled () { return enabled; }
+    static size_t GetSampling () { return sampling; }
+
+    /// thread data if recording is enabled, nullptr else
+    static ThreadData * Enter (int tid)
+    {
+      if (!enabled || tid >= threads.Size()) return nullptr;
+      ThreadData & td = *threads[tid];
+      if (td.depth == 0)
+        td.sampled = (td.outermost++ % sampling) == 0;
+      td.depth++;
+      return &td;
+    }
+
+    static void Leave (ThreadData & td, int timernr, double start,
+                       double flops, double bytes)
+    {
+      td.depth--;
+      if (td.sampled)
+        Record (td, timernr, start, flops, bytes);
+    }
+
+    /// timers with per-thread breakdown, GFlop/s and GB/s, and the region tree
+    static void WriteJSON (ostream & ost);
+    /// complete events ("ph":"X") per thread, times in microseconds
+    static void WriteChromeTrace (ostream & ost);
+
+  private:
+    static void Record (ThreadData & td, int timernr, double start,
+                        double flops, double bytes);
+  };
+
+
+  /**
+     A RegionTimer (or ThreadRegionTimer, if the thread id is given),
+     which is also recorded by the ProfileTrace.
+  */
+  class TraceRegion
+  {
+    Timer & timer;
+    int tid;
+    bool threadtimer;
+    ProfileTrace::ThreadData * td;
+    double start = 0, flops = 0, bytes = 0;
+
+  public:
+    TraceRegion (Timer & atimer)
+      : timer(atimer), tid(TaskManager::GetThreadId()), threadtimer(false)
+    {
+      timer.Start();
+      Begin();
+    }
+
+    TraceRegion (Timer & atimer, int atid)
+      : timer(atimer), tid(atid), threadtimer(true)
+    {
+      NgProfiler::StartThreadTimer (timer, tid);
+      Begin();
+    }
+
+    ~TraceRegion ()
+    {
+      if (td)
+        ProfileTrace::Leave (*td, timer, start, flops, bytes);
+      if (threadtimer)
+        NgProfiler::StopThreadTimer (timer, tid);
+      else
+        timer.Stop();
+    }
+
+    void AddFlops (double aflops)
+    {
+      flops += aflops;
+      if (threadtimer)
+        NgProfiler::AddThreadFlops (timer, tid, aflops);
+      else
+        timer.AddFlops (aflops);
+    }
+
+    /// bytes loaded and stored, for the memory bandwidth
+    void AddBytes (double abytes) { bytes += abytes; }
+
+  private:
+    void Begin ()
+    {
+      td = ProfileTrace::Enter (tid);
+      if (td && td->sampled)
+        start = WallTime();
+    }
+  };
+
+}
+
+#endif
@@ -136,6 +136,60 @@ void NGS_DLL_HEADER  ExportNgstd(py::module & m) {
 	   }, "Returns list of timers"
 	   );
 
+  m.def("EnableProfileTrace", [](size_t sampling, size_t maxevents)
+        {
+          ProfileTrace::Enable (sampling, maxevents);
+        }, py::arg("sampling")=1, py::arg("maxevents")=1000000,
+        docu_string(R"raw_string(
+Starts recording nested timer regions per thread, previous recordings are cleared.
+
+Parameters:
+
+sampling : int
+  records only every sampling-th outermost region of a thread, 
+  with all regions inside
+
+maxevents : int
+  maximal number of recorded events per thread
+)raw_string"));
+
+  m.def("DisableProfileTrace", []() { ProfileTrace::Disable(); },
+        "Stops recording, recorded regions are kept");
+
+  m.def("ProfileReport", []()
+        {
+          stringstream str;
+          ProfileTrace::WriteJSON (str);
+          return py::module::import("json").attr("loads")(str.str());
+        }, docu_string(R"raw_string(
+Returns a dict with all timers (time, counts, flops, bytes, GFlop/s, GB/s
+and a per-thread breakdown) and the tree of recorded nested regions.
+)raw_string"));
+
+  m.def("WriteProfile", [](string filename, string format)
+        {
+          ofstream out(filename);
+          if (format == "json")
+            ProfileTrace::WriteJSON (out);
+          else if (format == "chrome")
+            ProfileTrace::WriteChromeTrace (out);
+          else
+            throw Exception ("WriteProfile: unknown format '" + format + "', use 'json' or 'chrome'");
+        }, py::arg("filename"), py::arg("format")="json",
+        docu_string(R"raw_string(
+Writes the profile to a file.
+
+Parameters:
+
+filename : string
+  output file
+
+format : string
+  'json' .. report as returned by ProfileReport,
+  'chrome' .. trace events of the recorded regions, for chrome://tracing
+  or ui.perfetto.dev
+)raw_string"));
+
   py::class_<Archive, shared_ptr<Archive>> (m, "Archive")
       /*
     .def("__init__", [](const string & filename, bool write,
@@ -56,9 +56,9 @@ namespace ngstd
 
 
 
-  void Socket::create()
+  void Socket::create (int domain)
   {
-    m_sock = socket (AF_INET, SOCK_STREAM, 0);
+    m_sock = socket (domain, SOCK_STREAM, 0);
     
     if (m_sock == -1)
       throw SocketException ("call to socket failed");
@@ -74,12 +74,12 @@ namespace ngstd
 
 
 
-  void Socket::bind (int port)
+  void Socket::bind (int port, bool localhost_only)
   {
     if ( !is_valid() ) throw SocketException ("not a valid socket");
 
     m_addr.sin_family = AF_INET;
-    m_addr.sin_addr.s_addr = INADDR_ANY;
+    m_addr.sin_addr.s_addr = localhost_only ? htonl (INADDR_LOOPBACK) : INADDR_ANY;
     m_addr.sin_port = htons ( port );
 
     int bind_return = ::bind ( m_sock,
@@ -91,6 +91,28 @@ namespace ngstd
   }
 
 
+  static sockaddr_un UnixAddress (const string & path)
+  {
+    sockaddr_un addr;
+    memset (&addr, 0, sizeof (addr));
+    addr.sun_family = AF_UNIX;
+    if (path.length() >= sizeof (addr.sun_path))
+      throw SocketException ("socket path too long: " + path);
+    strcpy (addr.sun_path, path.c_str());
+    return addr;
+  }
+
+  void Socket::bind (const string & path)
+  {
+    if ( !is_valid() ) throw SocketException ("not a valid socket");
+
+    sockaddr_un addr = UnixAddress (path);
+    ::unlink (path.c_str());
+    if (::bind (m_sock, (struct sockaddr *) &addr, sizeof (addr)) == -1)
+      throw SocketException (GetLatestError());
+  }
+
+
   void Socket::listen() const
   {
     if ( !is_valid() ) throw SocketException ("not a valid socket");
@@ -142,6 +164,41 @@ namespace ngstd
   }
 
 
+  void Socket::send_bytes (const void * data, size_t size) const
+  {
+    const char * ptr = static_cast<const char*> (data);
+    while (size > 0)
+      {
+        auto status = ::send (m_sock, ptr, size, MSG_NOSIGNAL);
+        if (status <= 0)
+          {
+            if (status < 0 && errno == EINTR) continue;
+            throw SocketException (GetLatestError());
+          }
+        ptr += status;
+        size -= status;
+      }
+  }
+
+  void Socket::recv_bytes (void * data, size_t size) const
+  {
+    char * ptr = static_cast<char*> (data);
+    while (size > 0)
+      {
+        auto status = ::recv (m_sock, ptr, size, MSG_WAITALL);
+        if (status == 0)
+          throw SocketException ("connection closed");
+        if (status < 0)
+          {
+            if (errno == EINTR) continue;
+            throw SocketException (GetLatestError());
+          }
+        ptr += status;
+        size -= status;
+      }
+  }
+
+
   void Socket::recv (string & s) const
   {
     // new version by Joachim
@@ -211,6 +268,27 @@ namespace ngstd
   }
 
 
+  void Socket::connect (const string & path)
+  {
+    if (!is_valid()) throw SocketException ("not a valid socket");
+
+    sockaddr_un addr = UnixAddress (path);
+    if (::connect (m_sock, (sockaddr *) &addr, sizeof (addr)) != 0)
+      throw SocketException (GetLatestError());
+  }
+
+
+  void Socket::shutdown () const
+  {
+    if (is_valid())
+#ifdef WIN32
+      ::shutdown (m_sock, SD_BOTH);
+#else
+      ::shutdown (m_sock, SHUT_RDWR);
+#endif
+  }
+
+
   void Socket::set_non_blocking ( const bool b )
   {
 #ifdef WIN32
@@ -337,12 +415,12 @@ namespace ngstd
   }
 
 
-  ServerSocket::ServerSocket (int port)
+  ServerSocket::ServerSocket (int port, bool localhost_only)
   {
     try
       {
         Socket::create();
-        Socket::bind (port);
+        Socket::bind (port, localhost_only);
         Socket::listen();
       }
     catch (SocketException e)
@@ -352,6 +430,21 @@ namespace ngstd
       }
   }
 
+  ServerSocket::ServerSocket (const string & path)
+  {
+    try
+      {
+        Socket::create (AF_UNIX);
+        Socket::bind (path);
+        Socket::listen();
+      }
+    catch (SocketException e)
+      {
+        e.Append ("\nduring unix socket creation at " + path);
+        throw e;
+      }
+  }
+
   const ServerSocket& ServerSocket::operator << ( const std::string& s ) const
   {
     Socket::send (s);
@@ -391,6 +484,20 @@ namespace ngstd
       }
   }
 
+  ClientSocket::ClientSocket (const string & path)
+  {
+    try
+      {
+        Socket::create (AF_UNIX);
+        Socket::connect (path);
+      }
+    catch (SocketException e)
+      {
+        e.Append ("\nduring connecting to unix socket " + path);
+        throw e;
+      }
+  }
+
 
   const ClientSocket& ClientSocket::operator << ( const std::string& s ) const
   {
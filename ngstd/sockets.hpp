@@ -25,6 +25,7 @@
 #else
 
 #include <sys/socket.h>
+#include <sys/un.h>
 #include <netinet/in.h>
 #include <netdb.h>
 #include <unistd.h>
@@ -78,13 +79,20 @@ namespace ngstd
     virtual ~Socket();
 
     // Server initialization
-    void create();
-    void bind (int port);
+    void create (int domain = AF_INET);
+    void bind (int port, bool localhost_only = false);
+#ifndef WIN32
+    /// unix domain socket, an existing file at path is removed
+    void bind (const string & path);
+#endif
     void listen() const;
     bool accept ( Socket& ) const;
 
     // Client initialization
     void connect (const string & host, int port);
+#ifndef WIN32
+    void connect (const string & path);
+#endif
 
     // Data Transimission
     void send (const string & s) const;
@@ -95,6 +103,10 @@ namespace ngstd
 
     void recv (std::string & str) const;
 
+    /// sends/receives exactly size bytes
+    void send_bytes (const void * data, size_t size) const;
+    void recv_bytes (void * data, size_t size) const;
+
     template <typename T>
     void Tsend (const T & data) const
     {
@@ -116,6 +128,8 @@ namespace ngstd
 
 
     void set_non_blocking ( const bool );
+    /// stops communication, wakes up a blocking accept or recv
+    void shutdown () const;
 
     bool is_valid() const { return m_sock != -1; }
 
@@ -130,7 +144,10 @@ namespace ngstd
   class ServerSocket : public Socket
   {
   public:
-    ServerSocket (int port);
+    ServerSocket (int port, bool localhost_only = false);
+#ifndef WIN32
+    ServerSocket (const string & path);
+#endif
     ServerSocket () { ; };
     virtual ~ServerSocket() { ; }
 
@@ -147,6 +164,9 @@ namespace ngstd
 
   public:
     ClientSocket (int port, const string & host="localhost" );
+#ifndef WIN32
+    ClientSocket (const string & path);
+#endif
     virtual ~ClientSocket(){};
 
     const ClientSocket& operator << ( const std::string& ) const;
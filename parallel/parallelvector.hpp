@@ -69,6 +69,20 @@ namespace ngla
     virtual BaseVector & Add (double scal, const BaseVector & v);
     virtual BaseVector & Add (Complex scal, const BaseVector & v);
 
+    // fused kernels: local sweep and at most one reduction
+    virtual double AddNorm2 (double scal, const BaseVector & v);
+    virtual double AddNorm2 (Complex scal, const BaseVector & v);
+    virtual BaseVector & ScaleAdd (double scal, const BaseVector & v);
+    virtual BaseVector & ScaleAdd (Complex scal, const BaseVector & v);
+    virtual double ScaleAddNorm2 (double scal, const BaseVector & v);
+    virtual BaseVector & MultiAdd (FlatVector<double> scal, FlatArray<const BaseVector*> v);
+    virtual BaseVector & MultiAdd (FlatVector<Complex> scal, FlatArray<const BaseVector*> v);
+    virtual double InnerProductNorm2D (const BaseVector & v2, double & norm2) const;
+    virtual Complex InnerProductNorm2C (const BaseVector & v2, double & norm2, bool conjugate = false) const;
+    virtual void MultiInnerProductD (FlatArray<const BaseVector*> v, FlatVector<double> res) const;
+    virtual void MultiInnerProductC (FlatArray<const BaseVector*> v, FlatVector<Complex> res,
+                                     bool conjugate = false) const;
+
     void PrintStatus ( ostream & ost ) const;
 
     virtual shared_ptr<BaseVector> GetLocalVector () const
@@ -99,6 +113,20 @@ namespace ngla
       cerr << "ERROR -- SetParallelDofs called for BaseVector, is not parallel" << endl; 
     }
     */
+
+  protected:
+    /// cumulates this or v, such that both have the same status
+    void AlignStatus (const ParallelBaseVector & v) const;
+    /// cumulates this or the v[i], such that all have the same status
+    void AlignStatus (FlatArray<const BaseVector*> v) const;
+    /// distributes the v[i] for inner products with the cumulated this
+    void PrepareInnerProducts (FlatArray<const BaseVector*> v) const;
+    /// squared norm from the squared norm of the local values
+    double GlobalNorm2 (double localnorm2) const;
+    /// local squared norm of the values of non-master dofs
+    double NonMasterNorm2 () const;
+    /// sums over all processes
+    void AllReduceSum (FlatVector<double> values) const;
   };
 
 
@@ -95,6 +95,180 @@ namespace ngla
   }
 
 
+
+  void ParallelBaseVector :: AlignStatus (const ParallelBaseVector & v) const
+  {
+    if (Status() != v.Status())
+      {
+        if (Status() == DISTRIBUTED)
+          Cumulate();
+        else
+          v.Cumulate();
+      }
+  }
+
+  void ParallelBaseVector :: AlignStatus (FlatArray<const BaseVector*> v) const
+  {
+    if (Status() == DISTRIBUTED)
+      for (auto vi : v)
+        if (dynamic_cast_ParallelBaseVector(*vi).Status() != DISTRIBUTED)
+          {
+            Cumulate();
+            break;
+          }
+    for (auto vi : v)
+      AlignStatus (dynamic_cast_ParallelBaseVector(*vi));
+  }
+
+  void ParallelBaseVector :: PrepareInnerProducts (FlatArray<const BaseVector*> v) const
+  {
+    Cumulate();
+    for (auto vi : v)
+      {
+        auto & parv = dynamic_cast_ParallelBaseVector(*vi);
+        if (parv.Status() == CUMULATED)
+          parv.Distribute();
+      }
+  }
+
+  double ParallelBaseVector :: NonMasterNorm2 () const
+  {
+    size_t ndof = paralleldofs->GetNDofLocal();
+    FlatMatrix<double> fv (ndof, EntrySize(), (double*)Memory());
+    double sum = 0;
+    for (size_t dof = 0; dof < ndof; dof++)
+      if (!paralleldofs->IsMasterDof (dof))
+        sum += L2Norm2 (fv.Row(dof));
+    return sum;
+  }
+
+  double ParallelBaseVector :: GlobalNorm2 (double localnorm2) const
+  {
+    switch (Status())
+      {
+      case NOT_PARALLEL:
+        return localnorm2;
+      case CUMULATED:
+        return paralleldofs->GetCommunicator().AllReduce (localnorm2-NonMasterNorm2(), MPI_SUM);
+      default:
+        return sqr (L2Norm());
+      }
+  }
+
+  void ParallelBaseVector :: AllReduceSum (FlatVector<double> values) const
+  {
+#ifdef PARALLEL
+    MPI_Allreduce (MPI_IN_PLACE, values.Data(), values.Size(), MPI_DOUBLE, MPI_SUM,
+                   paralleldofs->GetCommunicator());
+#endif
+  }
+
+
+  double ParallelBaseVector :: AddNorm2 (double scal, const BaseVector & v)
+  {
+    AlignStatus (dynamic_cast_ParallelBaseVector (v));
+    return GlobalNorm2 (BaseVector::AddNorm2 (scal, v));
+  }
+
+  double ParallelBaseVector :: AddNorm2 (Complex scal, const BaseVector & v)
+  {
+    AlignStatus (dynamic_cast_ParallelBaseVector (v));
+    return GlobalNorm2 (BaseVector::AddNorm2 (scal, v));
+  }
+
+  BaseVector & ParallelBaseVector :: ScaleAdd (double scal, const BaseVector & v)
+  {
+    AlignStatus (dynamic_cast_ParallelBaseVector (v));
+    return BaseVector::ScaleAdd (scal, v);
+  }
+
+  BaseVector & ParallelBaseVector :: ScaleAdd (Complex scal, const BaseVector & v)
+  {
+    AlignStatus (dynamic_cast_ParallelBaseVector (v));
+    return BaseVector::ScaleAdd (scal, v);
+  }
+
+  double ParallelBaseVector :: ScaleAddNorm2 (double scal, const BaseVector & v)
+  {
+    AlignStatus (dynamic_cast_ParallelBaseVector (v));
+    return GlobalNorm2 (BaseVector::ScaleAddNorm2 (scal, v));
+  }
+
+  BaseVector & ParallelBaseVector :: MultiAdd (FlatVector<double> scal, FlatArray<const BaseVector*> v)
+  {
+    AlignStatus (v);
+    return BaseVector::MultiAdd (scal, v);
+  }
+
+  BaseVector & ParallelBaseVector :: MultiAdd (FlatVector<Complex> scal, FlatArray<const BaseVector*> v)
+  {
+    AlignStatus (v);
+    return BaseVector::MultiAdd (scal, v);
+  }
+
+  double ParallelBaseVector :: InnerProductNorm2D (const BaseVector & v2, double & norm2) const
+  {
+    if (Status() == NOT_PARALLEL)
+      return BaseVector::InnerProductNorm2D (v2, norm2);
+
+    // the norm needs the cumulated this, the inner product a distributed v2
+    const BaseVector * pv2 = &v2;
+    PrepareInnerProducts (FlatArray<const BaseVector*> (1, &pv2));
+
+    Vec<2> sums;
+    sums(0) = BaseVector::InnerProductNorm2D (v2, sums(1));
+    sums(1) -= NonMasterNorm2();
+    AllReduceSum (sums);
+    norm2 = sums(1);
+    return sums(0);
+  }
+
+  Complex ParallelBaseVector :: InnerProductNorm2C (const BaseVector & v2, double & norm2, bool conjugate) const
+  {
+    if (Status() == NOT_PARALLEL)
+      return BaseVector::InnerProductNorm2C (v2, norm2, conjugate);
+
+    const BaseVector * pv2 = &v2;
+    PrepareInnerProducts (FlatArray<const BaseVector*> (1, &pv2));
+
+    Vec<3> sums;
+    Complex ip = BaseVector::InnerProductNorm2C (v2, sums(2), conjugate);
+    sums(0) = ip.real();
+    sums(1) = ip.imag();
+    sums(2) -= NonMasterNorm2();
+    AllReduceSum (sums);
+    norm2 = sums(2);
+    return Complex (sums(0), sums(1));
+  }
+
+  void ParallelBaseVector :: MultiInnerProductD (FlatArray<const BaseVector*> v, FlatVector<double> res) const
+  {
+    if (Status() == NOT_PARALLEL)
+      {
+        BaseVector::MultiInnerProductD (v, res);
+        return;
+      }
+
+    PrepareInnerProducts (v);
+    BaseVector::MultiInnerProductD (v, res);
+    AllReduceSum (res);
+  }
+
+  void ParallelBaseVector :: MultiInnerProductC (FlatArray<const BaseVector*> v, FlatVector<Complex> res,
+                                                 bool conjugate) const
+  {
+    if (Status() == NOT_PARALLEL)
+      {
+        BaseVector::MultiInnerProductC (v, res, conjugate);
+        return;
+      }
+
+    PrepareInnerProducts (v);
+    BaseVector::MultiInnerProductC (v, res, conjugate);
+    AllReduceSum (FlatVector<double> (2*res.Size(), (double*)res.Data()));
+  }
+
+
   void ParallelBaseVector :: PrintStatus ( ostream & ost ) const
   {
     if ( this->status == NOT_PARALLEL )
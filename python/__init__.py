@@ -15,10 +15,11 @@ from .ngslib import __version__, ngstd, bla, la, fem, comp, solve
 from netgen import Redraw
 
 from pyngcore import BitArray, TaskManager, SetNumThreads
-from .ngstd import Timers, Timer, IntRange
+from .ngstd import Timers, Timer, IntRange, EnableProfileTrace, \
+    DisableProfileTrace, ProfileReport, WriteProfile
 from .bla import Matrix, Vector, InnerProduct, Norm
 from .la import BaseMatrix, BaseVector, BlockVector, BlockMatrix, \
-    CreateVVector, CGSolver, QMRSolver, GMRESSolver, ArnoldiSolver, \
+    CreateVVector, CGSolver, QMRSolver, GMRESSolver, BiCGStabSolver, ArnoldiSolver, \
     Projector, IdentityMatrix, Embedding, PermutationMatrix, \
     ConstEBEMatrix, ParallelMatrix, PARALLEL_STATUS
 from .fem import BFI, LFI, CoefficientFunction, Parameter, ET, \
@@ -26,7 +27,7 @@ from .fem import BFI, LFI, CoefficientFunction, Parameter, ET, \
     VERTEX, FACET, ELEMENT, sin, cos, tan, atan, acos, asin, sinh, cosh, \
     exp, log, sqrt, floor, ceil, Conj, atan2, pow, Sym, Skew, Id, Trace, Inv, Det, Cof, Cross, \
     specialcf, BlockBFI, BlockLFI, CompoundBFI, CompoundLFI, BSpline, \
-    IntegrationRule, IfPos, VoxelCoefficient
+    IntegrationRule, IfPos, VoxelCoefficient, LoadVoxelCoefficient
 from .comp import VOL, BND, BBND, BBBND, COUPLING_TYPE, ElementId, \
     BilinearForm, LinearForm, GridFunction, Preconditioner, \
     MultiGridPreconditioner, ElementId, FESpace, H1, HCurl, \
@@ -35,9 +36,9 @@ from .comp import VOL, BND, BBND, BBBND, COUPLING_TYPE, ElementId, \
     NormalFacetFESpace, \
     FacetSurface, VectorSurfaceL2, VectorFacetFESpace, VectorFacetSurface, \
     NodalFESpace, VectorNodalFESpace, \
-    NumberSpace, Periodic, Discontinuous, Compress, \
+    NumberSpace, Periodic, Discontinuous, Compress, Reorder, \
     CompressCompound, BoundaryFromVolumeCF, Variation, \
-    NumProc, PDE, Integrate, Region, SymbolicLFI, SymbolicBFI, \
+    NumProc, PDE, Integrate, IntegrateMany, Region, SymbolicLFI, SymbolicBFI, \
     SymbolicEnergy, Mesh, NodeId, ORDER_POLICY, VTKOutput, SetHeapSize, \
     SetTestoutFile, ngsglobals, pml, MPI_Init, ContactBoundary, PatchwiseSolve
 from .solve import BVP, CalcFlux, Draw, DrawFlux, \
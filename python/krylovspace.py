@@ -1,12 +1,19 @@
 
 from ngsolve import Projector, Norm, TimeFunction, BaseMatrix, Preconditioner, InnerProduct, \
     Norm, sqrt, Vector, Matrix, BaseVector, BitArray
+from ngsolve import la
 from typing import Optional, Callable
 import logging
 from netgen.libngpy._meshing import _PushStatus, _GetStatus, _SetThreadPercentage
 from math import log
 
 class CGSolver(BaseMatrix):
+    """Preconditioned conjugate gradient solver.
+
+The iteration runs in the C++ CGSolver, which keeps its work vectors
+between solves and releases the GIL. Only with a callback or an absolute
+tolerance abstol it runs in Python.
+"""
     def __init__(self, mat : BaseMatrix, pre : Optional[Preconditioner] = None,
                  freedofs : Optional[BitArray] = None,
                  conjugate : bool = False, tol : float = 1e-12, maxsteps : int = 100,
@@ -33,6 +40,11 @@ class CGSolver(BaseMatrix):
         self.errors = []
         self.iterations = 0
 
+        self._solver = None
+        if callback is None and abstol is None:
+            self._solver = la.CGSolver(mat, self.pre, conjugate=conjugate, printrates=False,
+                                       precision=tol, maxsteps=maxsteps)
+
     def __del__(self):
         if self.printing:
             self.logger.removeHandler(self.handler)
@@ -56,10 +68,19 @@ class CGSolver(BaseMatrix):
     @TimeFunction
     def Solve(self, rhs : BaseVector, sol : Optional[BaseVector] = None,
               initialize : bool = True) -> None:
+        self.sol = sol if sol is not None else self.mat.CreateRowVector()
+        if self._solver is not None:
+            self._solver.Solve(rhs, self.sol, initialize)
+            self.errors = self._solver.errors
+            self.iterations = self._solver.iterations
+            for it, err in enumerate(self.errors[1:]):
+                self.logger.info("iteration " + str(it) + " error = " + str(err))
+            if self.errors and self.errors[-1] > self.tol * self.errors[0]:
+                self.logger.warning("CG did not converge to tol")
+            return
         old_status = _GetStatus()
         _PushStatus("CG Solve")
         _SetThreadPercentage(0)
-        self.sol = sol if sol is not None else self.mat.CreateRowVector()
         d, w, s = self._tmp_vecs
         u, mat, pre, conjugate, tol, maxsteps, callback = self.sol, self.mat, self.pre, self.conjugate, \
             self.tol, self.maxsteps, self.callback
@@ -0,0 +1,96 @@
+"""
+Client for the ngsolve.comp.SolveServer.
+
+Strings are sent as int32 length, the characters and a terminating 0,
+sizes as int64 and vectors as float64, all in native byte order.
+"""
+
+import socket
+import struct
+import numpy as np
+
+class SolveClient():
+    """
+Connects to a SolveServer.
+
+Parameters
+----------
+
+address (str or int): path of the unix domain socket, or TCP port on localhost
+"""
+    def __init__(self, address):
+        if isinstance(address, int):
+            self.sock = socket.create_connection(("127.0.0.1", address))
+        else:
+            self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+            self.sock.connect(address)
+
+    def close(self):
+        self.sock.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def _send(self, s):
+        data = s.encode()
+        self.sock.sendall(struct.pack("i", len(data)) + data + b"\0")
+
+    def _recvall(self, n):
+        buf = bytearray(n)
+        view = memoryview(buf)
+        while n:
+            k = self.sock.recv_into(view, n)
+            if k == 0:
+                raise ConnectionError("SolveServer closed the connection")
+            view = view[k:]
+            n -= k
+        return bytes(buf)
+
+    def _recv(self):
+        n, = struct.unpack("i", self._recvall(4))
+        return self._recvall(n+1)[:-1].decode()
+
+    def _check(self):
+        msg = self._recv()
+        if msg != "ok":
+            raise Exception(msg)
+
+    def Systems(self):
+        """ returns dict of the systems with their number of dofs """
+        self._send("list")
+        self._check()
+        return { name : int(ndof) for name, ndof in
+                 (line.split() for line in self._recv().splitlines()) }
+
+    def Solve(self, name, f):
+        """
+Solves system 'name' for the right hand side f, a vector or an array
+with one right hand side per row. Returns a numpy array of the same
+shape.
+"""
+        f = np.ascontiguousarray(f, dtype=np.float64)
+        rhs = f.reshape(1,-1) if f.ndim == 1 else f
+        self._send("solve")
+        self._send(name)
+        self.sock.sendall(struct.pack("qq", rhs.shape[0], rhs.shape[1]) + rhs.tobytes())
+        self._check()
+        u = np.frombuffer(self._recvall(rhs.nbytes), dtype=np.float64)
+        return u.reshape(f.shape)
+
+    def SetParameter(self, name, value):
+        """ sets the Parameter 'name', systems are re-assembled at their next solve """
+        self._send("set")
+        self._send(name)
+        self.sock.sendall(struct.pack("d", value))
+        self._check()
+
+    def Shutdown(self):
+        """ stops the server """
+        self._send("shutdown")
+        self._check()
+
+
+__all__ = ["SolveClient"]
@@ -22,7 +22,7 @@ name (str): Name for the timed class (for output formatting and
     saving/loading of results)
 obj (NGSolve object): Some NGSolve class which has the __timing__ 
     functionality implemented. Currently supported classes:
-        FESpace
+        FESpace, FiniteElement, BilinearForm, Preconditioner
 filename (str): Filename to load a previously saved Timing
 parallel (bool=True): Time in parallel (using TaskManager)
 serial (bool=True): Time not in parallel (not using TaskManager)
@@ -493,6 +493,21 @@ int NGS_LoadPDE (ClientData clientData,
               MyRunParallel (SocketThread, hport);
 #endif
             }
+
+#ifndef WIN32
+          // keeps the assembled forms and their inverses for clients
+          int serverport = pde -> GetConstant ("solveserver_port", true);
+          if (serverport)
+            {
+              auto server = make_shared<SolveServer>();
+              auto & bfs = pde -> GetBilinearFormTable();
+              for (size_t i = 0; i < bfs.Size(); i++)
+                if (!bfs[i]->GetFESpace()->IsComplex())
+                  server -> AddSystem (bfs.GetName(i), bfs[i]);
+              cout << "NGSolve solve-server on port " << serverport << endl;
+              std::thread ([server, serverport] () { server -> Serve (serverport); }).detach();
+            }
+#endif
 	}
       catch (ngstd::Exception & e)
 	{
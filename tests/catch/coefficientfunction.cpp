@@ -278,3 +278,27 @@ TEST_OPERATOR_COEFFICIENTFUNCTION(mat*xyz);
 
 auto longvec = MakeVectorialCoefficientFunction({x,y,z,x,y,z,z,x,y,x,x,x});
 // TEST_OPERATOR_COEFFICIENTFUNCTION(InnerProduct(longvec, longvec));
+
+TEST_CASE ("EvalFunction SIMD")
+{
+  LocalHeap lh(100000, "lh");
+  IntegrationRule ir(ET_TET, 3);
+  FE_ElementTransformation<3,3> trafo(ET_TET);
+  MappedIntegrationRule<3,3> mir(ir, trafo, lh);
+  SIMD_IntegrationRule simd_ir(ET_TET, 3);
+  SIMD_MappedIntegrationRule<3,3> simd_mir(simd_ir, trafo, lh);
+
+  for (string expr : { "sin(x)*y + (x > 0.3)*z - 2/(1+exp(z))", "sqrt(x*x+y*y) + abs(y-z) + step(x-y)",
+                       "atan2(y,x+1) + (x<y and y<=z) - sign(z-0.5)" })
+    {
+      DomainVariableCoefficientFunction cf(EvalFunction{expr});
+      CHECK(cf.GetEvalFunction(0).IsVectorizable());
+      Matrix<> vals(ir.Size(), 1);
+      cf.Evaluate (mir, vals);
+      Matrix<SIMD<double>> simd_vals(1, simd_ir.Size());
+      cf.Evaluate (simd_mir, simd_vals);
+      SliceMatrix<> simd_vals_ref(1, simd_ir.GetNIP(), SIMD<double>::Size()*simd_ir.Size(),
+                                  &simd_vals(0)[0]);
+      CHECK(L2Norm(vals-Trans(simd_vals_ref)) < tolerance);
+    }
+}
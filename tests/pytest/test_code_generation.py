@@ -81,8 +81,139 @@ def test_code_generation_derivatives(unit_mesh_3d):
         vals -= vals_ref
         assert Norm(vals) == approx(0)
 
+def compiled_steps(cf):
+    # first line of the report: "Compiled CF, <nodes> nodes in <steps> steps:"
+    words = str(cf).split()
+    return int(words[2]), int(words[5])
+
+def test_code_generation_optimization(unit_mesh_3d):
+    # structurally equal subtrees, built separately
+    a = sin(x+y) * (x+y)
+    b = sin(x+y) * (x+y)
+    shared = a + a
+    separate = a + b
+    assert compiled_steps(separate.Compile())[1] == compiled_steps(shared.Compile())[1]
+
+    # constant subexpressions and zero components
+    cf = separate + CoefficientFunction(2)*CoefficientFunction(3)*x + CoefficientFunction((x,0,z))[1]*y
+    for f in [cf.Compile(), cf.Compile(True, wait=True)]:
+        nodes, steps = compiled_steps(f)
+        assert steps < nodes
+        assert Integrate( (cf-f)*(cf-f), unit_mesh_3d) == approx(0)
+
+    zero = CoefficientFunction((x,0,z))[1]*y
+    assert compiled_steps(zero.Compile())[1] == 1
+    assert Integrate( zero.Compile(True, wait=True), unit_mesh_3d) == approx(0)
+
+def test_code_generation_temporaries(unit_mesh_3d):
+    cf = CoefficientFunction((x,y,z))
+    for i in range(10):
+        cf = CoefficientFunction((sin(cf[1]), cf[2]+x, cf[0]*y))
+    cf = InnerProduct(cf, cf)
+    f = cf.Compile()
+    # "temporaries: <tempdim> values per point, <totdim> without reuse"
+    line = [l for l in str(f).splitlines() if l.startswith("temporaries")][0].split()
+    assert int(line[1]) < int(line[5])
+    assert Integrate( (cf-f)*(cf-f), unit_mesh_3d) == approx(0)
+
+def test_code_generation_element_matrix(unit_mesh_3d):
+    fes = VectorH1(unit_mesh_3d, order=2) * H1(unit_mesh_3d, order=1)
+    (u,p), (v,q) = fes.TnT()
+    eps = lambda w: 0.5*(grad(w)+grad(w).trans)
+    mats = []
+    for compile in [False, True]:
+        a = BilinearForm(fes)
+        a += (InnerProduct(eps(u),eps(v)) + (1+x)*u*v + div(u)*q + div(v)*p + grad(p)*grad(q)) * dx
+        if compile:
+            for bfi in a.integrators:
+                bfi.Compile(wait=True)
+                assert bfi.compiled
+        a.Assemble()
+        mats.append(a.mat)
+    diff = mats[0].CreateVector()
+    rand = mats[0].CreateVector()
+    rand.SetRandom()
+    diff.data = mats[0]*rand - mats[1]*rand
+    assert Norm(diff) < 1e-10 * Norm(rand)
+
+def test_code_generation_element_matrix_nonsymmetric(unit_mesh_2d):
+    fes = H1(unit_mesh_2d, order=3)
+    u,v = fes.TnT()
+    A = CoefficientFunction((2, 1+x, -1, 3), dims=(2,2))
+    b = CoefficientFunction((1, 2*y))
+    forms = [ (A*grad(u))*grad(v) + u*v,
+              # a symmetric pair after non-symmetric ones in the same block
+              grad(u)*b*v + u*b*grad(v) + u*v ]
+    for form in forms:
+        mats = []
+        for compile in [False, True]:
+            a = BilinearForm(fes)
+            a += form * dx
+            if compile:
+                for bfi in a.integrators:
+                    bfi.Compile(wait=True)
+                    assert bfi.compiled
+            a.Assemble()
+            mats.append(a.mat)
+        rand = mats[0].CreateVector()
+        rand.SetRandom()
+        for trans in [False, True]:
+            diff = mats[0].CreateVector()
+            if trans:
+                diff.data = mats[0].T*rand - mats[1].T*rand
+            else:
+                diff.data = mats[0]*rand - mats[1]*rand
+            assert Norm(diff) < 1e-10 * Norm(rand)
+
+def test_code_generation_element_matrix_recompile(unit_mesh_2d):
+    fes = H1(unit_mesh_2d, order=3)
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += ((1+x*y)*grad(u)*grad(v) + u*v) * dx
+    a.Assemble()
+    rand = a.mat.CreateVector()
+    rand.SetRandom()
+    ref = a.mat.CreateVector()
+    ref.data = a.mat*rand
+    diff = a.mat.CreateVector()
+    bfi = a.integrators[0]
+    # kernels are replaced while assembling, old ones must stay loaded while in use
+    for i in range(3):
+        bfi.Compile(wait=False)
+        for j in range(5):
+            a.Assemble()
+            diff.data = a.mat*rand - ref
+            assert Norm(diff) < 1e-10 * Norm(ref)
+    bfi.Compile(wait=True)
+    assert bfi.compiled
+    a.Assemble()
+    diff.data = a.mat*rand - ref
+    assert Norm(diff) < 1e-10 * Norm(ref)
+
+def test_code_generation_gridfunction(unit_mesh_2d):
+    fes = H1(unit_mesh_2d, order=3)
+    u,v = fes.TnT()
+    gf = GridFunction(fes)
+    gf.Set(x*x*y+y)
+    # value, gradient and hessian share one element vector per element
+    coef = CoefficientFunction((1+gf*gf, grad(gf)[0], grad(gf)[1], 2+gf.Operator("hesse")[0]), dims=(2,2))
+    wx = GridFunction(fes)
+    wx.Set(x)
+    for cf in [coef, coef.Compile(), coef.Compile(True, wait=True)]:
+        a = BilinearForm(fes)
+        a += cf*grad(u)*grad(v)*dx
+        a.Assemble()
+        # grad(x) = (1,0) picks the (0,0) entry
+        assert InnerProduct(a.mat*wx.vec, wx.vec) == approx(Integrate(coef[0,0], unit_mesh_2d))
+
 if __name__ == "__main__":
     test_code_generation_derivatives()
     test_code_generation_volume_terms()
     test_code_generation_volume_terms_complex()
     test_code_generation_boundary_terms()
+    test_code_generation_optimization()
+    test_code_generation_temporaries()
+    test_code_generation_element_matrix()
+    test_code_generation_element_matrix_nonsymmetric()
+    test_code_generation_element_matrix_recompile()
+    test_code_generation_gridfunction()
@@ -57,6 +57,34 @@ def test_domainwise_cf(domain2_mesh_2d):
     error_true = Integrate((c-c_true)*(c-c_true), domain2_mesh_2d)
     assert error_true == approx(0)
 
+def test_elementwise_constant_integrator(domain2_mesh_2d):
+    mesh = domain2_mesh_2d
+    fes = VectorH1(mesh, order=2)
+    u, v = fes.TnT()
+    mu = CoefficientFunction([2, 5])
+    lam = CoefficientFunction(3)
+    eps = lambda w: 0.5*(grad(w)+grad(w).trans)
+    # a zero gridfunction gives the same values, but is not constant per element
+    gfzero = GridFunction(H1(mesh, order=1))
+    def Assemble(c, simd=True, compiled=False):
+        a = BilinearForm(fes)
+        a += (2*(mu+c)*InnerProduct(eps(u),eps(v)) + (lam+c)*div(u)*div(v)) * dx
+        a += (mu+c)*u*v * dx
+        for bfi in a.integrators:
+            bfi.simd_evaluate = simd
+            if compiled:
+                bfi.Compile(wait=True)
+        a.Assemble()
+        return a.mat
+    ref = Assemble(gfzero)
+    vec = ref.CreateVector()
+    vec.SetRandom()
+    diff = ref.CreateVector()
+    for simd, compiled in [(True, False), (False, False), (True, True)]:
+        mat = Assemble(0, simd=simd, compiled=compiled)
+        diff.data = mat*vec - ref*vec
+        assert Norm(diff) < 1e-10 * Norm(vec)
+
 def test_evaluate(unit_mesh_2d):
     import numpy as np
     pnts = np.linspace(0.1,0.9,9)
@@ -69,6 +97,67 @@ def test_evaluate(unit_mesh_2d):
     assert vals2 == approx(np.array(list(zip([0.5 + 0J] * 10, pnts*1J))))
     assert x(unit_mesh_2d(0.5,0.5)) == approx(0.5)
 
+def test_voxel_cf(unit_mesh_3d, tmp_path):
+    import numpy as np
+    n = 11
+    xs = np.linspace(0,1,n)
+    # z slowest, x fastest
+    Z,Y,X = np.meshgrid(xs,xs,xs, indexing="ij")
+    vals = X + 2*Y + 3*Z
+    exact = x + 2*y + 3*z
+    vox = VoxelCoefficient((0,0,0), (1,1,1), vals, linear=True)
+    assert Integrate((vox-exact)**2, unit_mesh_3d) == approx(0)
+
+    # uint8 storage with scaling
+    stored = np.round(vals*40).astype(np.uint8)
+    vox8 = VoxelCoefficient((0,0,0), (1,1,1), stored, linear=True, scale=1/40)
+    assert Integrate((vox8-exact)**2, unit_mesh_3d) == approx(0)
+
+    filename = str(tmp_path / "voxels.raw")
+    stored.astype(np.uint16).tofile(filename)
+    voxf = LoadVoxelCoefficient(filename, (0,0,0), (1,1,1), stored.shape, dtype="uint16", scale=1/40)
+    assert Integrate((voxf-exact)**2, unit_mesh_3d) == approx(0)
+    mips = unit_mesh_3d(xs[1:-1],0.5,0.25)
+    assert voxf(mips).flatten() == approx(vox(mips).flatten())
+
+    # scale and shift apply to float64 values as well
+    vals.tofile(filename)
+    voxd = LoadVoxelCoefficient(filename, (0,0,0), (1,1,1), vals.shape, scale=2, shift=1)
+    assert Integrate((voxd-(1+2*exact))**2, unit_mesh_3d) == approx(0)
+    voxs = VoxelCoefficient((0,0,0), (1,1,1), vals, linear=True, scale=2, shift=1)
+    assert Integrate((voxs-(1+2*exact))**2, unit_mesh_3d) == approx(0)
+
+    near = VoxelCoefficient((0,0,0), (1,1,1), vals, linear=False)
+    assert near(unit_mesh_3d(0.52,0.5,0.5)) == approx(vals[5,5,5])
+
+def test_bspline(unit_mesh_2d):
+    sp = BSpline(2, [0,0,1,2,3,4,5,6,6], [1,0,0,0,0,0,0,0,0])
+    assert sp(0.25) == approx(0.75)
+    assert sp(2) == approx(0) and sp(-1) == 0 and sp(7) == 0
+
+    # nonuniform knots, as for B-H curves
+    knots = [0,0,0,0,0.1,0.15,0.3,0.7,1.2,2,2,2,2]
+    sp = BSpline(4, knots, [0,0.1,0.5,0.8,1,1.5,2,3,4,4,4,4,4])
+    dsp = sp.Differentiate()
+    h = 1e-6
+    for t in [0.01, 0.12, 0.5, 0.69, 1.9]:
+        assert dsp(t) == approx((sp(t+h)-sp(t-h))/(2*h), rel=1e-5)
+
+    # SIMD and derivatives of the CF
+    cf = sp(2*x)
+    mesh = unit_mesh_2d
+    mips = [mesh(xi, 0.5) for xi in [0.01, 0.2, 0.33, 0.7, 0.99]]
+    for mip in mips:
+        xi = mip.pnt[0]
+        assert cf(mip) == approx(sp(2*xi))
+        assert cf.Diff(x)(mip) == approx(2*dsp(2*xi))
+    fes = H1(mesh, order=2)
+    gfu = GridFunction(fes)
+    gfu.Set(x)
+    assert Integrate(sp(2*gfu), mesh) == approx(Integrate(cf, mesh))
+    f = sp(1.5*x)
+    assert Integrate(f*f.Diff(x), mesh, order=10) == approx(0.5*sp(1.5)**2, rel=1e-3)
+
 if __name__ == "__main__":
     test_pow()
     test_ParameterCF()
@@ -76,3 +165,4 @@ if __name__ == "__main__":
     test_real()
     test_domainwise_cf()
     test_evaluate()
+    test_bspline()
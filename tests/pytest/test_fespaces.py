@@ -99,9 +99,165 @@ def test_SurfaceGetFE(quads=False):
                         assert space.GetFE(el).ndof == len(space.GetDofNrs(el)), [spacename,vb,order]
     return
 
+def test_reorder():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.1))
+    fes = H1(mesh, order=3, dirichlet=".*")
+    u,v = fes.TnT()
+    f = LinearForm(fes)
+    f += v*dx
+    f.Assemble()
+    gfu = GridFunction(fes)
+    a = BilinearForm(fes)
+    a += grad(u)*grad(v)*dx
+    a.Assemble()
+    gfu.vec.data = a.mat.Inverse(fes.FreeDofs()) * f.vec
+    ref = Integrate(gfu, mesh)
+
+    for method in ["nodes", "rcm", "hilbert", "morton"]:
+        refes = Reorder(fes, method=method)
+        if method == "rcm":
+            assert refes.bandwidth[1] < refes.bandwidth[0]
+        u,v = refes.TnT()
+        f = LinearForm(refes)
+        f += v*dx
+        f.Assemble()
+        a = BilinearForm(refes)
+        a += grad(u)*grad(v)*dx
+        a.Assemble()
+        gfu = GridFunction(refes)
+        gfu.vec.data = a.mat.Inverse(refes.FreeDofs()) * f.vec
+        assert abs(Integrate(gfu, mesh) - ref) < 1e-10
+
+    # element order changes the traversal, not the matrix
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += grad(u)*grad(v)*dx
+    a.Assemble()
+    gfu = GridFunction(fes)
+    gfu.Set(x*y)
+    for element_order in ["rcm", "hilbert"]:
+        fes2 = H1(mesh, order=3, dirichlet=".*", element_order=element_order)
+        u,v = fes2.TnT()
+        a2 = BilinearForm(fes2)
+        a2 += grad(u)*grad(v)*dx
+        a2.Assemble()
+        w = gfu.vec.CreateVector()
+        w.data = a2.mat * gfu.vec - a.mat * gfu.vec
+        assert Norm(w) < 1e-10
+
+def test_cache_element_dofs():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    for cache in [False, True]:
+        fes = H1(mesh, order=3, dirichlet="left", cache_element_dofs=cache)
+        u,v = fes.TnT()
+        a = BilinearForm(fes)
+        a += grad(u)*grad(v)*dx + u*v*ds
+        a.Assemble()
+        f = LinearForm(fes)
+        f += v*dx
+        f.Assemble()
+        gfu = GridFunction(fes)
+        gfu.vec.data = a.mat.Inverse(fes.FreeDofs()) * f.vec
+        if cache:
+            assert abs(Integrate(gfu, mesh) - ref) < 1e-12
+        else:
+            ref = Integrate(gfu, mesh)
+
+def test_cache_element_dofs_condense():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    vals = []
+    for cache in [False, True]:
+        fes = H1(mesh, order=4, cache_element_dofs=cache)
+        u,v = fes.TnT()
+        gfu = GridFunction(fes)
+        gfu.Set(x*x*y)
+        a = BilinearForm(fes, condense=True)
+        a += grad(u)*grad(v)*dx + u*v*dx
+        # condensation must not modify the cached element dofs
+        for i in range(2):
+            a.Assemble()
+            vals.append(InnerProduct(a.mat*gfu.vec, gfu.vec))
+        b = BilinearForm(fes)
+        b += u*v*dx
+        b.Assemble()
+        vals.append(InnerProduct(b.mat*gfu.vec, gfu.vec))
+        vals.append(Integrate(gfu*gfu, mesh))
+    n = len(vals)//2
+    for v0, v1 in zip(vals[:n], vals[n:]):
+        assert abs(v0-v1) < 1e-10 * abs(v0)
+    assert abs(vals[2]-vals[3]) < 1e-10 * abs(vals[3])
+
+def test_condense_nonsymmetric():
+    import numpy as np
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.3))
+    fes = H1(mesh, order=4)
+    u,v = fes.TnT()
+    form = grad(u)*grad(v)*dx + CoefficientFunction((1,2))*grad(u)*v*dx + u*v*dx
+    a = BilinearForm(fes, condense=True)
+    a += form
+    a.Assemble()
+    afull = BilinearForm(fes)
+    afull += form
+    afull.Assemble()
+
+    inner = np.array([fes.CouplingType(i) == COUPLING_TYPE.LOCAL_DOF for i in range(fes.ndof)])
+    assert inner.any()
+    x, y, r, s = [a.mat.CreateVector() for i in range(4)]
+    def random(mask):
+        x.SetRandom()
+        x.FV().NumPy()[~mask] = 0
+        return x
+
+    # for the interior dofs, A y = 0 after the harmonic extension, A y = f after the inner solve
+    for trans in [False, True]:
+        A = afull.mat.T if trans else afull.mat
+        S = a.mat.T if trans else a.mat
+        ext = a.harmonic_extension_trans.T if trans else a.harmonic_extension
+        inv = a.inner_solve.T if trans else a.inner_solve
+
+        random(~inner)
+        y.data = x + ext * x
+        r.data = A * y
+        s.data = S * x
+        scale = Norm(r)
+        assert np.linalg.norm(r.FV().NumPy()[inner]) < 1e-10 * scale
+        r.data -= s
+        assert np.linalg.norm(r.FV().NumPy()[~inner]) < 1e-10 * scale
+
+        random(inner)
+        y.data = inv * x
+        r.data = A * y
+        assert np.linalg.norm(y.FV().NumPy()[~inner]) == 0
+        r.data -= x
+        assert np.linalg.norm(r.FV().NumPy()[inner]) < 1e-10 * Norm(x)
+
+    for op in [a.harmonic_extension, a.harmonic_extension_trans, a.inner_solve]:
+        x.SetRandom()
+        y.SetRandom()
+        assert abs(InnerProduct(op*x, y) - InnerProduct(x, op.T*y)) < 1e-10 * Norm(op*x) * Norm(y)
+
+def test_block_coloring():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.05))
+    vals = []
+    for coloring in ["greedy", "blocks"]:
+        fes = H1(mesh, order=2, coloring=coloring)
+        u,v = fes.TnT()
+        a = BilinearForm(fes)
+        a += grad(u)*grad(v)*dx + u*v*ds
+        a.Assemble()
+        gfu = GridFunction(fes)
+        gfu.Set(x*y)
+        vals.append(InnerProduct(a.mat*gfu.vec, gfu.vec))
+    assert abs(vals[0]-vals[1]) < 1e-10 * abs(vals[0])
+
 if __name__ == "__main__":
     test_2DGetFE(quads=False)
     test_2DGetFE(quads=True)
     test_3DGetFE()
     test_SurfaceGetFE(quads=False)
     test_SurfaceGetFE(quads=True)
+    test_reorder()
+    test_cache_element_dofs()
+    test_cache_element_dofs_condense()
+    test_condense_nonsymmetric()
+    test_block_coloring()
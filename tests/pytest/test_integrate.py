@@ -25,3 +25,56 @@ def test_integrate_xy():
     intC = Integrate(1j*x*y,mesh)
     assert abs(intR-1./4) < 1e-14
     assert abs(intC- 1j*1./4) < 1e-14
+
+def test_shape_cache():
+    from ngsolve.fem import SetShapeCache, ClearShapeCache, ShapeCacheInfo
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    results = []
+    for enable in [False, True]:
+        SetShapeCache(enable)
+        for space in [H1(mesh, order=4), L2(mesh, order=3)]:
+            gf = GridFunction(space)
+            gf.Set(sin(3*x)*y)
+            u,v = space.TnT()
+            f = LinearForm(space)
+            f += x*v*dx + y*grad(v)[0]*dx
+            f.Assemble()
+            # mapped gradients: element matrices, and operator application
+            a = BilinearForm(space)
+            a += (1+x)*grad(u)*grad(v)*dx
+            a.Assemble()
+            aapply = BilinearForm(space, nonassemble=True)
+            aapply += (1+x)*grad(u)*grad(v)*dx
+            hv = gf.vec.CreateVector()
+            hv.data = a.mat * gf.vec
+            hv2 = gf.vec.CreateVector()
+            aapply.Apply(gf.vec, hv2)
+            results.append((Integrate(gf*gf, mesh), Integrate(grad(gf)*grad(gf), mesh),
+                            Norm(f.vec), Norm(hv), Norm(hv2), InnerProduct(hv, hv2)))
+    assert ShapeCacheInfo()["tables"] > 0
+    ClearShapeCache()
+    assert ShapeCacheInfo()["tables"] == 0
+    n = len(results)//2
+    for r1, r2 in zip(results[:n], results[n:]):
+        for a, b in zip(r1, r2):
+            assert abs(a-b) < 1e-12 * (1+abs(a))
+
+def test_integrate_many():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.05))
+    cfs = [x*y, sin(x)*exp(y), CoefficientFunction((x, y*y)), 1j*sin(x)*exp(y)]
+    single = [Integrate(cf, mesh, order=6) for cf in cfs]
+    results = []
+    for threads in [1, 2, 4]:
+        SetNumThreads(threads)
+        with TaskManager():
+            results.append(IntegrateMany(cfs, mesh, order=6))
+    def values(res):
+        return [v for r in res for v in (r if hasattr(r, "__len__") else [r])]
+    for res in results:
+        for a, b in zip(values(res), values(single)):
+            assert abs(a-b) < 1e-13
+    # bitwise reproducible for any number of threads
+    for res in results[1:]:
+        assert values(res) == values(results[0])
+    bnd = IntegrateMany([x, CoefficientFunction(1)], mesh, BND, definedon=mesh.Boundaries("left|right"))
+    assert abs(bnd[0]-1) < 1e-13 and abs(bnd[1]-2) < 1e-13
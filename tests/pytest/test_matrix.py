@@ -99,7 +99,51 @@ def test_sparsematrix_access():
     a.Assemble()
     assert abs(a.mat[1,1][0,0] - (reference_values[3])) < 1e-8
 
+def test_shared_graph():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=2)
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += grad(u)*grad(v)*dx
+    a.Assemble()
+    # second form on the same space reuses the graph of a.mat
+    m = BilinearForm(fes)
+    m += u*v*dx
+    m.Assemble()
+    assert m.mat.nze == a.mat.nze
+    gfu = GridFunction(fes)
+    gfu.Set(1)
+    w = gfu.vec.CreateVector()
+    w.data = m.mat * gfu.vec
+    assert abs(InnerProduct(w, gfu.vec) - 1) < 1e-12
+    w.data = a.mat * gfu.vec
+    assert Norm(w) < 1e-12
+
+def test_profile_trace(tmpdir):
+    import json
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=2)
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += grad(u)*grad(v)*dx
+    EnableProfileTrace()
+    a.Assemble()
+    gfu = GridFunction(fes)
+    w = gfu.vec.CreateVector()
+    w.data = a.mat * gfu.vec
+    DisableProfileTrace()
+    report = ProfileReport()
+    timers = { t["name"] : t for t in report["timers"] }
+    assert timers["SparseMatrix::MultAdd"]["bytes"] > 0
+    assert "Matrix assembling" in [ node["name"] for node in report["tree"] ]
+    filename = str(tmpdir.join("trace.json"))
+    WriteProfile(filename, format="chrome")
+    with open(filename) as f:
+        events = json.load(f)["traceEvents"]
+    assert any(ev["name"] == "Matrix assembling" and ev["ph"] == "X" for ev in events)
+
 if __name__ == "__main__":
     test_matrix()
     test_matrix_numpy()
     test_sparsematrix_access()
+    test_shared_graph()
@@ -1,5 +1,6 @@
 from ngsolve import *
 from netgen.csg import *
+from pytest import approx
 ngsglobals.msg_level = 0
 
 def test_multiple_meshes_refine():
@@ -18,3 +19,34 @@ def test_call_operator_with_vectorization():
     mesh = Mesh(unit_cube.GenerateMesh(maxh=1))
     p = mesh(0.5,0.5,0.5)
     p2 = mesh([0.5, 0.1],0.5,0.5)
+
+def test_geometry_table():
+    def Matrix(mesh):
+        fes = H1(mesh, order=2)
+        u,v = fes.TnT()
+        a = BilinearForm(fes)
+        a += (grad(u)*grad(v) + (1+x*y)*u*v)*dx + u*v*ds
+        a.Assemble()
+        return a.mat
+
+    ball = CSGeometry()
+    ball.Add(Sphere(Pnt(0,0,0), 1))
+    # straight elements only, and curved elements using the fallback
+    for geo, curve in [(unit_cube, 0), (ball, 3)]:
+        mesh = Mesh(geo.GenerateMesh(maxh=0.4))
+        if curve:
+            mesh.Curve(curve)
+        ref = Matrix(mesh)
+        volume = Integrate(1, mesh)
+        surface = Integrate(1, mesh, BND)
+        mesh.EnableGeometryTable()
+        mat = Matrix(mesh)
+        vec = ref.CreateVector()
+        vec.SetRandom()
+        refvec = ref.CreateVector()
+        refvec.data = ref*vec
+        diff = ref.CreateVector()
+        diff.data = mat*vec - refvec
+        assert Norm(diff) < 1e-10 * Norm(refvec)
+        assert Integrate(1, mesh) == approx(volume, rel=1e-12)
+        assert Integrate(1, mesh, BND) == approx(surface, rel=1e-12)
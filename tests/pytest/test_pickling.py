@@ -240,6 +240,20 @@ def test_pickle_CoefficientFunctions():
     np.allclose(lcfs[29](mp), compiled_vals)
     np.allclose(lcfs[30](mp), compiled_vals)
 
+def test_pickle_compiled_library():
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.3))
+    cf = sin(x)*exp(y) + CoefficientFunction((x,y)).Norm()
+    compiled = cf.Compile(realcompile=True, wait=True, keep_library=True)
+    data = pickle.dumps(compiled)
+    # the shared library is stored in the pickle
+    assert len(data) > len(pickle.dumps(cf.Compile(realcompile=True, wait=True)))
+    compiled2 = pickle.loads(data)
+    mp = mesh(0.3,0.4)
+    assert abs(compiled2(mp) - cf(mp)) < 1e-12
+    assert Integrate((compiled2-cf)*(compiled2-cf), mesh) < 1e-20
+    # and passed on when pickled again
+    assert len(pickle.dumps(compiled2)) == len(data)
+
 if __name__ == "__main__":
     test_pickle_volume_fespaces()
     test_pickle_surface_fespaces()
@@ -251,3 +265,4 @@ if __name__ == "__main__":
     test_pickle_CoefficientFunctions()
     test_pickle_multidim()
     test_pickle_secondorder_mesh()
+    test_pickle_compiled_library()
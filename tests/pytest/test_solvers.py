@@ -1,6 +1,8 @@
 from netgen.geom2d import unit_square
 from ngsolve import *
 import pytest
+import ngsolve
+import os
 
 def test_arnoldi():
     SetHeapSize (10*1000*1000)
@@ -53,6 +55,130 @@ def test_newton_with_dirichlet():
     dirichlet.Set(0)
     newton = solvers.Newton(a, gfu, dirichletvalues=dirichlet.vec)
 
+def test_native_newton():
+    mesh = Mesh (unit_square.GenerateMesh(maxh=0.3))
+    V = H1(mesh, order=3, dirichlet=[1,2,3,4])
+    u,v = V.TnT()
+    a = BilinearForm(V)
+    a += (grad(u) * grad(v) + 3*u**3*v- 1 * v)*dx
+    gfu = GridFunction(V)
+    solvers.Newton(a, gfu, inverse="sparsecholesky", printing=False)
+
+    for reuse in [0, 3]:
+        gfu2 = GridFunction(V)
+        newton = ngsolve.comp.NewtonSolver(a, inverse="sparsecholesky")
+        its = newton.Solve(gfu2.vec, max_jacobian_reuse=reuse)
+        assert its > 0
+        stats = newton.statistics
+        assert stats["iterations"] == its
+        assert stats["linearizations"] <= its
+        gfu2.vec.data -= gfu.vec
+        assert Norm(gfu2.vec) < 1e-8
+
+    # line search on the residual norm, and on the energy of the same problem
+    aenergy = BilinearForm(V)
+    aenergy += Variation((0.5*grad(u)*grad(u) + 3/4*u**4 - u)*dx)
+    for form in [a, aenergy]:
+        gfu2 = GridFunction(V)
+        gfu2.Set(10)
+        gfu2.vec.data = Projector(V.FreeDofs(), True) * gfu2.vec
+        newton = ngsolve.comp.NewtonSolver(form, inverse="sparsecholesky")
+        its = newton.Solve(gfu2.vec, linesearch=True)
+        assert its > 0
+        gfu2.vec.data -= gfu.vec
+        assert Norm(gfu2.vec) < 1e-8
+
+
+def test_krylov_solvers():
+    from ngsolve.krylovspace import CGSolver as PyCGSolver
+    mesh = Mesh (unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=3, dirichlet=".*")
+    u,v = fes.TnT()
+    a = BilinearForm(fes)
+    a += grad(u)*grad(v)*dx
+    a.Assemble()
+    f = LinearForm(fes)
+    f += v*dx
+    f.Assemble()
+    gfu = GridFunction(fes)
+    gfu.vec.data = a.mat.Inverse(fes.FreeDofs()) * f.vec
+    pre = Projector(fes.FreeDofs(), True)
+
+    sol = gfu.vec.CreateVector()
+    for solver in [CGSolver(a.mat, pre, printrates=False, precision=1e-12, maxsteps=500),
+                   BiCGStabSolver(a.mat, pre, printrates=False, precision=1e-12, maxsteps=500),
+                   GMRESSolver(a.mat, pre, printrates=False, precision=1e-12, maxsteps=500)]:
+        # repeated solves re-use the work vectors
+        for i in range(2):
+            solver.Solve(f.vec, sol)
+            assert solver.iterations > 0
+            assert len(solver.errors) > 1
+            sol.data -= gfu.vec
+            assert Norm(sol) < 1e-8
+
+    # C++ backed, and the python iteration with a callback
+    for callback in [None, lambda it, err: None]:
+        solver = PyCGSolver(a.mat, freedofs=fes.FreeDofs(), tol=1e-12, maxsteps=500, callback=callback)
+        assert (solver._solver is None) == (callback is not None)
+        solver.Solve(f.vec, sol)
+        assert solver.iterations > 0
+        sol.data -= gfu.vec
+        assert Norm(sol) < 1e-8
+
+
+def test_solveserver(tmpdir):
+    import threading
+    import numpy as np
+    from ngsolve.solveserver import SolveClient
+    mesh = Mesh(unit_square.GenerateMesh(maxh=0.2))
+    fes = H1(mesh, order=3, dirichlet="left|bottom")
+    u,v = fes.TnT()
+    k = Parameter(1)
+    a = BilinearForm(fes, symmetric=True)
+    a += k*grad(u)*grad(v)*dx
+    f = LinearForm(fes)
+    f += v*dx
+    f.Assemble()
+
+    server = ngsolve.comp.SolveServer()
+    server.AddSystem("laplace", a, inverse="sparsecholesky")
+    server.AddParameter("k", k)
+    path = str(tmpdir.join("solveserver"))
+    thread = threading.Thread(target=server.Serve, args=(path,))
+    thread.start()
+    # the socket file exists before the server listens, wait for a connection
+    import time
+    for i in range(1000):
+        try:
+            client = SolveClient(path)
+            break
+        except OSError:
+            time.sleep(0.01)
+
+    with client:
+        assert client.Systems() == { "laplace" : fes.ndof }
+        rhs = np.array([f.vec.FV().NumPy(), 2*f.vec.FV().NumPy()])
+        sol = client.Solve("laplace", rhs)
+        client.SetParameter("k", 2)
+        sol2 = client.Solve("laplace", rhs[0])
+        # invalid requests close their connection only
+        with SolveClient(path) as other:
+            with pytest.raises(Exception, match="expected vectors of size"):
+                other.Solve("laplace", np.zeros(5))
+        assert client.Systems() == { "laplace" : fes.ndof }
+        client.Shutdown()
+    thread.join()
+
+    k.Set(1)
+    a.Assemble()
+    gfu = GridFunction(fes)
+    gfu.vec.data = a.mat.Inverse(fes.FreeDofs()) * f.vec
+    ref = gfu.vec.FV().NumPy()
+    assert np.linalg.norm(sol[0]-ref) < 1e-10 * np.linalg.norm(ref)
+    assert np.linalg.norm(sol[1]-2*ref) < 1e-10 * np.linalg.norm(ref)
+    assert np.linalg.norm(sol2-0.5*ref) < 1e-10 * np.linalg.norm(ref)
+    assert server.Statistics("laplace")["factorizations"] == 2
+
 
 if __name__ == "__main__":
     test_arnoldi()
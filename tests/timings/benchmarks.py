@@ -0,0 +1,206 @@
+"""
+Benchmarks of the performance critical parts of NGSolve, on fixed
+meshes and problem sizes:
+
+  assembling, sparse matrix-vector product, sparse Cholesky factor and
+  solve, block Jacobi smoothing, multigrid preconditioner, compiled
+  coefficient functions, voxel coefficients and VTK output
+
+Every benchmark runs with all requested thread counts. Results are
+written as JSON, two result files are compared by compare_benchmarks.py.
+"""
+
+from netgen.csg import unit_cube
+from netgen.geom2d import unit_square
+import socket
+import multiprocessing
+import tempfile
+import time
+import json
+import os
+from ngsolve import *
+ngsglobals.msg_level=0
+
+import argparse
+parser = argparse.ArgumentParser(description='Benchmark NGSolve')
+parser.add_argument('-o', '--output', default='benchmarks.json', help='output file')
+parser.add_argument('-t', '--threads', type=int, nargs='+', help='thread counts, default 1 and all cpus')
+parser.add_argument('-q', '--quick', action="store_true", help='smaller problems, for testing the suite')
+parser.add_argument('-f', '--filter', default='', help='only run benchmarks containing this string')
+args = parser.parse_args()
+
+ncpus = multiprocessing.cpu_count()
+threads = args.threads if args.threads else sorted(set([1, ncpus]))
+
+maxh2, maxh3 = (0.1, 0.3) if args.quick else (0.02, 0.08)
+mesh2 = Mesh(unit_square.GenerateMesh(maxh=maxh2))
+mesh3 = Mesh(unit_cube.GenerateMesh(maxh=maxh3))
+meshes = [mesh2, mesh3]
+
+fes_types = [H1, L2, HDiv, HCurl]
+fes_names = ["H1", "L2", "HDiv", "HCurl"]
+orders = [1,4]
+
+
+def measure(func, maxtime=0.5):
+    """ minimal time of func, repeated for at least maxtime seconds """
+    func()
+    best = 1e99
+    start = time.time()
+    while True:
+        t0 = time.time()
+        func()
+        best = min(best, time.time()-t0)
+        if time.time()-start > maxtime:
+            return best
+
+def laplace(fes, fes_name="H1"):
+    u,v = fes.TnT()
+    a = BilinearForm(fes, symmetric=True)
+    if fes_name in ["HDiv", "L2"]:
+        a += u*v*dx
+    elif fes_name == "HCurl":
+        a += curl(u)*curl(v)*dx + u*v*dx
+    else:
+        a += grad(u)*grad(v)*dx + u*v*dx
+    return a
+
+
+# every benchmark yields tuples (name, params, unit, value)
+
+def bench_assemble():
+    for mesh in meshes:
+        for order in orders:
+            for fes_type, fes_name in zip(fes_types, fes_names):
+                fes = fes_type(mesh, order=order)
+                a = laplace(fes, fes_name)
+                params = { "dim" : mesh.dim, "fespace" : fes_name, "order" : order, "ndof" : fes.ndof }
+                for name, t in a.__timing__():
+                    yield ("BilinearForm::" + name, params, "ns", t)
+
+def bench_sparsecholesky():
+    for mesh in meshes:
+        order = 2 if mesh.dim == 3 else 4
+        fes = H1(mesh, order=order, dirichlet=".*")
+        a = laplace(fes)
+        a.Assemble()
+        params = { "dim" : mesh.dim, "order" : order, "ndof" : fes.ndof }
+        inv = a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky")
+        yield ("SparseCholesky::Factor", params, "s",
+               measure(lambda: a.mat.Inverse(fes.FreeDofs(), inverse="sparsecholesky")))
+        f = a.mat.CreateColVector()
+        u = a.mat.CreateColVector()
+        f[:] = 1
+        def solve():
+            u.data = inv * f
+        yield ("SparseCholesky::Solve", params, "s", measure(solve))
+
+def bench_blockjacobi():
+    for mesh in meshes:
+        fes = H1(mesh, order=3, dirichlet=".*")
+        a = laplace(fes)
+        a.Assemble()
+        freedofs = fes.FreeDofs()
+        blocks = []
+        for v in mesh.vertices:
+            vdofs = set()
+            for el in mesh[v].elements:
+                vdofs |= set(d for d in fes.GetDofNrs(el) if freedofs[d])
+            blocks.append(vdofs)
+        params = { "dim" : mesh.dim, "order" : 3, "ndof" : fes.ndof }
+        smoother = a.mat.CreateBlockSmoother(blocks)
+        x = a.mat.CreateColVector()
+        b = a.mat.CreateColVector()
+        b[:] = 1
+        x[:] = 0
+        yield ("BlockJacobi::Smooth", params, "s", measure(lambda: smoother.Smooth(x, b)))
+
+def bench_multigrid():
+    for geo, maxh in [(unit_square, 2*maxh2), (unit_cube, 2*maxh3)]:
+        mesh = Mesh(geo.GenerateMesh(maxh=maxh))
+        fes = H1(mesh, order=1, dirichlet=".*")
+        a = laplace(fes)
+        pre = Preconditioner(a, "multigrid")
+        a.Assemble()
+        for l in range(2):
+            mesh.Refine()
+            fes.Update()
+            a.Assemble()
+        params = { "dim" : mesh.dim, "levels" : 3, "ndof" : fes.ndof }
+        for name, t in pre.__timing__():
+            yield ("MultigridPreconditioner::" + name, params, "ns", t)
+
+def bench_compiledcf():
+    for mesh in meshes:
+        cf = sin(3*x)*exp(y) + sqrt(1+x*x+y*y+z*z) * CoefficientFunction((x,y,z)) * CoefficientFunction((1,2,3))
+        for realcompile in [False, True]:
+            cfc = cf.Compile(realcompile=realcompile, wait=True)
+            params = { "dim" : mesh.dim, "realcompile" : realcompile, "order" : 10 }
+            yield ("CompiledCoefficientFunction::Evaluate", params, "s",
+                   measure(lambda: Integrate(cfc, mesh, order=10)))
+
+def bench_voxel():
+    import numpy as np
+    n = 64 if args.quick else 256
+    vals = np.random.rand(n,n,n)
+    points = np.random.rand(10000 if args.quick else 100000, 3)
+    mips = mesh3(points[:,0], points[:,1], points[:,2])
+    for dtype, scale in [("float64", 1), ("float32", 1), ("uint8", 1/255), ("uint16", 1/65535)]:
+        stored = vals if dtype == "float64" else (vals/scale).astype(dtype)
+        vox = VoxelCoefficient((0,0,0), (1,1,1), stored, linear=True, scale=scale)
+        params = { "n" : n, "dtype" : dtype }
+        # SIMD evaluation on integration rules
+        yield ("VoxelCoefficient::Integrate", params, "s",
+               measure(lambda: Integrate(vox, mesh3, order=6)))
+        # one point at a time
+        yield ("VoxelCoefficient::EvaluatePoints", dict(params, npoints=len(points)), "s",
+               measure(lambda: vox(mips)))
+
+def bench_vtk():
+    for mesh in meshes:
+        fes = H1(mesh, order=2)
+        gfu = GridFunction(fes)
+        gfu.Set(x*y)
+        with tempfile.TemporaryDirectory() as tmpdir:
+            vtk = VTKOutput(mesh, coefs=[gfu, grad(gfu)], names=["u", "gradu"],
+                            filename=os.path.join(tmpdir, "bench"), subdivision=2)
+            params = { "dim" : mesh.dim, "subdivision" : 2 }
+            yield ("VTKOutput::Do", params, "s", measure(lambda: vtk.Do()))
+
+benchmarks = [bench_assemble, bench_sparsecholesky, bench_blockjacobi,
+              bench_multigrid, bench_compiledcf, bench_voxel, bench_vtk]
+
+
+results = {}
+if "CI_BUILD_REF" in os.environ:
+    results['commit'] = os.environ["CI_BUILD_REF"]
+build = {}
+build['compiler'] = "@CMAKE_CXX_COMPILER_ID@-@CMAKE_CXX_COMPILER_VERSION@"
+build['cxx_flags'] = "@CMAKE_CXX_FLAGS@ @NGSOLVE_COMPILE_OPTIONS@".strip()
+build['hostname'] = socket.gethostname()
+build['ncpus'] = ncpus
+results['build'] = build
+results['threads'] = threads
+results['quick'] = args.quick
+
+# name and params identify a benchmark, values are per thread count
+entries = {}
+for nthreads in threads:
+    SetNumThreads(nthreads)
+    with TaskManager():
+        for bench in benchmarks:
+            if args.filter not in bench.__name__:
+                continue
+            for name, params, unit, value in bench():
+                key = json.dumps([name, params], sort_keys=True)
+                entry = entries.setdefault(key, { "name" : name, "params" : params,
+                                                  "unit" : unit, "times" : {} })
+                entry["times"][str(nthreads)] = value
+                print(name, params, nthreads, "threads:", value, unit)
+
+for entry in entries.values():
+    t1 = entry["times"].get(str(threads[0]))
+    entry["speedup"] = { n : t1/t for n, t in entry["times"].items() if t1 and t > 0 }
+results['benchmarks'] = list(entries.values())
+
+json.dump(results, open(args.output,'w'), indent=1)
@@ -0,0 +1,59 @@
+"""
+Compares two result files of benchmarks.py, and flags regressions.
+
+Returns with exit code 1 if any benchmark became slower by more than
+the tolerance, with the same number of threads.
+"""
+
+import json
+import sys
+import argparse
+
+parser = argparse.ArgumentParser(description='Compare NGSolve benchmarks')
+parser.add_argument('reference', help='reference results')
+parser.add_argument('results', help='new results')
+parser.add_argument('-t', '--tolerance', type=float, default=0.1, help='allowed relative slowdown')
+parser.add_argument('-a', '--all', action="store_true", help='print all benchmarks, not only regressions')
+args = parser.parse_args()
+
+def load(filename):
+    results = json.load(open(filename,'r'))
+    return results, { json.dumps([b["name"], b["params"]], sort_keys=True) : b
+                      for b in results["benchmarks"] }
+
+ref_results, ref = load(args.reference)
+new_results, new = load(args.results)
+
+if ref_results["build"]["hostname"] != new_results["build"]["hostname"]:
+    print("WARNING: results from different hosts,", ref_results["build"]["hostname"],
+          "and", new_results["build"]["hostname"])
+
+regressions = []
+improvements = 0
+for key, b in new.items():
+    if key not in ref:
+        print("WARNING: no reference for", b["name"], b["params"])
+        continue
+    for nthreads, t in b["times"].items():
+        t_ref = ref[key]["times"].get(nthreads)
+        if not t_ref:
+            continue
+        ratio = t / t_ref
+        line = "{:45} {:50} {:>4} threads: {:10.4g} -> {:10.4g} {:3} ({:+.1f}%)".format(
+            b["name"], json.dumps(b["params"], sort_keys=True), nthreads,
+            t_ref, t, b["unit"], 100*(ratio-1))
+        if ratio > 1+args.tolerance:
+            regressions.append(line)
+        elif ratio < 1-args.tolerance:
+            improvements += 1
+        if args.all:
+            print(line)
+
+for key, b in ref.items():
+    if key not in new:
+        print("WARNING: benchmark", b["name"], b["params"], "missing in", args.results)
+
+print(len(regressions), "regressions,", improvements, "improvements, tolerance", args.tolerance)
+for line in regressions:
+    print("REGRESSION:", line)
+sys.exit(1 if regressions else 0)
@@ -81,6 +81,38 @@ for mesh in meshes:
                     timings["FESpace"].append(tim)
 
 
+# test locality of dof numberings
+if args.sequential:
+    import time
+    timings.setdefault("Renumbering", [])
+    for mesh in meshes:
+        for order in orders:
+            for method in ["nodes", "rcm", "hilbert", "morton"]:
+                fes = Reorder(H1(mesh, order=order), method=method)
+                u,v = fes.TnT()
+                a = BilinearForm(fes)
+                a += grad(u)*grad(v)*dx
+                start = time.time()
+                a.Assemble()
+                t_assemble = time.time()-start
+                vecx = a.mat.CreateColVector()
+                vecy = a.mat.CreateColVector()
+                vecx[:] = 1
+                start = time.time()
+                for i in range(20):
+                    vecy.data = a.mat * vecx
+                t_spmv = (time.time()-start)/20
+                tim = {}
+                tim['dimension'] = mesh.dim
+                tim['order'] = order
+                tim['method'] = method
+                tim['bandwidth'] = fes.bandwidth[1]
+                tim['profile'] = fes.profile[1]
+                tim['assemble'] = t_assemble
+                tim['spmv'] = t_spmv
+                timings["Renumbering"].append(tim)
+
+
 orders = [1,2,4,8]
 mesh2 = Mesh(unit_square.GenerateMesh(maxh=3))
 mesh3 = Mesh(unit_cube.GenerateMesh(maxh=1))